@@ -0,0 +1,549 @@
+/**
+* @file resultslib.c
+* @brief Source file for the validation and the answer of the results sent by the Sorter (on their own or in batches)
+*
+* A result on its own (nickname,model,filename,md5,algorithm,time) is answered with one of the RESULTS_SERVER_* codes.
+* A batch has a first line with RESULTS_BATCH_HEADER and its number, and then a result on each line; it is answered
+* with the same first line and then the code of each result, on the same order.
+*
+* Each server thread has its own socket on the port (SO_REUSEPORT), receives and answers the datagrams in batches
+* (recvmmsg and sendmmsg), and keeps its own counters and aggregates; the results are written to the append-only log
+* before their responses are sent.
+*
+* @date 2010/02/18 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#define _GNU_SOURCE // for the recvmmsg and sendmmsg
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include "../3rd/debug.h"
+#include "definitions.h"
+#include "aux.h"
+#include "resultslib.h"
+
+/**
+ * @brief Creates and binds a socket of the server
+ * @param port to listen
+ * @param reuse_port TRUE to share the port with the sockets of the other threads (SO_REUSEPORT)
+ * @return integer with the socket
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int create_results_socket(long port, int reuse_port){
+	int sock_fd, yes=1;
+	struct sockaddr_in ser_addr;			// to store the sockaddr_in structure
+
+	/* Creates the socket */
+	if ((sock_fd = socket(AF_INET, SOCK_DGRAM, 0)) == -1){
+		ERROR(M_SOCKET_CREATION_ERROR, "\nError while creating the application socket.\n");
+	}
+	// Each thread has its own socket on the same port (the kernel chooses one for each client)
+	if (reuse_port==TRUE && setsockopt(sock_fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(int)) == -1) {
+		ERROR(M_SETSOCKOPT_ERROR, "\nError while setting the socket options\n");
+	}
+
+	/* Initializes the sockaddr_in structure with the socket information */
+	memset(&ser_addr, 0, sizeof(ser_addr));
+	ser_addr.sin_family = AF_INET;
+	ser_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	ser_addr.sin_port = htons(port);
+
+	/* Register the socket */
+	if (bind(sock_fd, (struct sockaddr *)&ser_addr, sizeof(ser_addr)) == -1){
+		ERROR(M_BIND_SOCKET_ERROR, "\nError binding the socket.\n");
+	}
+	return sock_fd;
+}
+
+/**
+ * @brief Calculate the md5 sum of each regular file of a directory (the files sorted correctly)
+ * @param dirname with the files
+ * @return HASH_MAP_T with the md5 sum of each file, by filename
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+HASH_MAP_T* load_checksums(char* dirname){
+	HASH_MAP_T *checksums;
+	DIR *dir = NULL;
+	struct dirent *dirItem=NULL; 		// to reference a directory item
+	struct stat fileDetails;			// to reference the file details
+	char *filename, *checksum;
+	int length;
+
+	if((dir = opendir(dirname))==NULL){
+		ERROR(M_OPEN_DIR_FAILED, "\nError while open the directory %s\n", dirname);
+	}
+	checksums = hash_map_create(count_dir_items(dirname));
+	while((dirItem = readdir(dir))!=NULL){
+		filename = path_filename(dirname, dirItem->d_name);
+		// Only the regular files
+		if(lstat(filename, &fileDetails)==0 && S_ISREG(fileDetails.st_mode)){
+			// The map keeps a reference to the key, so the filename is stored after the md5 sum, on the same memory
+			length = strlen(dirItem->d_name);
+			if((checksum = calloc(MD5SUMCHARS+1+length+1, sizeof(char)))==NULL){
+				ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the md5 sum of %s\n", filename);
+			}
+			md5sum(checksum, filename);
+			memcpy(checksum+MD5SUMCHARS+1, dirItem->d_name, length);
+			hash_map_insert(checksums, checksum+MD5SUMCHARS+1, length, checksum);
+		}
+		free(filename);
+	}
+	closedir(dir);
+	return checksums;
+}
+
+/**
+ * @brief Initializes a server thread: its socket, buffers and aggregates
+ * @param worker RESULTS_WORKER_T to initialize
+ * @param server RESULTS_SERVER_T with the data shared by the threads
+ * @param index number of the thread
+ * @param port to listen
+ * @param reuse_port TRUE to share the port with the sockets of the other threads
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void create_results_worker(RESULTS_WORKER_T* worker, RESULTS_SERVER_T* server, int index, long port, int reuse_port){
+	int size = RESULTS_SERVER_BATCH_SIZE, a;
+
+	memset(worker, 0, sizeof(RESULTS_WORKER_T));
+	worker->index = index;
+	worker->server = server;
+	worker->sock_fd = create_results_socket(port, reuse_port);
+	if((worker->recent = calloc(RESULTS_RECENT_BATCHES, sizeof(RESULTS_RECENT_BATCH_T)))==NULL || (worker->requests=calloc(size, sizeof(struct mmsghdr)))==NULL || (worker->responses=calloc(size, sizeof(struct mmsghdr)))==NULL || (worker->request_iovecs=calloc(size, sizeof(struct iovec)))==NULL || (worker->response_iovecs=calloc(size, sizeof(struct iovec)))==NULL || (worker->addresses=calloc(size, sizeof(struct sockaddr_in)))==NULL || (worker->request_data=malloc(size*(RESULTS_BATCH_SIZE+1)))==NULL || (worker->response_data=malloc(size*MAXCHARS))==NULL || (worker->log_buffer=malloc(RESULTS_LOG_BUFFER_SIZE))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the buffers of the thread %d\n", index);
+	}
+	if(pthread_mutex_init(&(worker->mutex), NULL)!=0){
+		ERROR(M_PTHREAD_MUTEX_INIT_FAILED, "\nError while creating the lock of the thread %d\n", index);
+	}
+	worker->aggregates = hash_map_create(RESULTS_AGGREGATES_SIZE);
+	for(a=0; a<size; a++){
+		// Each datagram keeps a byte after it, for the terminator
+		worker->request_iovecs[a].iov_base = worker->request_data+a*(RESULTS_BATCH_SIZE+1);
+		worker->request_iovecs[a].iov_len = RESULTS_BATCH_SIZE;
+		worker->requests[a].msg_hdr.msg_name = &(worker->addresses[a]);
+		worker->requests[a].msg_hdr.msg_iov = &(worker->request_iovecs[a]);
+		worker->requests[a].msg_hdr.msg_iovlen = 1;
+		// Each response goes to the address of its datagram
+		worker->response_iovecs[a].iov_base = worker->response_data+a*MAXCHARS;
+		worker->responses[a].msg_hdr.msg_name = &(worker->addresses[a]);
+		worker->responses[a].msg_hdr.msg_iov = &(worker->response_iovecs[a]);
+		worker->responses[a].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+/**
+ * @brief Write the lines of the log of a thread (appended to the file, so the lines of the threads aren't mixed)
+ * @param worker RESULTS_WORKER_T with the lines
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void results_log_flush(RESULTS_WORKER_T* worker){
+	int written, a;
+
+	for(a=0; a<worker->log_length; a+=written){
+		if((written = write(worker->server->log_fd, worker->log_buffer+a, worker->log_length-a))<0){
+			if(errno==EINTR){
+				written = 0;
+				continue;
+			}
+			ERROR(M_FILE_OUTPUT_FAILED, "\nError while writing the log of the results\n");
+		}
+	}
+	worker->log_length = 0;
+}
+
+/**
+ * @brief Add a result to the log of a thread (written by results_log_flush)
+ * @param worker RESULTS_WORKER_T with the log
+ * @param client with the address of the client
+ * @param code RESULTS_SERVER_* code of the result
+ * @param result with the result
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void results_log(RESULTS_WORKER_T* worker, struct sockaddr_in* client, const char* code, char* result){
+	char address[INET_ADDRSTRLEN];
+	int length;
+
+	if(worker->server->log_fd<0){
+		return;
+	}
+	inet_ntop(AF_INET, &(client->sin_addr), address, sizeof(address));
+	while(1){
+		// Time of the receipt, client, code and result (the result is the last field, with its own commas)
+		length = snprintf(worker->log_buffer+worker->log_length, RESULTS_LOG_BUFFER_SIZE-worker->log_length, "%ld.%09ld,%s:%d,%s,%s\n", (long)worker->now.tv_sec, worker->now.tv_nsec, address, ntohs(client->sin_port), code, result);
+		if(worker->log_length+length<RESULTS_LOG_BUFFER_SIZE){
+			worker->log_length += length;
+			return;
+		}
+		// Without space for the line: write the others first
+		results_log_flush(worker);
+	}
+}
+
+/**
+ * @brief Add the time of a result accepted to the aggregate of its nickname, model and algorithm
+ * @param worker RESULTS_WORKER_T with the aggregates
+ * @param nickname of the client
+ * @param model of the computer of the client
+ * @param algorithm of the sort
+ * @param time (ms) of the sort
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void results_aggregate(RESULTS_WORKER_T* worker, char* nickname, char* model, char* algorithm, double time){
+	char key[MAXCHARS*2];
+	RESULTS_AGGREGATE_T *aggregate;
+	int length;
+
+	snprintf(key, sizeof(key), "%s,%s,%s", nickname, model, algorithm);
+	length = strlen(key);
+	pthread_mutex_lock(&(worker->mutex));
+	if((aggregate = hash_map_find(worker->aggregates, key, length))==NULL){
+		if((aggregate = calloc(1, sizeof(RESULTS_AGGREGATE_T)))==NULL || (aggregate->key = strdup(key))==NULL){
+			ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the aggregate of %s\n", key);
+		}
+		aggregate->minimum = aggregate->maximum = time;
+		hash_map_insert(worker->aggregates, aggregate->key, length, aggregate);
+	}
+	aggregate->count++;
+	aggregate->total += time;
+	if(time<aggregate->minimum){
+		aggregate->minimum = time;
+	}
+	if(time>aggregate->maximum){
+		aggregate->maximum = time;
+	}
+	pthread_mutex_unlock(&(worker->mutex));
+}
+
+/**
+ * @brief Validate a result, and count, log and aggregate it
+ * @param worker RESULTS_WORKER_T with the counters, the log and the aggregates (and the known files of the server)
+ * @param result with the result (nickname,model,filename,md5,algorithm,time), without the end of line
+ * @param client with the address of the client
+ * @return string with the RESULTS_SERVER_* code of the result
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+const char* validate_result(RESULTS_WORKER_T* worker, char* result, struct sockaddr_in* client){
+	char buffer[MAXCHARS];					// to store a copy of the result, split in fields
+	char *fields[RESULTS_FIELDS], *cursor, *checksum, *endptr;
+	const char *code = RESULTS_SERVER_OK;
+	double time = 0;
+	int a, length;
+
+	length = strlen(result);
+	if(length>0 && result[length-1]=='\r'){
+		result[--length] = '\0';
+	}
+	if(length>=MAXCHARS){
+		worker->counters.invalid_format++;
+		code = RESULTS_SERVER_INVALID_FORMAT;
+		goto validated;
+	}
+	memcpy(buffer, result, length+1);
+
+	// Split the fields (all of them required)
+	cursor = buffer;
+	for(a=0; a<RESULTS_FIELDS; a++){
+		fields[a] = strsep(&cursor, ",");
+		if(fields[a]==NULL || *fields[a]=='\0'){
+			break;
+		}
+	}
+	if(a<RESULTS_FIELDS || cursor!=NULL){
+		worker->counters.invalid_format++;
+		code = RESULTS_SERVER_INVALID_FORMAT;
+		goto validated;
+	}
+
+	// The md5 sum of the file (any sum, with its size, for an unknown set of files)
+	if(worker->server->checksums!=NULL){
+		if((checksum = hash_map_find(worker->server->checksums, fields[2], strlen(fields[2])))==NULL){
+			worker->counters.invalid_file++;
+			code = RESULTS_SERVER_INVALID_FILE;
+			goto validated;
+		}
+		if(strcasecmp(checksum, fields[3])!=0){
+			worker->counters.invalid_checksum++;
+			code = RESULTS_SERVER_INVALID_CHECKSUM;
+			goto validated;
+		}
+	}else{
+		for(a=0; fields[3][a]!='\0' && isxdigit((unsigned char)fields[3][a]); a++);
+		if(a!=MD5SUMCHARS || fields[3][a]!='\0'){
+			worker->counters.invalid_checksum++;
+			code = RESULTS_SERVER_INVALID_CHECKSUM;
+			goto validated;
+		}
+	}
+
+	// The time (ms), a positive number
+	if(strspn(fields[5], "0123456789.")!=strlen(fields[5]) || (time = strtod(fields[5], &endptr))<0 || endptr==fields[5] || *endptr!='\0'){
+		worker->counters.invalid_time++;
+		code = RESULTS_SERVER_INVALID_TIME;
+		goto validated;
+	}
+
+	worker->counters.accepted++;
+	results_aggregate(worker, fields[0], fields[1], fields[4], time);
+
+validated:
+	results_log(worker, client, code, result);
+	return code;
+}
+
+/**
+ * @brief Build the response to a datagram with a result or a batch of them
+ * @param worker RESULTS_WORKER_T with the responses to the last batches and the counters
+ * @param request with the datagram (with space for a terminator after it)
+ * @param length number of bytes of the datagram
+ * @param client with the address of the client
+ * @param response to store the response (MAXCHARS bytes)
+ * @return integer with the number of bytes of the response
+ *
+ * The retry of a batch (the same number from the same client) is answered with the response kept, so its results
+ * aren't counted again. Only the first RESULTS_BATCH_MAXIMUM_RECORDS results of a batch are answered.
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int answer_results(RESULTS_WORKER_T* worker, char* request, int length, struct sockaddr_in* client, char* response){
+	RESULTS_RECENT_BATCH_T *recent;
+	unsigned long long id;
+	char *line, *next, *endptr;
+	int header_length = strlen(RESULTS_BATCH_HEADER), response_length, records;
+
+	request[length] = '\0';
+	if(strncmp(request, RESULTS_BATCH_HEADER, header_length)!=0 || request[header_length]!=' '){
+		// A result on its own (without the end of line)
+		if(length>0 && request[length-1]=='\n'){
+			request[length-1] = '\0';
+		}
+		strcpy(response, validate_result(worker, request, client));
+		return strlen(response);
+	}
+
+	id = strtoull(request+header_length+1, &endptr, 10);
+	if(endptr==request+header_length+1 || *endptr!='\n'){
+		worker->counters.invalid_format++;
+		strcpy(response, RESULTS_SERVER_INVALID_FORMAT);
+		return strlen(response);
+	}
+	// A retry of a batch already answered
+	recent = &(worker->recent[(id^client->sin_addr.s_addr^client->sin_port)%RESULTS_RECENT_BATCHES]);
+	if(recent->length>0 && recent->id==id && recent->address.sin_addr.s_addr==client->sin_addr.s_addr && recent->address.sin_port==client->sin_port){
+		worker->counters.repeated++;
+		memcpy(response, recent->response, recent->length);
+		return recent->length;
+	}
+
+	response_length = sprintf(response, "%s %llu\n", RESULTS_BATCH_HEADER, id);
+	line = endptr+1;
+	for(records=0; *line!='\0' && records<RESULTS_BATCH_MAXIMUM_RECORDS; records++){
+		if((next = strchr(line, '\n'))!=NULL){
+			*next = '\0';
+		}
+		response_length += sprintf(response+response_length, "%s\n", validate_result(worker, line, client));
+		if(next==NULL){
+			break;
+		}
+		line = next+1;
+	}
+	worker->counters.batches++;
+
+	// Keep the response for the retries
+	recent->address = *client;
+	recent->id = id;
+	recent->length = response_length;
+	memcpy(recent->response, response, response_length);
+	return response_length;
+}
+
+/**
+ * @brief Wait for the datagrams of the clients, and answer the ones received
+ * @param worker RESULTS_WORKER_T of the thread, with the socket and the buffers
+ * @return integer with the number of datagrams answered
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int serve_results_batch(RESULTS_WORKER_T* worker){
+	int count, result, a;
+
+	for(a=0; a<RESULTS_SERVER_BATCH_SIZE; a++){
+		worker->requests[a].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+	}
+	// Wait for the first datagram, and take the others already waiting without blocking
+	if((count = recvmmsg(worker->sock_fd, worker->requests, RESULTS_SERVER_BATCH_SIZE, MSG_WAITFORONE, NULL))==-1){
+		if(errno==EINTR){
+			return 0;
+		}
+		ERROR(M_RECVFROM_ERROR, "\nError while receiving the results\n");
+	}
+	clock_gettime(CLOCK_REALTIME, &(worker->now));
+	for(a=0; a<count; a++){
+		worker->counters.datagrams++;
+		worker->response_iovecs[a].iov_len = answer_results(worker, worker->request_data+a*(RESULTS_BATCH_SIZE+1), worker->requests[a].msg_len, &(worker->addresses[a]), worker->response_data+a*MAXCHARS);
+		worker->responses[a].msg_hdr.msg_namelen = worker->requests[a].msg_hdr.msg_namelen;
+	}
+	// The results are on the log before their responses
+	results_log_flush(worker);
+
+	// The kernel can send only a part of the batch on each call
+	for(a=0; a<count; a+=result){
+		if((result = sendmmsg(worker->sock_fd, worker->responses+a, count-a, 0))==-1){
+			ERROR(M_SENDTO_ERROR, "\nError while sending the responses to the clients\n");
+		}
+	}
+	return count;
+}
+
+/**
+ * @brief Thread of the server, answering the results of its socket
+ * @param arg RESULTS_WORKER_T with the data of the thread
+ * @return NULL (never returns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void *results_serve(void *arg){
+	RESULTS_WORKER_T *worker = (RESULTS_WORKER_T*) arg;
+
+	while(1){
+		serve_results_batch(worker);
+	}
+	return NULL;
+}
+
+/**
+ * @brief Add the counters of a thread to others (the counters can still be updated by their thread, so the result is approximate)
+ * @param total RESULTS_COUNTERS_T to update
+ * @param counters RESULTS_COUNTERS_T with the counters to add
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void results_counters_add(RESULTS_COUNTERS_T* total, RESULTS_COUNTERS_T* counters){
+	total->datagrams += __atomic_load_n(&(counters->datagrams), __ATOMIC_RELAXED);
+	total->batches += __atomic_load_n(&(counters->batches), __ATOMIC_RELAXED);
+	total->repeated += __atomic_load_n(&(counters->repeated), __ATOMIC_RELAXED);
+	total->accepted += __atomic_load_n(&(counters->accepted), __ATOMIC_RELAXED);
+	total->invalid_format += __atomic_load_n(&(counters->invalid_format), __ATOMIC_RELAXED);
+	total->invalid_file += __atomic_load_n(&(counters->invalid_file), __ATOMIC_RELAXED);
+	total->invalid_checksum += __atomic_load_n(&(counters->invalid_checksum), __ATOMIC_RELAXED);
+	total->invalid_time += __atomic_load_n(&(counters->invalid_time), __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Get the number of results of the counters (accepted or refused)
+ * @param counters RESULTS_COUNTERS_T with the counters
+ * @return long long with the number of results
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static long long results_count(RESULTS_COUNTERS_T* counters){
+	return counters->accepted+counters->invalid_format+counters->invalid_file+counters->invalid_checksum+counters->invalid_time;
+}
+
+/**
+ * @brief Compare the keys of two aggregates (to print them in order with qsort)
+ * @param a reference to the first RESULTS_AGGREGATE_T pointer
+ * @param b reference to the second RESULTS_AGGREGATE_T pointer
+ * @return integer with the strcmp of the keys
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int compare_aggregate_keys(const void* a, const void* b){
+	return strcmp((*(RESULTS_AGGREGATE_T* const*) a)->key, (*(RESULTS_AGGREGATE_T* const*) b)->key);
+}
+
+/**
+ * @brief Print the counters of each thread, the throughput and the aggregates of the results accepted
+ * @param server RESULTS_SERVER_T with the threads (and the counters of the last print, updated)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void print_results_server(RESULTS_SERVER_T* server){
+	RESULTS_COUNTERS_T counters, total;
+	RESULTS_AGGREGATE_T *aggregate, *merged, **sorted;
+	HASH_MAP_T *aggregates;
+	struct timespec now;
+	double elapsed, interval;
+	void *value;
+	int a, position, length;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	elapsed = (now.tv_sec-server->started.tv_sec)+(now.tv_nsec-server->started.tv_nsec)/1e9;
+	interval = (now.tv_sec-server->printed.tv_sec)+(now.tv_nsec-server->printed.tv_nsec)/1e9;
+
+	memset(&total, 0, sizeof(total));
+	printf("\n%-8s %14s %12s %12s %14s %14s\n", "thread", "datagrams", "batches", "retries", "accepted", "refused");
+	for(a=0; a<server->threads; a++){
+		memset(&counters, 0, sizeof(counters));
+		results_counters_add(&counters, &(server->workers[a].counters));
+		results_counters_add(&total, &counters);
+		printf("%-8d %14lld %12lld %12lld %14lld %14lld\n", server->workers[a].index, counters.datagrams, counters.batches, counters.repeated, counters.accepted, results_count(&counters)-counters.accepted);
+	}
+	printf("%-8s %14lld %12lld %12lld %14lld %14lld\n", "total", total.datagrams, total.batches, total.repeated, total.accepted, results_count(&total)-total.accepted);
+	printf("Refused: %lld with an invalid format, %lld with an invalid file, %lld with an invalid checksum, %lld with an invalid time\n", total.invalid_format, total.invalid_file, total.invalid_checksum, total.invalid_time);
+	printf("Throughput: %.0f results/s and %.0f datagrams/s on the last %.1f s, %.0f results/s since the start\n", (interval>0)?(results_count(&total)-results_count(&(server->last)))/interval:0, (interval>0)?(total.datagrams-server->last.datagrams)/interval:0, interval, (elapsed>0)?results_count(&total)/elapsed:0);
+	server->last = total;
+	server->printed = now;
+
+	// The aggregates of all the threads (the merged ones share the key of the aggregate of a thread, never freed)
+	aggregates = hash_map_create(RESULTS_AGGREGATES_SIZE);
+	for(a=0; a<server->threads; a++){
+		pthread_mutex_lock(&(server->workers[a].mutex));
+		position = 0;
+		while(hash_map_next(server->workers[a].aggregates, &position, NULL, &length, &value)==TRUE){
+			aggregate = (RESULTS_AGGREGATE_T*) value;
+			if((merged = hash_map_find(aggregates, aggregate->key, length))==NULL){
+				if((merged = malloc(sizeof(RESULTS_AGGREGATE_T)))==NULL){
+					ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the aggregate of %s\n", aggregate->key);
+				}
+				*merged = *aggregate;
+				hash_map_insert(aggregates, merged->key, length, merged);
+				continue;
+			}
+			merged->count += aggregate->count;
+			merged->total += aggregate->total;
+			if(aggregate->minimum<merged->minimum){
+				merged->minimum = aggregate->minimum;
+			}
+			if(aggregate->maximum>merged->maximum){
+				merged->maximum = aggregate->maximum;
+			}
+		}
+		pthread_mutex_unlock(&(server->workers[a].mutex));
+	}
+	if(hash_map_count(aggregates)>0){
+		if((sorted = malloc(hash_map_count(aggregates)*sizeof(RESULTS_AGGREGATE_T*)))==NULL){
+			ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the order of the aggregates\n");
+		}
+		position = a = 0;
+		while(hash_map_next(aggregates, &position, NULL, NULL, &value)==TRUE){
+			sorted[a++] = (RESULTS_AGGREGATE_T*) value;
+		}
+		qsort(sorted, a, sizeof(RESULTS_AGGREGATE_T*), compare_aggregate_keys);
+		printf("\n%-60s %10s %12s %12s %12s\n", "nickname,model,algorithm", "results", "minimum ms", "average ms", "maximum ms");
+		for(a=0; a<hash_map_count(aggregates); a++){
+			merged = sorted[a];
+			printf("%-60s %10lld %12.3f %12.3f %12.3f\n", merged->key, merged->count, merged->minimum, merged->total/merged->count, merged->maximum);
+			free(merged);
+		}
+		free(sorted);
+	}
+	hash_map_free(aggregates);
+	fflush(stdout);
+}
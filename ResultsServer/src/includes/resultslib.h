@@ -0,0 +1,101 @@
+/**
+* @file resultslib.h
+* @brief Header file for the validation and the answer of the results sent by the Sorter (on their own or in batches)
+* @date 2010/02/18 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef RESULTSLIB_H_
+#define RESULTSLIB_H_
+
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "hashlib.h"
+
+/**
+ * @brief Type declaration to a structure to store the response to a batch, to answer its retries without counting its results again
+ */
+typedef struct results_recent_batch {
+	struct sockaddr_in address;					/**< @brief address of the client of the batch */
+	unsigned long long id;						/**< @brief number of the batch (given by the client) */
+	int length;									/**< @brief number of bytes of the response (0 for none) */
+	char response[MAXCHARS];					/**< @brief the response */
+} RESULTS_RECENT_BATCH_T;
+
+/**
+ * @brief Type declaration to a structure to store the times of the results accepted of a nickname, model and algorithm
+ */
+typedef struct results_aggregate {
+	char *key;									/**< @brief "nickname,model,algorithm" of the results (the key of the aggregate on the hash map) */
+	long long count;							/**< @brief number of results */
+	double total;								/**< @brief sum of the times (ms) */
+	double minimum;								/**< @brief shortest time (ms) */
+	double maximum;								/**< @brief longest time (ms) */
+} RESULTS_AGGREGATE_T;
+
+/**
+ * @brief Type declaration to a structure to store the counters of a server thread
+ */
+typedef struct results_counters {
+	long long datagrams;						/**< @brief number of datagrams received */
+	long long batches;							/**< @brief number of batches answered */
+	long long repeated;							/**< @brief number of retries of batches answered with the kept response */
+	long long accepted;							/**< @brief number of results accepted */
+	long long invalid_format;					/**< @brief number of results refused by the format */
+	long long invalid_file;						/**< @brief number of results refused by an unknown file */
+	long long invalid_checksum;					/**< @brief number of results refused by the md5 sum */
+	long long invalid_time;						/**< @brief number of results refused by the time */
+} RESULTS_COUNTERS_T;
+
+/**
+ * @brief Type declaration to a structure to store the data shared by the server threads
+ */
+typedef struct results_server {
+	HASH_MAP_T *checksums;						/**< @brief md5 sum of each known file, by filename (NULL to accept any file; only read by the threads) */
+	int log_fd;									/**< @brief append-only log of the results (-1 for none) */
+	struct results_worker *workers;				/**< @brief the server threads */
+	int threads;								/**< @brief number of server threads */
+	struct timespec started;					/**< @brief time the server started (CLOCK_MONOTONIC) */
+	struct timespec printed;					/**< @brief time of the last print of the counters (CLOCK_MONOTONIC) */
+	RESULTS_COUNTERS_T last;					/**< @brief counters of all the threads on the last print */
+} RESULTS_SERVER_T;
+
+/**
+ * @brief Type declaration to a structure to store the data of a server thread (each one with its own socket on the port)
+ *
+ * Aligned to the cache lines, so the counters of a thread don't share a line with the ones of another
+ */
+typedef struct results_worker {
+	int index;									/**< @brief number of the thread */
+	int sock_fd;								/**< @brief socket of the thread (SO_REUSEPORT with the others) */
+	RESULTS_SERVER_T *server;					/**< @brief the data shared by the threads */
+	pthread_t thread;							/**< @brief the thread */
+	RESULTS_COUNTERS_T counters;				/**< @brief counters of the thread (only changed by the thread) */
+	RESULTS_RECENT_BATCH_T *recent;				/**< @brief responses to the last batches (RESULTS_RECENT_BATCHES of them, by number and client) */
+	HASH_MAP_T *aggregates;						/**< @brief RESULTS_AGGREGATE_T of the results accepted, by "nickname,model,algorithm" */
+	pthread_mutex_t mutex;						/**< @brief lock of the aggregates (only taken by another thread to print them) */
+	struct mmsghdr *requests;					/**< @brief headers of the received datagrams */
+	struct mmsghdr *responses;					/**< @brief headers of the responses */
+	struct iovec *request_iovecs;				/**< @brief buffer of each datagram */
+	struct iovec *response_iovecs;				/**< @brief buffer of each response */
+	struct sockaddr_in *addresses;				/**< @brief address of the client of each datagram */
+	char *request_data;							/**< @brief bytes of the datagrams (RESULTS_BATCH_SIZE+1 for each one) */
+	char *response_data;						/**< @brief bytes of the responses (MAXCHARS for each one) */
+	char *log_buffer;							/**< @brief lines of the log not written yet (RESULTS_LOG_BUFFER_SIZE bytes) */
+	int log_length;								/**< @brief number of bytes of the lines of the log not written yet */
+	struct timespec now;						/**< @brief time (CLOCK_REALTIME) of the datagrams being answered */
+} __attribute__((aligned(64))) RESULTS_WORKER_T;
+
+int create_results_socket(long, int);
+HASH_MAP_T* load_checksums(char*);
+void create_results_worker(RESULTS_WORKER_T*, RESULTS_SERVER_T*, int, long, int);
+const char* validate_result(RESULTS_WORKER_T*, char*, struct sockaddr_in*);
+int answer_results(RESULTS_WORKER_T*, char*, int, struct sockaddr_in*, char*);
+int serve_results_batch(RESULTS_WORKER_T*);
+void *results_serve(void *);
+void print_results_server(RESULTS_SERVER_T*);
+
+#endif /* RESULTSLIB_H_ */
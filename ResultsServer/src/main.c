@@ -0,0 +1,159 @@
+/**
+* \mainpage
+* The ResultsServer is an application to receive and validate the results of the Sorter using UDP, keeping them on an
+* append-only log and aggregating their times by nickname, model and algorithm
+*
+*
+* @file main.c
+* @brief Main source file for the ResultsServer program
+* @date 2010-02-18 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
+
+#include "3rd/debug.h"
+
+#include "includes/definitions.h"
+#include "includes/aux.h"
+#include "includes/resultslib.h"
+#include "main.h"
+
+/**
+ * @brief The main program function
+ * @param argc integer with the number of command line options
+ * @param argv *char[] with the command line options
+ * @return integer 0 on a successfully exit, another integer value otherwise
+ *
+ * Use: ResultsServer [--threads <number of threads>] [--files <folder with the sorted files>] [--log <file>] <port to listen>
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int main(int argc, char *argv[]){
+	long port;								// to store the port number to receive the results
+	long threads=1;							// to store the number of threads, each with its own socket
+	char *files=NULL;						// to store the folder with the sorted files (NULL to accept any file)
+	char *log=NULL;							// to store the file of the log of the results (NULL for none)
+	RESULTS_SERVER_T server;				// to store the data of the server
+	char *endptr;							// to store the invalid characters from the conversion of the parameter given
+	sigset_t signals;						// to store the signals handled by the main thread
+	int signal_number, option, a;
+	struct option long_options[] = {
+		{"threads", required_argument, NULL, 't'},
+		{"files", required_argument, NULL, 'f'},
+		{"log", required_argument, NULL, 'l'},
+		{0, 0, 0, 0}
+	};
+
+	while((option = getopt_long(argc, argv, "t:f:l:", long_options, NULL))!=-1){
+		switch(option){
+			case 't':
+				threads = strtol(optarg, &endptr, 0);
+				if(endptr==optarg || *endptr!='\0' || threads<1 || threads>RESULTS_MAXIMUM_THREADS){
+					MY_DEBUG("\nINVALID_PARAMETERS\n");
+					printf("The number of threads '%s' is not valid, it must be a number between 1 and %d\n", optarg, RESULTS_MAXIMUM_THREADS);
+					exit(M_INVALID_PARAMETERS);
+				}
+				break;
+			case 'f':
+				if(dir_exists(optarg)!=TRUE){
+					MY_DEBUG("\nINVALID_PARAMETERS\n");
+					printf("The folder '%s' can't be opened\n", optarg);
+					exit(M_INVALID_PARAMETERS);
+				}
+				files = optarg;
+				break;
+			case 'l':
+				log = optarg;
+				break;
+			default:
+				MY_DEBUG("\nINVALID_PARAMETERS\n");
+				printf("Use: %s [--threads <number of threads>] [--files <folder with the sorted files>] [--log <file>] <port to listen>\n", argv[0]);
+				exit(M_INVALID_PARAMETERS);
+		}
+	}
+	if(argc-optind!=1){
+		MY_DEBUG("\nINVALID_PARAMETERS\n");
+		printf("The arguments specified are not valid.\nUse: %s [--threads <number of threads>] [--files <folder with the sorted files>] [--log <file>] <port to listen>\n", argv[0]);
+		exit(M_INVALID_PARAMETERS);
+	}
+
+	errno = 0;
+	// Convert the given parameter to a long value
+	port = strtol(argv[optind], &endptr, 0);
+	/* Verify for errors */
+	if ((errno == ERANGE && (port >= LONG_MAX || port <= LONG_MIN)) || (errno != 0 && port == 0)) {
+		MY_DEBUG("\nNUMBER_CONVERSION_ERROR\n");
+		printf("Unable to convert the parameter '%s' to a valid port number.\nUse: %s [--threads <number of threads>] [--files <folder with the sorted files>] [--log <file>] <port to listen>\n", argv[optind], argv[0]);
+		exit(M_NUMBER_CONVERSION_ERROR);
+	}
+	if (endptr == argv[optind] || *endptr != '\0') {
+		MY_DEBUG("\nNO_DIGITS_FOUND\n");
+		printf("No digits found in the parameter '%s'.\nUse: %s [--threads <number of threads>] [--files <folder with the sorted files>] [--log <file>] <port to listen>\n", argv[optind], argv[0]);
+		exit(M_NO_DIGITS_FOUND);
+	}
+	if(port<PORT_RANGE_MIN || port>PORT_RANGE_MAX){
+		MY_DEBUG("\nPORT_OUT_OF_RANGE\n");
+		printf("The port %ld is out of the allowed range port numbers. \nUse: %s [--threads <number of threads>] [--files <folder with the sorted files>] [--log <file>] <port to listen>, were <port to listen> is a number between %d and %d\n", port, argv[0], PORT_RANGE_MIN, PORT_RANGE_MAX);
+		exit(M_PORT_OUT_OF_RANGE);
+	}
+
+	// Block the signals on all the threads, the main one waits for them
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	sigaddset(&signals, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+	memset(&server, 0, sizeof(server));
+	server.log_fd = -1;
+	// The log is only appended, so each write of a thread keeps its lines together
+	if(log!=NULL && (server.log_fd = open(log, O_WRONLY|O_CREAT|O_APPEND, 0644))==-1){
+		ERROR(M_FILE_OUTPUT_FAILED, "\nError while opening the log file %s\n", log);
+	}
+	if(files!=NULL){
+		server.checksums = load_checksums(files);
+		printf("%d sorted files on %s\n", hash_map_count(server.checksums), files);
+	}
+	if((server.workers = aligned_calloc(threads, sizeof(RESULTS_WORKER_T), __alignof__(RESULTS_WORKER_T)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the data of the threads\n");
+	}
+	server.threads = threads;
+	// All the sockets are bound before the threads start, so the kernel spreads the clients by all of them
+	for(a=0; a<threads; a++){
+		create_results_worker(&(server.workers[a]), &server, a, port, (threads>1)?TRUE:FALSE);
+	}
+
+	printf("%s ready and listening at port %ld (%ld threads)\n", argv[0], port, threads);
+	fflush(stdout);
+	clock_gettime(CLOCK_MONOTONIC, &(server.started));
+	server.printed = server.started;
+	for(a=0; a<threads; a++){
+		if(pthread_create(&(server.workers[a].thread), NULL, results_serve, &(server.workers[a]))!=0){
+			ERROR(M_PTHREAD_CREATE_FAILED, "\nError while creating the thread %d\n", a);
+		}
+	}
+
+	// Print the counters and the aggregates on SIGUSR1 and on the exit (SIGINT or SIGTERM)
+	do{
+		if(sigwait(&signals, &signal_number)!=0){
+			continue;
+		}
+		print_results_server(&server);
+	}while(signal_number==SIGUSR1);
+
+	// The threads are blocked on the sockets, so they end with the process (the results answered are already on the log)
+	return 0;
+}
@@ -37,6 +37,11 @@ const char *gengetopt_args_info_help[] = {
   "  -i, --id=<filename>      Filename to the sorter executable",
   "  -e, --export=<filename>  Filename to register statistics results",
   "      --http=<port>        The TCP port to listen for HTTP connections",
+  "      --http-threads=<threads>\n                           Number of threads of the HTTP server, each with \n                             its own listening socket  (default=`1')",
+  "      --export-format=<format>\n                           Format of the exported results (csv or binary)  \n                             (default=`csv')",
+  "      --export-rotate-size=<megabytes>\n                           Size of an export file to start a new one (0 to \n                             never rotate by size)  (default=`0')",
+  "      --export-rotate-time=<seconds>\n                           Age of an export file to start a new one (0 to \n                             never rotate by time)  (default=`0')",
+  "      --export-sync=<milliseconds>\n                           Interval to flush and synchronize the export file \n                             to the disk  (default=`1000')",
     0
 };
 
@@ -68,6 +73,11 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->id_given = 0 ;
   args_info->export_given = 0 ;
   args_info->http_given = 0 ;
+  args_info->http_threads_given = 0 ;
+  args_info->export_format_given = 0 ;
+  args_info->export_rotate_size_given = 0 ;
+  args_info->export_rotate_time_given = 0 ;
+  args_info->export_sync_given = 0 ;
 }
 
 static
@@ -79,6 +89,16 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->export_arg = NULL;
   args_info->export_orig = NULL;
   args_info->http_orig = NULL;
+  args_info->http_threads_arg = 1;
+  args_info->http_threads_orig = NULL;
+  args_info->export_format_arg = gengetopt_strdup ("csv");
+  args_info->export_format_orig = NULL;
+  args_info->export_rotate_size_arg = 0;
+  args_info->export_rotate_size_orig = NULL;
+  args_info->export_rotate_time_arg = 0;
+  args_info->export_rotate_time_orig = NULL;
+  args_info->export_sync_arg = 1000;
+  args_info->export_sync_orig = NULL;
   
 }
 
@@ -92,6 +112,11 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->id_help = gengetopt_args_info_help[2] ;
   args_info->export_help = gengetopt_args_info_help[3] ;
   args_info->http_help = gengetopt_args_info_help[4] ;
+  args_info->http_threads_help = gengetopt_args_info_help[5] ;
+  args_info->export_format_help = gengetopt_args_info_help[6] ;
+  args_info->export_rotate_size_help = gengetopt_args_info_help[7] ;
+  args_info->export_rotate_time_help = gengetopt_args_info_help[8] ;
+  args_info->export_sync_help = gengetopt_args_info_help[9] ;
   
 }
 
@@ -177,6 +202,12 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->export_arg));
   free_string_field (&(args_info->export_orig));
   free_string_field (&(args_info->http_orig));
+  free_string_field (&(args_info->http_threads_orig));
+  free_string_field (&(args_info->export_format_arg));
+  free_string_field (&(args_info->export_format_orig));
+  free_string_field (&(args_info->export_rotate_size_orig));
+  free_string_field (&(args_info->export_rotate_time_orig));
+  free_string_field (&(args_info->export_sync_orig));
   
   
 
@@ -217,6 +248,16 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "export", args_info->export_orig, 0);
   if (args_info->http_given)
     write_into_file(outfile, "http", args_info->http_orig, 0);
+  if (args_info->http_threads_given)
+    write_into_file(outfile, "http-threads", args_info->http_threads_orig, 0);
+  if (args_info->export_format_given)
+    write_into_file(outfile, "export-format", args_info->export_format_orig, 0);
+  if (args_info->export_rotate_size_given)
+    write_into_file(outfile, "export-rotate-size", args_info->export_rotate_size_orig, 0);
+  if (args_info->export_rotate_time_given)
+    write_into_file(outfile, "export-rotate-time", args_info->export_rotate_time_orig, 0);
+  if (args_info->export_sync_given)
+    write_into_file(outfile, "export-sync", args_info->export_sync_orig, 0);
   
 
   i = EXIT_SUCCESS;
@@ -500,6 +541,11 @@ cmdline_parser_internal (
         { "id",	1, NULL, 'i' },
         { "export",	1, NULL, 'e' },
         { "http",	1, NULL, 0 },
+        { "http-threads",	1, NULL, 0 },
+        { "export-format",	1, NULL, 0 },
+        { "export-rotate-size",	1, NULL, 0 },
+        { "export-rotate-time",	1, NULL, 0 },
+        { "export-sync",	1, NULL, 0 },
         { 0,  0, 0, 0 }
       };
 
@@ -558,6 +604,76 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* Number of threads of the HTTP server, each with its own listening socket.  */
+          else if (strcmp (long_options[option_index].name, "http-threads") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->http_threads_arg), 
+                 &(args_info->http_threads_orig), &(args_info->http_threads_given),
+                &(local_args_info.http_threads_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "http-threads", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Format of the exported results (csv or binary).  */
+          else if (strcmp (long_options[option_index].name, "export-format") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->export_format_arg), 
+                 &(args_info->export_format_orig), &(args_info->export_format_given),
+                &(local_args_info.export_format_given), optarg, 0, "csv", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "export-format", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Size of an export file to start a new one (0 to never rotate by size).  */
+          else if (strcmp (long_options[option_index].name, "export-rotate-size") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->export_rotate_size_arg), 
+                 &(args_info->export_rotate_size_orig), &(args_info->export_rotate_size_given),
+                &(local_args_info.export_rotate_size_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "export-rotate-size", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Age of an export file to start a new one (0 to never rotate by time).  */
+          else if (strcmp (long_options[option_index].name, "export-rotate-time") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->export_rotate_time_arg), 
+                 &(args_info->export_rotate_time_orig), &(args_info->export_rotate_time_given),
+                &(local_args_info.export_rotate_time_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "export-rotate-time", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Interval to flush and synchronize the export file to the disk.  */
+          else if (strcmp (long_options[option_index].name, "export-sync") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->export_sync_arg), 
+                 &(args_info->export_sync_orig), &(args_info->export_sync_given),
+                &(local_args_info.export_sync_given), optarg, 0, "1000", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "export-sync", '-',
+                additional_error))
+              goto failure;
+          
           }
           
           break;
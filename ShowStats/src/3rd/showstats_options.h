@@ -48,12 +48,32 @@ struct gengetopt_args_info
   int http_arg;	/**< @brief The TCP port to listen for HTTP connections.  */
   char * http_orig;	/**< @brief The TCP port to listen for HTTP connections original value given at command line.  */
   const char *http_help; /**< @brief The TCP port to listen for HTTP connections help description.  */
+  int http_threads_arg;	/**< @brief Number of threads of the HTTP server, each with its own listening socket (default='1').  */
+  char * http_threads_orig;	/**< @brief Number of threads of the HTTP server, each with its own listening socket original value given at command line.  */
+  const char *http_threads_help; /**< @brief Number of threads of the HTTP server, each with its own listening socket help description.  */
+  char * export_format_arg;	/**< @brief Format of the exported results (csv or binary) (default='csv').  */
+  char * export_format_orig;	/**< @brief Format of the exported results (csv or binary) original value given at command line.  */
+  const char *export_format_help; /**< @brief Format of the exported results (csv or binary) help description.  */
+  int export_rotate_size_arg;	/**< @brief Size of an export file to start a new one (0 to never rotate by size) (default='0').  */
+  char * export_rotate_size_orig;	/**< @brief Size of an export file to start a new one (0 to never rotate by size) original value given at command line.  */
+  const char *export_rotate_size_help; /**< @brief Size of an export file to start a new one (0 to never rotate by size) help description.  */
+  int export_rotate_time_arg;	/**< @brief Age of an export file to start a new one (0 to never rotate by time) (default='0').  */
+  char * export_rotate_time_orig;	/**< @brief Age of an export file to start a new one (0 to never rotate by time) original value given at command line.  */
+  const char *export_rotate_time_help; /**< @brief Age of an export file to start a new one (0 to never rotate by time) help description.  */
+  int export_sync_arg;	/**< @brief Interval to flush and synchronize the export file to the disk (default='1000').  */
+  char * export_sync_orig;	/**< @brief Interval to flush and synchronize the export file to the disk original value given at command line.  */
+  const char *export_sync_help; /**< @brief Interval to flush and synchronize the export file to the disk help description.  */
   
   unsigned int help_given ;	/**< @brief Whether help was given.  */
   unsigned int version_given ;	/**< @brief Whether version was given.  */
   unsigned int id_given ;	/**< @brief Whether id was given.  */
   unsigned int export_given ;	/**< @brief Whether export was given.  */
   unsigned int http_given ;	/**< @brief Whether http was given.  */
+  unsigned int http_threads_given ;	/**< @brief Whether http-threads was given.  */
+  unsigned int export_format_given ;	/**< @brief Whether export-format was given.  */
+  unsigned int export_rotate_size_given ;	/**< @brief Whether export-rotate-size was given.  */
+  unsigned int export_rotate_time_given ;	/**< @brief Whether export-rotate-time was given.  */
+  unsigned int export_sync_given ;	/**< @brief Whether export-sync was given.  */
 
 } ;
 
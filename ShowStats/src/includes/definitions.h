@@ -74,9 +74,179 @@
 #define SHOW_STATS_FILE_EXPORT_EXTENSION ".csv"
 
 /**
- * The global definition for the maximum connections number for the HTTP show_stats server
+ * The global definition for the show_stats binary file export extension
  */
-#define HTTP_MAXIMUM_CONNECTIONS 10
+#define SHOW_STATS_BINARY_EXPORT_EXTENSION ".stb"
+
+/**
+ * Export on the CSV format (one formatted line for each result)
+ */
+#define EXPORT_FORMAT_CSV 0
+
+/**
+ * Export on the compact binary format (read with the tools/export_reader)
+ */
+#define EXPORT_FORMAT_BINARY 1
+
+/**
+ * Number of bytes of the write buffer of the exporter (the results are written with a single call each time it fills)
+ */
+#define EXPORT_BUFFER_SIZE (1024*1024)
+
+/**
+ * Identification of the binary export files
+ */
+#define EXPORT_BINARY_MAGIC "SSTB"
+
+/**
+ * Version of the binary export format (2 added the time uncertainty to the records, 3 has the times with 8 bytes)
+ */
+#define EXPORT_BINARY_VERSION 3
+
+/**
+ * Value written on the binary export files to detect the byte order of the machine that wrote them
+ */
+#define EXPORT_BINARY_BYTE_ORDER 0x01020304
+
+/**
+ * The global definition for the maximum number of simultaneous connections of each HTTP show_stats server thread
+ */
+#define HTTP_MAXIMUM_CONNECTIONS 1024
+
+/**
+ * Number of pending connections the kernel queues on each listening socket of the HTTP server
+ */
+#define HTTP_LISTEN_BACKLOG 512
+
+/**
+ * Time (in milliseconds) an idle HTTP connection is kept open (slow clients can't hold a connection forever)
+ */
+#define HTTP_CONNECTION_TIMEOUT 10000
+
+/**
+ * Maximum time (in milliseconds) between two checks for idle HTTP connections
+ */
+#define HTTP_TIMEOUT_CHECK_INTERVAL 1000
+
+/**
+ * Maximum number of events handled by each call to epoll_wait
+ */
+#define HTTP_EPOLL_EVENTS 256
+
+/**
+ * Maximum size of the headers of an HTTP request
+ */
+#define HTTP_MAXIMUM_REQUEST_SIZE 8192
+
+/**
+ * Maximum size of the method of an HTTP request
+ */
+#define HTTP_MAXIMUM_METHOD_SIZE 15
+
+/**
+ * Maximum size of the path (and of the query) of an HTTP request
+ */
+#define HTTP_MAXIMUM_PATH_SIZE 1023
+
+/**
+ * Maximum number of bytes waiting to be sent on a connection before the next pipelined request is answered
+ */
+#define HTTP_MAXIMUM_PENDING_RESPONSE 65536
+
+/**
+ * Size of each chunk of the rows of the page
+ */
+#define HTTP_CONTENT_CHUNK_SIZE 65536
+
+/**
+ * Maximum number of parts of the responses sent by each scatter-gather write
+ */
+#define HTTP_WRITE_SEGMENTS 64
+
+/**
+ * Number of results of the JSON API when the request doesn't give the limit
+ */
+#define HTTP_API_DEFAULT_LIMIT 1000
+
+/**
+ * Maximum number of results of each JSON API response
+ */
+#define HTTP_API_MAXIMUM_LIMIT 10000
+
+/**
+ * Maximum number of results sent as events to a streaming connection at once
+ */
+#define HTTP_STREAM_BATCH 256
+
+/**
+ * Time (ms) without events after which a streaming connection gets a comment, to keep it alive
+ */
+#define HTTP_STREAM_HEARTBEAT_INTERVAL 5000
+
+/**
+ * Compression level (1 to 9) of the gzip copy of the page
+ */
+#define HTTP_GZIP_LEVEL 6
+
+/**
+ * State of a snapshot without the compressed copy of the page
+ */
+#define WEB_GZIP_NONE 0
+
+/**
+ * State of a snapshot while a thread compresses the page
+ */
+#define WEB_GZIP_BUILDING 1
+
+/**
+ * State of a snapshot with the compressed copy of the page
+ */
+#define WEB_GZIP_READY 2
+
+/**
+ * State of a snapshot that failed to compress the page
+ */
+#define WEB_GZIP_FAILED 3
+
+/**
+ * Initial number of elements of the columns and of the lists of the stats store
+ */
+#define STORE_MINIMUM_CAPACITY 64
+
+/**
+ * Number of bounds of the histograms of the stats store (in a 1-2-5 sequence, from the first power of ten of each histogram)
+ */
+#define STORE_HISTOGRAM_BUCKETS 30
+
+/**
+ * Number of buckets of the quantile estimations of the stats store for each power of two (the relative error is below half the inverse)
+ */
+#define STORE_QUANTILE_SUBBUCKETS 8
+
+/**
+ * Power of two of the smallest value (above 0) of the quantile estimations of the stats store
+ */
+#define STORE_QUANTILE_MINIMUM_EXPONENT -20
+
+/**
+ * Power of two of the greatest value of the quantile estimations of the stats store
+ */
+#define STORE_QUANTILE_MAXIMUM_EXPONENT 30
+
+/**
+ * Initial number of slots of a hash map (must be a power of two)
+ */
+#define HASH_MAP_MINIMUM_CAPACITY 16
+
+/**
+ * Maximum fraction of the slots of a hash map in use before it grows
+ */
+#define HASH_MAP_MAXIMUM_LOAD 0.85
+
+/**
+ * Seed of the hash function of the hash maps
+ */
+#define HASH_MAP_SEED 0x9747b28cULL
 
 // mutexes
 /**
@@ -405,4 +575,9 @@
  */
 #define M_PTHREAD_CREATE_FAILED 60
 
+/**
+ * Define the exit value for the epoll and eventfd creation error
+ */
+#define M_EPOLL_CREATE_FAILED 63
+
 #endif /* DEFINITIONS_H_ */
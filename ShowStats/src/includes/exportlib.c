@@ -0,0 +1,421 @@
+/**
+* @file exportlib.c
+* @brief Source file for the buffered and rotating exporter of the statistical data
+*
+* The results are formatted directly on a large buffer, written with a single call each time it fills (or when the
+* results stop arriving), and the file is synchronized to the disk periodically. The files can be rotated by size or
+* by age, and use the CSV or a compact binary format.
+*
+* The binary files start with the magic, the version, the byte order mark, the creation time and the selected
+* algorithms; each record has a fixed part with the lengths of the texts and the numbers, followed by the texts.
+*
+* @date 2010/02/08 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+
+#include "../3rd/debug.h"
+#include "definitions.h"
+#include "aux.h"
+#include "commonlib.h"
+#include "exportlib.h"
+
+/**
+ * @brief Get the current time of the monotonic clock
+ * @return long long with the time in milliseconds
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static long long exporter_time_ms(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec*1000+now.tv_nsec/1000000;
+}
+
+/**
+ * @brief Write all the bytes to a file descriptor (retrying the partial writes)
+ * @param fd descriptor of the file
+ * @param data bytes to write
+ * @param length number of bytes
+ * @return integer 0 on success, -1 on error (with the errno)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int exporter_write_all(int fd, const char* data, int length){
+	ssize_t written;
+
+	while(length>0){
+		if((written=write(fd, data, length))==-1){
+			if(errno==EINTR){
+				continue;
+			}
+			return -1;
+		}
+		data += written;
+		length -= written;
+	}
+	return 0;
+}
+
+/**
+ * @brief Append the header of a new file to the buffer of the exporter
+ * @param exporter EXPORTER_T with the buffer
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void exporter_append_header(EXPORTER_T* exporter){
+	char* data = exporter->buffer+exporter->length;
+	uint32_t value;
+	int64_t created = time(NULL);
+	int length = strlen(exporter->algorithms);
+
+	if(exporter->format==EXPORT_FORMAT_BINARY){
+		memcpy(data, EXPORT_BINARY_MAGIC, 4);
+		value = EXPORT_BINARY_VERSION;
+		memcpy(data+4, &value, 4);
+		value = EXPORT_BINARY_BYTE_ORDER;
+		memcpy(data+8, &value, 4);
+		memcpy(data+12, &created, 8);
+		value = length;
+		memcpy(data+20, &value, 4);
+		memcpy(data+24, exporter->algorithms, length);
+		length += 24;
+	}else{
+		length = export_format_header(data, EXPORT_BUFFER_SIZE-exporter->length, exporter->algorithms, created);
+	}
+	exporter->length += length;
+	exporter->file_bytes += length;
+}
+
+/**
+ * @brief Create the next file of the exporter (and its header)
+ * @param exporter EXPORTER_T to update
+ * @return integer 0 on success, M_FILE_OUTPUT_FAILED otherwise (with the errno)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int exporter_open_file(EXPORTER_T* exporter){
+	char* filename;
+	int size = strlen(exporter->basename)+strlen(exporter->extension)+16;
+
+	if((filename=malloc(sizeof(char)*size))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"\nMemory allocation failed for the filename %s%s", exporter->basename, exporter->extension);
+	}
+	exporter->index++;
+	// While rotating, each file gets its number on the name
+	if(exporter->rotate_bytes>0 || exporter->rotate_ms>0){
+		snprintf(filename, size, "%s.%d%s", exporter->basename, exporter->index, exporter->extension);
+	}else{
+		snprintf(filename, size, "%s%s", exporter->basename, exporter->extension);
+	}
+	exporter->fd = open(filename, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+	free(filename);
+	if(exporter->fd==-1){
+		return M_FILE_OUTPUT_FAILED;
+	}
+	exporter->opened_at = exporter->synced_at = exporter_time_ms();
+	exporter->file_bytes = 0;
+	exporter->file_records = 0;
+	exporter_append_header(exporter);
+	return 0;
+}
+
+/**
+ * @brief Create an exporter and its first file
+ * @param filename of the export (the extension of the format is added if missing)
+ * @param format of the files (EXPORT_FORMAT_CSV or EXPORT_FORMAT_BINARY)
+ * @param rotate_bytes size of a file to start a new one (0 to never rotate by size)
+ * @param rotate_seconds age of a file to start a new one (0 to never rotate by time)
+ * @param sync_ms interval to synchronize the file to the disk (0 after each result)
+ * @param algorithms selected on the Sorter (for the header of each file)
+ * @return EXPORTER_T pointer with the exporter, NULL if the file couldn't be created (with the errno)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+EXPORTER_T* exporter_open(char* filename, int format, long long rotate_bytes, int rotate_seconds, int sync_ms, char* algorithms){
+	EXPORTER_T* exporter = NULL;
+	int length = strlen(filename), saved_errno;
+
+	if((exporter=malloc(sizeof(EXPORTER_T)))==NULL || (exporter->buffer=malloc(EXPORT_BUFFER_SIZE))==NULL || (exporter->basename=malloc(sizeof(char)*(length+1)))==NULL || (exporter->algorithms=malloc(sizeof(char)*(strlen(algorithms)+1)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"\nMemory allocation failed for the exporter");
+	}
+	exporter->format = format;
+	exporter->extension = (format==EXPORT_FORMAT_BINARY)?SHOW_STATS_BINARY_EXPORT_EXTENSION:SHOW_STATS_FILE_EXPORT_EXTENSION;
+	// The extension is added to each file (with the number of the file before it while rotating)
+	strcpy(exporter->basename, filename);
+	if(ends_with(filename, exporter->extension)==TRUE){
+		exporter->basename[length-strlen(exporter->extension)] = '\0';
+	}
+	strcpy(exporter->algorithms, algorithms);
+	exporter->length = 0;
+	exporter->rotate_bytes = rotate_bytes;
+	exporter->rotate_ms = (long long)rotate_seconds*1000;
+	exporter->sync_ms = sync_ms;
+	exporter->dirty = FALSE;
+	exporter->index = 0;
+	exporter->records = 0;
+	if(exporter_open_file(exporter)!=0){
+		saved_errno = errno;
+		free(exporter->algorithms);
+		free(exporter->basename);
+		free(exporter->buffer);
+		free(exporter);
+		errno = saved_errno;
+		return NULL;
+	}
+	return exporter;
+}
+
+/**
+ * @brief Write the buffered results to the file and, if requested, synchronize it to the disk
+ * @param exporter EXPORTER_T to flush
+ * @param sync TRUE to synchronize the file to the disk
+ * @return integer 0 on success, M_FILE_OUTPUT_FAILED otherwise (with the errno)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int exporter_flush(EXPORTER_T* exporter, int sync){
+	int result;
+
+	if(exporter->length>0){
+		result = exporter_write_all(exporter->fd, exporter->buffer, exporter->length);
+		// The buffer is dropped even on errors, so a failing disk doesn't keep the results growing
+		exporter->length = 0;
+		if(result==-1){
+			return M_FILE_OUTPUT_FAILED;
+		}
+		exporter->dirty = TRUE;
+	}
+	if(sync==TRUE && exporter->dirty==TRUE){
+		if(fdatasync(exporter->fd)==-1){
+			return M_FILE_OUTPUT_FAILED;
+		}
+		exporter->dirty = FALSE;
+		exporter->synced_at = exporter_time_ms();
+	}
+	return 0;
+}
+
+/**
+ * @brief Add a result to the buffer of the exporter (only written to the file when the buffer fills)
+ * @param exporter EXPORTER_T to update
+ * @param stat SHARED_ALGORITHM_STAT_T with the result
+ * @return integer 0 on success, M_FILE_OUTPUT_FAILED otherwise (with the errno)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int exporter_write(EXPORTER_T* exporter, SHARED_ALGORITHM_STAT_T* stat){
+	char* data;
+	uint16_t filename_length, algorithm_length;
+	int32_t value;
+	int64_t nbytes = stat->nbytes;
+	int length;
+
+	if(exporter->length+EXPORT_MAXIMUM_RECORD_SIZE>EXPORT_BUFFER_SIZE && exporter_flush(exporter, FALSE)!=0){
+		return M_FILE_OUTPUT_FAILED;
+	}
+	data = exporter->buffer+exporter->length;
+	if(exporter->format==EXPORT_FORMAT_BINARY){
+		filename_length = strnlen(stat->filename, MAXCHARS-1);
+		algorithm_length = strnlen(stat->algorithm, MAXCHARS-1);
+		memcpy(data, &filename_length, 2);
+		memcpy(data+2, &algorithm_length, 2);
+		value = stat->nlines;
+		memcpy(data+4, &value, 4);
+		value = stat->niterations;
+		memcpy(data+8, &value, 4);
+		value = stat->nswaps;
+		memcpy(data+12, &value, 4);
+		value = stat->nduplicates;
+		memcpy(data+16, &value, 4);
+		memcpy(data+20, &nbytes, 8);
+		memcpy(data+28, &(stat->time), 8);
+		memcpy(data+36, &(stat->dedupe_time), 8);
+		memcpy(data+44, &(stat->time_saved), 4);
+		memcpy(data+48, &(stat->time_uncertainty), 4);
+		memcpy(data+EXPORT_BINARY_RECORD_SIZE, stat->filename, filename_length);
+		memcpy(data+EXPORT_BINARY_RECORD_SIZE+filename_length, stat->algorithm, algorithm_length);
+		length = EXPORT_BINARY_RECORD_SIZE+filename_length+algorithm_length;
+	}else{
+		length = export_format_csv(data, EXPORT_MAXIMUM_RECORD_SIZE, stat);
+	}
+	exporter->length += length;
+	exporter->file_bytes += length;
+	exporter->file_records++;
+	exporter->records++;
+	return 0;
+}
+
+/**
+ * @brief Rotate, synchronize or write the buffered results when due (to call outside of the critical sections)
+ *
+ * The rotation only happens between results, so a file can exceed the requested size by the last result
+ *
+ * @param exporter EXPORTER_T to maintain
+ * @param idle TRUE if there are no more results waiting (the buffered ones are written, so the file doesn't lag behind)
+ * @return integer 0 on success, M_FILE_OUTPUT_FAILED otherwise (with the errno)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int exporter_maintain(EXPORTER_T* exporter, int idle){
+	long long now = exporter_time_ms();
+
+	// An empty file is never rotated
+	if(exporter->file_records>0 && ((exporter->rotate_bytes>0 && exporter->file_bytes>=exporter->rotate_bytes) || (exporter->rotate_ms>0 && now-exporter->opened_at>=exporter->rotate_ms))){
+		if(exporter_flush(exporter, TRUE)!=0){
+			return M_FILE_OUTPUT_FAILED;
+		}
+		close(exporter->fd);
+		return exporter_open_file(exporter);
+	}
+	if(now-exporter->synced_at>=exporter->sync_ms){
+		return exporter_flush(exporter, TRUE);
+	}
+	if(idle==TRUE){
+		return exporter_flush(exporter, FALSE);
+	}
+	return 0;
+}
+
+/**
+ * @brief Write the buffered results, synchronize and close the file and free the exporter
+ * @param exporter EXPORTER_T to close
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void exporter_close(EXPORTER_T* exporter){
+	if(exporter!=NULL){
+		if(exporter->fd!=-1){
+			exporter_flush(exporter, TRUE);
+			close(exporter->fd);
+		}
+		free(exporter->algorithms);
+		free(exporter->basename);
+		free(exporter->buffer);
+		free(exporter);
+	}
+}
+
+/**
+ * @brief Format the comment lines on the beginning of the CSV files (and of the console output)
+ * @param buffer to store the lines
+ * @param size number of bytes of the buffer
+ * @param algorithms selected on the Sorter
+ * @param date of the experiment
+ * @return integer with the number of bytes of the lines (limited to the size of the buffer)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int export_format_header(char* buffer, int size, char* algorithms, time_t date){
+	char date_of_the_experiment[32];
+	struct tm *ltm;
+	int length;
+
+	if((ltm=localtime(&date))==NULL || strftime(date_of_the_experiment, sizeof(date_of_the_experiment), "@%Y-%m-%d %Hh%M", ltm)==0){
+		date_of_the_experiment[0] = '\0';
+	}
+	length = snprintf(buffer, size, "# showStats – sorter benchmark\n# Selected algorithms: %s\n# Date: %s\n# filename,nlines,algorithm,niterations,nswaps,time,nduplicates,dedupe_time,time_saved,time_uncertainty\n", algorithms, date_of_the_experiment);
+	return (length<size)?length:size-1;
+}
+
+/**
+ * @brief Format a result as a CSV line
+ * @param buffer to store the line
+ * @param size number of bytes of the buffer
+ * @param stat SHARED_ALGORITHM_STAT_T with the result
+ * @return integer with the number of bytes of the line (limited to the size of the buffer)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int export_format_csv(char* buffer, int size, SHARED_ALGORITHM_STAT_T* stat){
+	int length = snprintf(buffer, size, "%.*s,%d,%.*s,%d,%d,%.6f,%d,%.6f,%.0f,%.3f\n", MAXCHARS-1, stat->filename, stat->nlines, MAXCHARS-1, stat->algorithm, stat->niterations, stat->nswaps, stat->time, stat->nduplicates, stat->dedupe_time, stat->time_saved, stat->time_uncertainty);
+
+	return (length<size)?length:size-1;
+}
+
+/**
+ * @brief Read the header of a binary export file
+ * @param file to read, positioned on the beginning
+ * @param header EXPORT_FILE_HEADER_T to store the header
+ * @return integer 0 on success, M_FAILED_FILE_READ if the file isn't on a supported binary format
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int export_read_header(FILE* file, EXPORT_FILE_HEADER_T* header){
+	char data[24];
+	uint32_t version, byte_order, length;
+	int64_t created;
+
+	if(fread(data, 1, 24, file)!=24 || memcmp(data, EXPORT_BINARY_MAGIC, 4)!=0){
+		return M_FAILED_FILE_READ;
+	}
+	memcpy(&version, data+4, 4);
+	memcpy(&byte_order, data+8, 4);
+	memcpy(&created, data+12, 8);
+	memcpy(&length, data+20, 4);
+	// The files are written on the byte order of the machine
+	if(byte_order!=EXPORT_BINARY_BYTE_ORDER || version!=EXPORT_BINARY_VERSION || length>=MAXCHARS){
+		return M_FAILED_FILE_READ;
+	}
+	if(fread(header->algorithms, 1, length, file)!=length){
+		return M_FAILED_FILE_READ;
+	}
+	header->algorithms[length] = '\0';
+	header->version = version;
+	header->created = created;
+	return 0;
+}
+
+/**
+ * @brief Read the next record of a binary export file
+ * @param file to read, positioned after the header or the previous record
+ * @param stat SHARED_ALGORITHM_STAT_T to store the result
+ * @return integer 1 if a record was read, 0 at the end of the file, -1 if the record is truncated or invalid
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int export_read_record(FILE* file, SHARED_ALGORITHM_STAT_T* stat){
+	char data[EXPORT_BINARY_RECORD_SIZE];
+	uint16_t filename_length, algorithm_length;
+	int32_t value;
+	int64_t nbytes;
+	size_t length;
+
+	if((length=fread(data, 1, EXPORT_BINARY_RECORD_SIZE, file))!=EXPORT_BINARY_RECORD_SIZE){
+		return (length==0 && feof(file))?0:-1;
+	}
+	memcpy(&filename_length, data, 2);
+	memcpy(&algorithm_length, data+2, 2);
+	if(filename_length>=MAXCHARS || algorithm_length>=MAXCHARS){
+		return -1;
+	}
+	memcpy(&value, data+4, 4);
+	stat->nlines = value;
+	memcpy(&value, data+8, 4);
+	stat->niterations = value;
+	memcpy(&value, data+12, 4);
+	stat->nswaps = value;
+	memcpy(&value, data+16, 4);
+	stat->nduplicates = value;
+	memcpy(&nbytes, data+20, 8);
+	stat->nbytes = nbytes;
+	memcpy(&(stat->time), data+28, 8);
+	memcpy(&(stat->dedupe_time), data+36, 8);
+	memcpy(&(stat->time_saved), data+44, 4);
+	memcpy(&(stat->time_uncertainty), data+48, 4);
+	if(fread(stat->filename, 1, filename_length, file)!=filename_length || fread(stat->algorithm, 1, algorithm_length, file)!=algorithm_length){
+		return -1;
+	}
+	stat->filename[filename_length] = '\0';
+	stat->algorithm[algorithm_length] = '\0';
+	return 1;
+}
@@ -0,0 +1,68 @@
+/**
+* @file exportlib.h
+* @brief Header file for the buffered and rotating exporter of the statistical data
+* @date 2010/02/08 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef EXPORTLIB_H_
+#define EXPORTLIB_H_
+
+#include <stdio.h>
+#include <time.h>
+
+#include "commonlib.h"
+
+/**
+ * @brief Number of bytes of the fixed part of a record of the binary format (followed by the filename and the algorithm)
+ */
+#define EXPORT_BINARY_RECORD_SIZE 52
+
+/**
+ * @brief Maximum number of bytes of a formatted result (on any of the formats)
+ */
+#define EXPORT_MAXIMUM_RECORD_SIZE (2*MAXCHARS+512)
+
+/**
+ * @brief Type declaration to a structure to store the header of a binary export file
+ */
+typedef struct export_file_header {
+	int version;					/**< @brief version of the format */
+	time_t created;					/**< @brief creation time of the file */
+	char algorithms[MAXCHARS];		/**< @brief algorithms selected on the Sorter */
+} EXPORT_FILE_HEADER_T;
+
+/**
+ * @brief Type declaration to a structure to store the state of the exporter
+ */
+typedef struct exporter {
+	int fd;							/**< @brief descriptor of the current file (-1 if none) */
+	int format;						/**< @brief format of the files (EXPORT_FORMAT_CSV or EXPORT_FORMAT_BINARY) */
+	char* basename;					/**< @brief copy of the filename, without the extension */
+	const char* extension;			/**< @brief extension of the files of the format */
+	char* algorithms;				/**< @brief copy of the algorithms selected on the Sorter (for the header of each file) */
+	char* buffer;					/**< @brief results not yet written */
+	int length;						/**< @brief number of bytes on the buffer */
+	long long file_bytes;			/**< @brief number of bytes of the current file (including the buffered ones) */
+	long long file_records;			/**< @brief number of results on the current file */
+	long long rotate_bytes;			/**< @brief size of a file to start a new one (0 to never rotate by size) */
+	long long rotate_ms;			/**< @brief age (ms) of a file to start a new one (0 to never rotate by time) */
+	long long sync_ms;				/**< @brief interval (ms) to synchronize the file to the disk */
+	long long opened_at;			/**< @brief monotonic time (ms) of the creation of the current file */
+	long long synced_at;			/**< @brief monotonic time (ms) of the last synchronization */
+	int dirty;						/**< @brief TRUE if there are bytes written after the last synchronization */
+	int index;						/**< @brief number of the current file (only on the names while rotating) */
+	long long records;				/**< @brief number of exported results */
+} EXPORTER_T;
+
+EXPORTER_T* exporter_open(char*, int, long long, int, int, char*);
+int exporter_write(EXPORTER_T*, SHARED_ALGORITHM_STAT_T*);
+int exporter_maintain(EXPORTER_T*, int);
+int exporter_flush(EXPORTER_T*, int);
+void exporter_close(EXPORTER_T*);
+int export_format_header(char*, int, char*, time_t);
+int export_format_csv(char*, int, SHARED_ALGORITHM_STAT_T*);
+int export_read_header(FILE*, EXPORT_FILE_HEADER_T*);
+int export_read_record(FILE*, SHARED_ALGORITHM_STAT_T*);
+
+#endif /* EXPORTLIB_H_ */
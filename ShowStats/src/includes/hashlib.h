@@ -0,0 +1,47 @@
+/**
+* @file hashlib.h
+* @brief Header file for the open addressing hash map
+* @date 2010/01/18 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef HASHLIB_H_
+#define HASHLIB_H_
+
+/**
+ * @brief Type declaration to a structure to store a slot of the hash map
+ *
+ * The hash and the probe distance are kept inline, next to the key, so a probe only touches the slots array
+ */
+typedef struct hash_map_entry {
+	unsigned int hash;				/**< @brief lower 32 bits of the hash of the key */
+	int distance;					/**< @brief distance of the slot to the home slot of the key, plus one (0 for an empty slot) */
+	const void* key;				/**< @brief reference to the bytes of the key (not copied, must outlive the entry) */
+	int length;						/**< @brief number of bytes of the key */
+	void* value;					/**< @brief reference to the value stored with the key (never NULL) */
+} HASH_MAP_ENTRY_T;
+
+/**
+ * @brief Type declaration to a structure to store an open addressing hash map with Robin Hood probing
+ *
+ * @see hash_map_create for reference
+ */
+typedef struct hash_map {
+	HASH_MAP_ENTRY_T* entries;		/**< @brief reference to the slots */
+	int capacity;					/**< @brief number of slots (always a power of two) */
+	int count;						/**< @brief number of keys stored */
+	int maximum_count;				/**< @brief number of keys that makes the map grow */
+} HASH_MAP_T;
+
+unsigned long long hash_bytes(const void*, int, unsigned long long);
+HASH_MAP_T* hash_map_create(int);
+void hash_map_free(HASH_MAP_T*);
+void hash_map_reserve(HASH_MAP_T*, int);
+void* hash_map_insert(HASH_MAP_T*, const void*, int, void*);
+void* hash_map_find(HASH_MAP_T*, const void*, int);
+void* hash_map_remove(HASH_MAP_T*, const void*, int);
+void hash_map_clear(HASH_MAP_T*);
+int hash_map_count(HASH_MAP_T*);
+int hash_map_next(HASH_MAP_T*, int*, const void**, int*, void**);
+
+#endif /* HASHLIB_H_ */
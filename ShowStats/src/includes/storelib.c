@@ -0,0 +1,585 @@
+/**
+* @file storelib.c
+* @brief source file for the in-memory columnar store of the statistical data
+* @date 2010/01/27 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "../3rd/debug.h"
+#include "definitions.h"
+#include "aux.h"
+#include "commonlib.h"
+#include "hashlib.h"
+#include "storelib.h"
+
+/**
+ * @brief Initialize an empty dictionary
+ * @param dictionary STORE_DICTIONARY_T to initialize
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void store_dictionary_init(STORE_DICTIONARY_T* dictionary){
+	dictionary->map = hash_map_create(0);
+	dictionary->values = NULL;
+	dictionary->count = dictionary->capacity = 0;
+}
+
+/**
+ * @brief Free the values of a dictionary
+ * @param dictionary STORE_DICTIONARY_T to free
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void store_dictionary_free(STORE_DICTIONARY_T* dictionary){
+	int a;
+
+	for(a=0; a<dictionary->count; a++){
+		free(dictionary->values[a]->name);
+		free(dictionary->values[a]->rows);
+		free(dictionary->values[a]);
+	}
+	free(dictionary->values);
+	hash_map_free(dictionary->map);
+	dictionary->values = NULL;
+	dictionary->count = dictionary->capacity = 0;
+}
+
+/**
+ * @brief Get the value of a dictionary with the given text
+ * @param dictionary STORE_DICTIONARY_T to search
+ * @param name text of the value
+ * @return STORE_VALUE_T pointer with the value, NULL if the dictionary doesn't have it
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static STORE_VALUE_T* store_dictionary_find(STORE_DICTIONARY_T* dictionary, char* name){
+	return (STORE_VALUE_T*) hash_map_find(dictionary->map, name, strlen(name));
+}
+
+/**
+ * @brief Add a row to the value of a dictionary with the given text (the value is created if needed)
+ * @param dictionary STORE_DICTIONARY_T with the values
+ * @param name text of the value
+ * @param row index of the row
+ * @return integer with the identifier of the value
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int store_dictionary_add(STORE_DICTIONARY_T* dictionary, char* name, int row){
+	STORE_VALUE_T* value;
+
+	if((value = store_dictionary_find(dictionary, name))==NULL){
+		if(dictionary->count==dictionary->capacity){
+			dictionary->capacity = (dictionary->capacity>0)?dictionary->capacity*2:STORE_MINIMUM_CAPACITY;
+			if((dictionary->values = realloc(dictionary->values, sizeof(STORE_VALUE_T*)*dictionary->capacity))==NULL){
+				ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the stats store\n");
+			}
+		}
+		if((value = calloc(1, sizeof(STORE_VALUE_T)))==NULL || (value->name = strdup(name))==NULL){
+			ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the stats store\n");
+		}
+		value->length = strlen(name);
+		value->winner = -1;
+		// The identifiers are given by order of creation
+		value->id = dictionary->count;
+		dictionary->values[dictionary->count++] = value;
+		// The key is the copy of the text, that lives as long as the value
+		hash_map_insert(dictionary->map, value->name, value->length, value);
+	}
+	if(value->count==value->capacity){
+		value->capacity = (value->capacity>0)?value->capacity*2:STORE_MINIMUM_CAPACITY;
+		if((value->rows = realloc(value->rows, sizeof(int)*value->capacity))==NULL){
+			ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the stats store\n");
+		}
+	}
+	value->rows[value->count++] = row;
+	return value->id;
+}
+
+/**
+ * @brief Get the position of the first row of a value with an index equal or greater than the given one
+ * @param value STORE_VALUE_T with the rows
+ * @param index of the row
+ * @return integer with the position on the rows of the value (the number of rows if there isn't such row)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int store_value_lower_bound(STORE_VALUE_T* value, int index){
+	int lower=0, upper=value->count, middle;
+
+	while(lower<upper){
+		middle = lower+(upper-lower)/2;
+		if(value->rows[middle]<index){
+			lower = middle+1;
+		}else{
+			upper = middle;
+		}
+	}
+	return lower;
+}
+
+/**
+ * @brief Initialize an empty histogram
+ * @param histogram STORE_HISTOGRAM_T to initialize
+ * @param first_exponent power of ten of the first bound
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void store_histogram_init(STORE_HISTOGRAM_T* histogram, int first_exponent){
+	memset(histogram, 0, sizeof(STORE_HISTOGRAM_T));
+	histogram->first_exponent = first_exponent;
+}
+
+/**
+ * @brief Get a bound of a histogram
+ * @param histogram STORE_HISTOGRAM_T with the bounds
+ * @param bucket position of the bound (from 0 to STORE_HISTOGRAM_BUCKETS-1)
+ * @return double with the bound (1, 2 and 5 times each power of ten from the first one)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+double store_histogram_bound(STORE_HISTOGRAM_T* histogram, int bucket){
+	static const double mantissas[] = {1, 2, 5};
+	double bound = mantissas[bucket%3];
+	int exponent = histogram->first_exponent+bucket/3;
+
+	for(; exponent>0; exponent--){
+		bound *= 10;
+	}
+	for(; exponent<0; exponent++){
+		bound /= 10;
+	}
+	return bound;
+}
+
+/**
+ * @brief Add an observation to a histogram
+ * @param histogram STORE_HISTOGRAM_T to update
+ * @param value observed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void store_histogram_observe(STORE_HISTOGRAM_T* histogram, double value){
+	int bucket=0;
+
+	// Only the bucket of the value is counted (the cumulative counts are summed when read)
+	while(bucket<STORE_HISTOGRAM_BUCKETS && value>store_histogram_bound(histogram, bucket)){
+		bucket++;
+	}
+	histogram->buckets[bucket]++;
+	histogram->count++;
+	histogram->sum += value;
+}
+
+/**
+ * @brief Add an observation to the estimation of the quantiles
+ * @param quantiles STORE_QUANTILES_T to update
+ * @param value observed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void store_quantiles_observe(STORE_QUANTILES_T* quantiles, double value){
+	double mantissa;
+	int exponent, bucket;
+
+	if(quantiles->count==0 || value<quantiles->minimum){
+		quantiles->minimum = value;
+	}
+	if(quantiles->count==0 || value>quantiles->maximum){
+		quantiles->maximum = value;
+	}
+	quantiles->count++;
+	// The value is mantissa*2^exponent, with the mantissa from 0.5 to 1
+	mantissa = frexp(value, &exponent);
+	if(!(value>0) || exponent<=STORE_QUANTILE_MINIMUM_EXPONENT){
+		quantiles->zeros++;
+		return;
+	}
+	if(exponent>STORE_QUANTILE_MAXIMUM_EXPONENT){
+		exponent = STORE_QUANTILE_MAXIMUM_EXPONENT;
+		mantissa = 0.999;
+	}
+	bucket = (exponent-STORE_QUANTILE_MINIMUM_EXPONENT-1)*STORE_QUANTILE_SUBBUCKETS+(int) ((mantissa-0.5)*2*STORE_QUANTILE_SUBBUCKETS);
+	quantiles->buckets[bucket]++;
+}
+
+/**
+ * @brief Get the estimation of a quantile
+ * @param quantiles STORE_QUANTILES_T with the observations
+ * @param quantile to estimate (0 to 1)
+ * @return double with the estimation (the middle of the bucket of the quantile, within the observed values), 0 if there are no observations
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+double store_quantile_value(STORE_QUANTILES_T* quantiles, double quantile){
+	long rank, seen;
+	double value;
+	int bucket;
+
+	if(quantiles->count==0){
+		return 0;
+	}
+	// Rank of the observation of the quantile (nearest rank)
+	rank = (long) ceil(quantile*quantiles->count);
+	rank = (rank<1)?1:rank;
+	if((seen = quantiles->zeros)>=rank){
+		return quantiles->minimum;
+	}
+	for(bucket=0; bucket<(STORE_QUANTILE_MAXIMUM_EXPONENT-STORE_QUANTILE_MINIMUM_EXPONENT)*STORE_QUANTILE_SUBBUCKETS; bucket++){
+		if((seen += quantiles->buckets[bucket])>=rank){
+			break;
+		}
+	}
+	// The middle of the bucket
+	value = ldexp(0.5+(bucket%STORE_QUANTILE_SUBBUCKETS+0.5)/(2*STORE_QUANTILE_SUBBUCKETS), bucket/STORE_QUANTILE_SUBBUCKETS+STORE_QUANTILE_MINIMUM_EXPONENT+1);
+	return (value<quantiles->minimum)?quantiles->minimum:((value>quantiles->maximum)?quantiles->maximum:value);
+}
+
+/**
+ * @brief Add a record to the aggregated measures of its algorithm
+ * @param store STATS_STORE_T with the measures
+ * @param row index of the record on the store
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void store_update_metrics(STATS_STORE_T* store, int row){
+	STORE_METRICS_T* metrics;
+	STORE_VALUE_T* file;
+	int id = store->algorithm[row];
+
+	if(id>=store->metrics_capacity){
+		// The algorithms are few and only added, so the measures follow the capacity of the dictionary
+		if((store->metrics = realloc(store->metrics, sizeof(STORE_METRICS_T)*store->algorithms.capacity))==NULL){
+			ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the stats store\n");
+		}
+		store->metrics_capacity = store->algorithms.capacity;
+	}
+	metrics = &(store->metrics[id]);
+	if(store->algorithms.values[id]->count==1){
+		// First record of the algorithm
+		memset(metrics, 0, sizeof(STORE_METRICS_T));
+		metrics->algorithm = store->algorithms.values[id]->name;
+		store_histogram_init(&(metrics->duration), -5);
+		store_histogram_init(&(metrics->throughput), 0);
+		store_histogram_init(&(metrics->iterations), 0);
+		store_histogram_init(&(metrics->swaps), 0);
+		store_histogram_init(&(metrics->bytes), 1);
+	}
+	metrics->count++;
+	metrics->nlines += store->nlines[row];
+	metrics->nbytes += store->nbytes[row];
+	metrics->niterations += store->niterations[row];
+	metrics->nswaps += store->nswaps[row];
+	metrics->nduplicates += store->nduplicates[row];
+	metrics->time += store->time[row];
+	store_quantiles_observe(&(metrics->quantiles), store->time[row]);
+	// The time of the records is in milliseconds
+	store_histogram_observe(&(metrics->duration), store->time[row]/1000);
+	if(store->time[row]>0){
+		store_histogram_observe(&(metrics->throughput), store->nlines[row]/(store->time[row]/1000));
+	}
+	store_histogram_observe(&(metrics->iterations), store->niterations[row]);
+	store_histogram_observe(&(metrics->swaps), store->nswaps[row]);
+	store_histogram_observe(&(metrics->bytes), store->nbytes[row]);
+
+	// The fastest algorithm of the file (the first one keeps the file on a tie)
+	file = store->filenames.values[store->filename[row]];
+	if(file->winner==-1 || store->time[row]<file->winner_time){
+		if(file->winner!=-1){
+			store->metrics[file->winner].wins--;
+		}
+		file->winner = id;
+		file->winner_time = store->time[row];
+		metrics->wins++;
+	}
+}
+
+/**
+ * @brief Create an empty store
+ * @return STATS_STORE_T pointer with the store
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+STATS_STORE_T* store_create(void){
+	STATS_STORE_T* store;
+	pthread_rwlockattr_t attributes;
+
+	if((store = calloc(1, sizeof(STATS_STORE_T)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the stats store\n");
+	}
+	store_dictionary_init(&(store->filenames));
+	store_dictionary_init(&(store->algorithms));
+	// The appends go before the new readers, so a steady flow of web requests can't hold the consumer of the stats
+	pthread_rwlockattr_init(&attributes);
+	pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+	if(pthread_rwlock_init(&(store->lock), &attributes)!=0){
+		ERROR(M_PTHREAD_MUTEX_INIT_FAILED, "\nStats store lock initialization failed.\n");
+	}
+	pthread_rwlockattr_destroy(&attributes);
+	return store;
+}
+
+/**
+ * @brief Free the store and all its rows
+ * @param store STATS_STORE_T to free
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void store_free(STATS_STORE_T* store){
+	free(store->filename);
+	free(store->algorithm);
+	free(store->nlines);
+	free(store->niterations);
+	free(store->nswaps);
+	free(store->time);
+	free(store->nduplicates);
+	free(store->dedupe_time);
+	free(store->time_saved);
+	free(store->time_uncertainty);
+	free(store->nbytes);
+	free(store->metrics);
+	store_dictionary_free(&(store->filenames));
+	store_dictionary_free(&(store->algorithms));
+	pthread_rwlock_destroy(&(store->lock));
+	free(store);
+}
+
+/**
+ * @brief Grow a column of the store
+ * @param column reference to the column
+ * @param size of each element
+ * @param capacity new number of elements
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void store_grow_column(void** column, size_t size, int capacity){
+	void* new_column;
+
+	if((new_column = realloc(*column, size*capacity))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the stats store\n");
+	}
+	*column = new_column;
+}
+
+/**
+ * @brief Append a record from the shared memory to the store
+ * @param store STATS_STORE_T to append
+ * @param stat SHARED_ALGORITHM_STAT_T with the record
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void store_append(STATS_STORE_T* store, SHARED_ALGORITHM_STAT_T* stat){
+	int row;
+
+	if(pthread_rwlock_wrlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store lock failed\n");
+		return;
+	}
+	if(store->count==store->capacity){
+		store->capacity = (store->capacity>0)?store->capacity*2:STORE_MINIMUM_CAPACITY;
+		store_grow_column((void**) &(store->filename), sizeof(int), store->capacity);
+		store_grow_column((void**) &(store->algorithm), sizeof(int), store->capacity);
+		store_grow_column((void**) &(store->nlines), sizeof(int), store->capacity);
+		store_grow_column((void**) &(store->niterations), sizeof(int), store->capacity);
+		store_grow_column((void**) &(store->nswaps), sizeof(int), store->capacity);
+		store_grow_column((void**) &(store->time), sizeof(double), store->capacity);
+		store_grow_column((void**) &(store->nduplicates), sizeof(int), store->capacity);
+		store_grow_column((void**) &(store->dedupe_time), sizeof(double), store->capacity);
+		store_grow_column((void**) &(store->time_saved), sizeof(float), store->capacity);
+		store_grow_column((void**) &(store->time_uncertainty), sizeof(float), store->capacity);
+		store_grow_column((void**) &(store->nbytes), sizeof(long), store->capacity);
+	}
+	row = store->count;
+	store->filename[row] = store_dictionary_add(&(store->filenames), stat->filename, row);
+	store->algorithm[row] = store_dictionary_add(&(store->algorithms), stat->algorithm, row);
+	store->nlines[row] = stat->nlines;
+	store->niterations[row] = stat->niterations;
+	store->nswaps[row] = stat->nswaps;
+	store->time[row] = stat->time;
+	store->nduplicates[row] = stat->nduplicates;
+	store->dedupe_time[row] = stat->dedupe_time;
+	store->time_saved[row] = stat->time_saved;
+	store->time_uncertainty[row] = stat->time_uncertainty;
+	store->nbytes[row] = stat->nbytes;
+	store_update_metrics(store, row);
+	store->count++;
+	if(pthread_rwlock_unlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store unlock failed\n");
+	}
+}
+
+/**
+ * @brief Get the number of rows of the store
+ * @param store STATS_STORE_T to count
+ * @return integer with the number of rows
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int store_count(STATS_STORE_T* store){
+	int count;
+
+	pthread_rwlock_rdlock(&(store->lock));
+	count = store->count;
+	pthread_rwlock_unlock(&(store->lock));
+	return count;
+}
+
+/**
+ * @brief Call a function for the rows of the store from an index, optionally filtered by algorithm and by filename
+ *
+ * The filtered selections only visit the rows of the value (the shortest list, if both filters are given).
+ *
+ * @param store STATS_STORE_T with the rows
+ * @param since index of the first row to consider
+ * @param algorithm to select (NULL for all)
+ * @param filename to select (NULL for all)
+ * @param limit maximum number of rows to select
+ * @param function STORE_ROW_FUNC to call for each row
+ * @param data to pass to the function
+ * @param total to store the number of rows of the store
+ * @return integer with the index to use on the next selection (of the first row not selected), -1 if the function stopped the selection
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int store_select(STATS_STORE_T* store, int since, char* algorithm, char* filename, int limit, STORE_ROW_FUNC function, void* data, int* total){
+	STORE_VALUE_T *algorithm_value=NULL, *filename_value=NULL, *list=NULL;
+	ALGORITHM_STAT_T row;
+	int next, selected=0, position, index;
+
+	if(pthread_rwlock_rdlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store lock failed\n");
+		return -1;
+	}
+	*total = next = store->count;
+	if(since<0){
+		since = 0;
+	}
+	if((algorithm!=NULL && (algorithm_value = store_dictionary_find(&(store->algorithms), algorithm))==NULL) || (filename!=NULL && (filename_value = store_dictionary_find(&(store->filenames), filename))==NULL)){
+		// Nothing to select
+		pthread_rwlock_unlock(&(store->lock));
+		return next;
+	}
+	if(algorithm_value!=NULL && (filename_value==NULL || algorithm_value->count<=filename_value->count)){
+		list = algorithm_value;
+	}else{
+		list = filename_value;
+	}
+
+	position = (list!=NULL)?store_value_lower_bound(list, since):since;
+	for(;;position++){
+		if(list!=NULL){
+			if(position>=list->count){
+				break;
+			}
+			index = list->rows[position];
+		}else if((index = position)>=store->count){
+			break;
+		}
+		// The other filter, if any
+		if((algorithm_value!=NULL && store->algorithm[index]!=algorithm_value->id) || (filename_value!=NULL && store->filename[index]!=filename_value->id)){
+			continue;
+		}
+		if(selected==limit){
+			next = index;
+			break;
+		}
+		row.filename = store->filenames.values[store->filename[index]]->name;
+		row.algorithm = store->algorithms.values[store->algorithm[index]]->name;
+		row.nlines = store->nlines[index];
+		row.niterations = store->niterations[index];
+		row.nswaps = store->nswaps[index];
+		row.time = store->time[index];
+		row.nduplicates = store->nduplicates[index];
+		row.dedupe_time = store->dedupe_time[index];
+		row.time_saved = store->time_saved[index];
+		row.time_uncertainty = store->time_uncertainty[index];
+		row.nbytes = store->nbytes[index];
+		if(function(index, &row, data)==FALSE){
+			next = -1;
+			break;
+		}
+		selected++;
+	}
+	if(pthread_rwlock_unlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store unlock failed\n");
+	}
+	return next;
+}
+
+/**
+ * @brief Copy the aggregated measures of each algorithm
+ *
+ * The measures are updated on each append, so the copy doesn't depend on the number of rows of the store.
+ *
+ * @param store STATS_STORE_T with the measures
+ * @param count to store the number of algorithms
+ * @return STORE_METRICS_T pointer with the measures of each algorithm (to free by the caller), NULL if the store has no rows
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+STORE_METRICS_T* store_copy_metrics(STATS_STORE_T* store, int* count){
+	STORE_METRICS_T* metrics = NULL;
+
+	*count = 0;
+	if(pthread_rwlock_rdlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store lock failed\n");
+		return NULL;
+	}
+	if(store->algorithms.count>0){
+		if((metrics = malloc(sizeof(STORE_METRICS_T)*store->algorithms.count))!=NULL){
+			memcpy(metrics, store->metrics, sizeof(STORE_METRICS_T)*store->algorithms.count);
+			*count = store->algorithms.count;
+		}else{
+			MY_DEBUG("\nMemory allocation failed for the stats store metrics\n");
+		}
+	}
+	if(pthread_rwlock_unlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store unlock failed\n");
+	}
+	return metrics;
+}
+
+/**
+ * @brief Call a function for the files of the store from an index, with the fastest algorithm of each one
+ * @param store STATS_STORE_T with the files
+ * @param since index of the first file to consider (the files are indexed by order of arrival)
+ * @param limit maximum number of files to select
+ * @param function STORE_WINNER_FUNC to call for each file
+ * @param data to pass to the function
+ * @param total to store the number of files of the store
+ * @return integer with the index to use on the next selection (of the first file not selected), -1 if the function stopped the selection
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int store_select_winners(STATS_STORE_T* store, int since, int limit, STORE_WINNER_FUNC function, void* data, int* total){
+	STORE_VALUE_T* file;
+	int index, next, selected=0;
+
+	if(pthread_rwlock_rdlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store lock failed\n");
+		return -1;
+	}
+	*total = next = store->filenames.count;
+	for(index=(since>0)?since:0; index<store->filenames.count; index++){
+		if(selected==limit){
+			next = index;
+			break;
+		}
+		file = store->filenames.values[index];
+		if(function(index, file->name, store->algorithms.values[file->winner]->name, file->winner_time, file->count, data)==FALSE){
+			next = -1;
+			break;
+		}
+		selected++;
+	}
+	if(pthread_rwlock_unlock(&(store->lock))!=0){
+		MY_DEBUG("\nStats store unlock failed\n");
+	}
+	return next;
+}
@@ -0,0 +1,144 @@
+/**
+* @file storelib.h
+* @brief Header file for the in-memory columnar store of the statistical data
+* @date 2010/01/27 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef STORELIB_H_
+#define STORELIB_H_
+
+#include <pthread.h>
+
+#include "commonlib.h"
+#include "hashlib.h"
+
+/**
+ * @brief Type declaration to a structure to store a distinct value of a text column (filename or algorithm)
+ */
+typedef struct store_value {
+	int id;							/**< @brief identifier of the value (stored on the rows) */
+	char* name;						/**< @brief copy of the text */
+	int length;						/**< @brief number of bytes of the text */
+	int* rows;						/**< @brief indexes of the rows with the value, in ascending order */
+	int count;						/**< @brief number of rows with the value */
+	int capacity;					/**< @brief number of indexes allocated */
+	int winner;						/**< @brief identifier of the fastest algorithm for the file (filenames only, -1 if none) */
+	double winner_time;				/**< @brief time of the fastest algorithm for the file (filenames only) */
+} STORE_VALUE_T;
+
+/**
+ * @brief Type declaration to a structure to store the distinct values of a text column
+ *
+ * Each row stores only the identifier of its value, and each value keeps the list of its rows (to filter by the value)
+ */
+typedef struct store_dictionary {
+	HASH_MAP_T* map;				/**< @brief values by text */
+	STORE_VALUE_T** values;			/**< @brief values by identifier */
+	int count;						/**< @brief number of distinct values */
+	int capacity;					/**< @brief number of values allocated */
+} STORE_DICTIONARY_T;
+
+/**
+ * @brief Type declaration to a structure to store a histogram of a measure, updated as the records arrive
+ */
+typedef struct store_histogram {
+	int first_exponent;									/**< @brief power of ten of the first bound */
+	long buckets[STORE_HISTOGRAM_BUCKETS+1];			/**< @brief number of observations up to each bound and above the previous one (the last for the values above all the bounds) */
+	long count;											/**< @brief number of observations */
+	double sum;											/**< @brief sum of the observed values */
+} STORE_HISTOGRAM_T;
+
+/**
+ * @brief Type declaration to a structure to estimate the quantiles of a measure with constant memory and time per observation
+ *
+ * The observations are counted on buckets with a width proportional to their value (STORE_QUANTILE_SUBBUCKETS for each power of two),
+ * so any quantile is estimated with a bounded relative error, no matter the distribution.
+ */
+typedef struct store_quantiles {
+	long count;															/**< @brief number of observations */
+	long zeros;															/**< @brief number of observations below the first bucket (including 0) */
+	long buckets[(STORE_QUANTILE_MAXIMUM_EXPONENT-STORE_QUANTILE_MINIMUM_EXPONENT)*STORE_QUANTILE_SUBBUCKETS];	/**< @brief number of observations of each bucket */
+	double minimum;														/**< @brief smallest observation */
+	double maximum;														/**< @brief greatest observation */
+} STORE_QUANTILES_T;
+
+/**
+ * @brief Type declaration to a structure to store the aggregated measures of an algorithm
+ */
+typedef struct store_metrics {
+	char* algorithm;				/**< @brief reference to the name of the algorithm (owned by the store) */
+	long long count;				/**< @brief number of sorts */
+	long long nlines;				/**< @brief number of lines sorted */
+	long long nbytes;				/**< @brief number of bytes sorted */
+	long long niterations;			/**< @brief number of iterations (comparisons) */
+	long long nswaps;				/**< @brief number of swaps */
+	long long nduplicates;			/**< @brief number of duplicated lines removed */
+	double time;					/**< @brief sum of the time of the sorts (ms) */
+	STORE_QUANTILES_T quantiles;	/**< @brief distribution of the time of the sorts (ms), for the median and the percentiles */
+	long long wins;					/**< @brief number of files where the algorithm is the fastest */
+	STORE_HISTOGRAM_T duration;		/**< @brief time of each sort (seconds) */
+	STORE_HISTOGRAM_T throughput;	/**< @brief lines sorted per second of each sort (only the sorts with a measurable time) */
+	STORE_HISTOGRAM_T iterations;	/**< @brief number of iterations of each sort */
+	STORE_HISTOGRAM_T swaps;		/**< @brief number of swaps of each sort */
+	STORE_HISTOGRAM_T bytes;		/**< @brief number of bytes of each sort */
+} STORE_METRICS_T;
+
+/**
+ * @brief Type declaration to a structure to store the statistical data by column
+ *
+ * @see store_create for reference
+ */
+typedef struct stats_store {
+	int count;						/**< @brief number of rows */
+	int capacity;					/**< @brief number of rows allocated on each column */
+	int* filename;					/**< @brief identifier of the filename of each row */
+	int* algorithm;					/**< @brief identifier of the algorithm of each row */
+	int* nlines;					/**< @brief number of lines of each row */
+	int* niterations;				/**< @brief number of iterations of each row */
+	int* nswaps;					/**< @brief number of swaps of each row */
+	double* time;					/**< @brief time of each row (ms) */
+	int* nduplicates;				/**< @brief number of duplicated lines removed of each row */
+	double* dedupe_time;			/**< @brief time spent removing the duplicated lines of each row (ms) */
+	float* time_saved;				/**< @brief estimated sort time saved of each row */
+	float* time_uncertainty;		/**< @brief estimated error of the time of each row */
+	long* nbytes;					/**< @brief number of bytes of each row */
+	STORE_DICTIONARY_T filenames;	/**< @brief distinct filenames */
+	STORE_DICTIONARY_T algorithms;	/**< @brief distinct algorithms */
+	STORE_METRICS_T* metrics;		/**< @brief aggregated measures of each algorithm (by identifier), updated on each append */
+	int metrics_capacity;			/**< @brief number of algorithms allocated for the measures */
+	pthread_rwlock_t lock;			/**< @brief lock of the store (the readers share it) */
+} STATS_STORE_T;
+
+/**
+ * @brief Function called for each row selected from the store
+ * @param index of the row
+ * @param row ALGORITHM_STAT_T with the values of the row (the strings are owned by the store)
+ * @param data given to the store_select
+ * @return integer TRUE to continue, FALSE to stop the selection
+ */
+typedef int (*STORE_ROW_FUNC)(int, ALGORITHM_STAT_T*, void*);
+
+/**
+ * @brief Function called for each file selected by the store_select_winners
+ * @param index of the file (by order of arrival)
+ * @param filename of the file
+ * @param algorithm fastest for the file
+ * @param time of the fastest algorithm
+ * @param results number of results of the file
+ * @param data given to the store_select_winners
+ * @return integer TRUE to continue, FALSE to stop the selection
+ */
+typedef int (*STORE_WINNER_FUNC)(int, char*, char*, double, int, void*);
+
+STATS_STORE_T* store_create(void);
+void store_free(STATS_STORE_T*);
+void store_append(STATS_STORE_T*, SHARED_ALGORITHM_STAT_T*);
+int store_count(STATS_STORE_T*);
+int store_select(STATS_STORE_T*, int, char*, char*, int, STORE_ROW_FUNC, void*, int*);
+STORE_METRICS_T* store_copy_metrics(STATS_STORE_T*, int*);
+double store_histogram_bound(STORE_HISTOGRAM_T*, int);
+double store_quantile_value(STORE_QUANTILES_T*, double);
+int store_select_winners(STATS_STORE_T*, int, int, STORE_WINNER_FUNC, void*, int*);
+
+#endif /* STORELIB_H_ */
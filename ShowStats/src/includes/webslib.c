@@ -8,11 +8,19 @@
 *
 */
 
+#define _GNU_SOURCE // for the accept4
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -20,11 +28,18 @@
 #include <arpa/inet.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <time.h>
 #include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <zlib.h>
+#include <sys/uio.h>
 
 #include "../3rd/debug.h"
 #include "definitions.h"
 #include "aux.h"
+#include "commonlib.h"
+#include "storelib.h"
 #include "webslib.h"
 
 /**
@@ -56,17 +71,100 @@ void *get_in_addr(void* sa){
 }
 
 /**
- * @brief Create a web server to listen on the specified port with maximum simultaneous connections
+ * @brief Get the current time of the monotonic clock
+ * @return long long with the time in milliseconds
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static long long monotonic_time_ms(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec*1000LL+now.tv_nsec/1000000;
+}
+
+/**
+ * @brief Take a reference to the published snapshot of the page
+ * @param web_server_params with the content of the web server
+ * @return WEB_SNAPSHOT_T pointer with the snapshot (to release with release_web_snapshot)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static WEB_SNAPSHOT_T* acquire_web_snapshot(WEB_SERVER_PARAMS_T *web_server_params){
+	WEB_SNAPSHOT_T *snapshot;
+
+	// The lock only keeps the snapshot from being released between reading the pointer and counting the reference
+	pthread_spin_lock(&(web_server_params->snapshot_lock));
+	snapshot = web_server_params->snapshot;
+	__sync_fetch_and_add(&(snapshot->references), 1);
+	pthread_spin_unlock(&(web_server_params->snapshot_lock));
+	return snapshot;
+}
+
+/**
+ * @brief Release a reference to a snapshot of the page (the last one frees it)
+ * @param snapshot WEB_SNAPSHOT_T to release
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void release_web_snapshot(WEB_SNAPSHOT_T *snapshot){
+	if(__sync_sub_and_fetch(&(snapshot->references), 1)==0){
+		free(snapshot->gzip_content);
+		// The message is on the allocation of the snapshot
+		free(snapshot);
+	}
+}
+
+/**
+ * @brief Publish a snapshot with the current content of the page (the caller holds the mutex of the writers)
+ *
+ * The previous snapshot is freed once the last response referencing it is sent.
+ *
+ * @param web_server_params with the content of the web server
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void publish_web_snapshot(WEB_SERVER_PARAMS_T *web_server_params){
+	WEB_SNAPSHOT_T *snapshot, *previous;
+	int message_length = (web_server_params->message!=NULL)?strlen(web_server_params->message):0;
+
+	if((snapshot = malloc(sizeof(WEB_SNAPSHOT_T)+message_length+1))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the web server content\n");
+	}
+	snapshot->version = ++(web_server_params->content_version);
+	snapshot->references = 1;
+	snapshot->message = (char*) (snapshot+1);
+	snapshot->message_length = message_length;
+	memcpy(snapshot->message, (web_server_params->message!=NULL)?web_server_params->message:"", message_length+1);
+	// The chunks are append only, so the bytes up to the current length don't change anymore
+	snapshot->first_chunk = web_server_params->first_chunk;
+	snapshot->last_chunk = web_server_params->last_chunk;
+	snapshot->last_length = (snapshot->last_chunk!=NULL)?snapshot->last_chunk->length:0;
+	snapshot->content_length = web_server_params->content_length;
+	snapshot->gzip_state = WEB_GZIP_NONE;
+	snapshot->gzip_content = NULL;
+	snapshot->gzip_length = 0;
+
+	pthread_spin_lock(&(web_server_params->snapshot_lock));
+	previous = web_server_params->snapshot;
+	web_server_params->snapshot = snapshot;
+	pthread_spin_unlock(&(web_server_params->snapshot_lock));
+	if(previous!=NULL){
+		release_web_snapshot(previous);
+	}
+}
+
+/**
+ * @brief Create a non-blocking socket listening on the specified port
  * @param port string with the port number
- * @param connections integer with the maximum number of simultaneous connections to server
- * @param t_web_server with the web server thread to use
- * @param web_server_params structure to store the thread params
+ * @param reuse_port TRUE to allow other sockets to listen on the same port (the kernel balances the connections between them)
+ * @return integer with the socket
  *
  * @author Brian "Beej Jorgensen" Hall <beej@beej.us>, Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-void create_web_server(char* port, int connections, pthread_t *t_web_server, WEB_SERVER_PARAMS_T *web_server_params){
+static int create_listening_socket(char* port, int reuse_port){
 	int rv;											// To store the return value of getaddrinfo (for error handling)
-	int sockfd;  									// Listen on sock_fd, New connections on new_fd
+	int sockfd=-1;									// Listen on sock_fd
 	int yes=TRUE;									// To flag the reuse of a socket
 	struct addrinfo hints;							// To store relevant information about our service
 	struct addrinfo *servinfo, *p;					// To store the results of getaddrinfo queries
@@ -82,13 +180,13 @@ void create_web_server(char* port, int connections, pthread_t *t_web_server, WEB
 
 	// Query information about the port and the network
 	if ((rv = getaddrinfo(NULL, port, &hints, &servinfo)) != 0) {
-		ERROR(M_GETADDRINFO_ERROR, "\nFailed to get information about the port %d (%s)\n", port, gai_strerror(rv));
+		ERROR(M_GETADDRINFO_ERROR, "\nFailed to get information about the port %s (%s)\n", port, gai_strerror(rv));
 	}
 
 	// loop through all the results and bind to the first we can
 	for(p = servinfo; p != NULL; p = p->ai_next) {
-		// Tries to create the socket
-		if ((sockfd = socket(p->ai_family, p->ai_socktype, p->ai_protocol)) == -1) {
+		// Tries to create the socket (the accept loop must never block the thread)
+		if ((sockfd = socket(p->ai_family, p->ai_socktype | SOCK_NONBLOCK, p->ai_protocol)) == -1) {
 			MY_DEBUG("Server socket error\n");
 			continue;
 		}
@@ -97,6 +195,10 @@ void create_web_server(char* port, int connections, pthread_t *t_web_server, WEB
 		if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int)) == -1) {
 			ERROR(M_SETSOCKOPT_ERROR, "\nError while setting the socket options\n");
 		}
+		// Each thread has its own socket on the same port
+		if (reuse_port==TRUE && setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(int)) == -1) {
+			ERROR(M_SETSOCKOPT_ERROR, "\nError while setting the socket options\n");
+		}
 
 		// Bind to the socket
 		if (bind(sockfd, p->ai_addr, p->ai_addrlen) == -1) {
@@ -116,148 +218,1886 @@ void create_web_server(char* port, int connections, pthread_t *t_web_server, WEB
 	freeaddrinfo(servinfo);
 
 	// Start listening on the socket
-	if (listen(sockfd, connections) == -1) {
+	if (listen(sockfd, HTTP_LISTEN_BACKLOG) == -1) {
 		ERROR(M_SOCKET_LISTEN_ERROR, "\nThe web server failed to listen\n");
 	}
 
+	return sockfd;
+}
+
+/**
+ * @brief Create a web server to listen on the specified port with maximum simultaneous connections
+ * @param port string with the port number
+ * @param connections integer with the maximum number of simultaneous connections of each thread
+ * @param threads integer with the number of threads to serve the connections
+ * @param web_server_params structure to store the threads params
+ *
+ * @author Brian "Beej Jorgensen" Hall <beej@beej.us>, Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void create_web_server(char* port, int connections, int threads, WEB_SERVER_PARAMS_T *web_server_params){
+	struct epoll_event event;						// To register the sockets on the epoll instances
+	WEB_SERVER_WORKER_T *worker;					// To reference the current worker
+	int a;
+
 	web_server_params->port = port;
-	web_server_params->sockfd = sockfd;
 	web_server_params->shutdown = FALSE;
-	// Create the web server thread
-	if (pthread_create(t_web_server, NULL, web_serve, web_server_params) != 0) {
-		ERROR(M_PTHREAD_CREATE_FAILED, "\nWeb Server thread creation failed.\n");
+	web_server_params->maximum_connections = connections;
+	web_server_params->threads = threads;
+	// The threads need a version of the page to read
+	if(web_server_params->snapshot==NULL){
+		pthread_mutex_lock(web_server_params->mutex);
+		publish_web_snapshot(web_server_params);
+		pthread_mutex_unlock(web_server_params->mutex);
+	}
+	if((web_server_params->workers = calloc(threads, sizeof(WEB_SERVER_WORKER_T)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the web server threads\n");
+	}
+
+	for(a=0; a<threads; a++){
+		worker = &(web_server_params->workers[a]);
+		worker->params = web_server_params;
+		worker->connections = 0;
+		worker->oldest = worker->newest = NULL;
+		worker->streams = NULL;
+		worker->sockfd = create_listening_socket(port, threads>1);
+
+		// Each thread waits for the events of its own sockets
+		if((worker->epollfd = epoll_create1(0)) == -1 || (worker->wakefd = eventfd(0, EFD_NONBLOCK)) == -1){
+			ERROR(M_EPOLL_CREATE_FAILED, "\nFailed to create the web server event queue\n");
+		}
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.ptr = &(worker->sockfd);
+		epoll_ctl(worker->epollfd, EPOLL_CTL_ADD, worker->sockfd, &event);
+		event.data.ptr = &(worker->wakefd);
+		epoll_ctl(worker->epollfd, EPOLL_CTL_ADD, worker->wakefd, &event);
+
+		// Create the web server thread
+		if (pthread_create(&(worker->thread), NULL, web_serve, worker) != 0) {
+			ERROR(M_PTHREAD_CREATE_FAILED, "\nWeb Server thread creation failed.\n");
+		}
 	}
 }
 
 /**
- * @brief Serve the content using the given args
- * @param arg WEB_SERVER_PARAMS_T structure with the thread information
+ * @brief Mark the activity on a connection, moving it to the end of the idle list
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T with the activity
  *
- * @author Brian "Beej Jorgensen" Hall <beej@beej.us>, Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-void *web_serve(void *arg){
-	WEB_SERVER_PARAMS_T *web_server_params = (WEB_SERVER_PARAMS_T *) arg;
-	int new_fd;  													// New connections on new_fd
+static void touch_web_connection(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection){
+	connection->last_activity = monotonic_time_ms();
+	if(worker->newest==connection){
+		return;
+	}
+	// Unlink the connection (if it's already on the list)
+	if(connection->previous!=NULL){
+		connection->previous->next = connection->next;
+	}else if(worker->oldest==connection){
+		worker->oldest = connection->next;
+	}
+	if(connection->next!=NULL){
+		connection->next->previous = connection->previous;
+	}
+	// And append it as the newest
+	connection->previous = worker->newest;
+	connection->next = NULL;
+	if(worker->newest!=NULL){
+		worker->newest->next = connection;
+	}
+	worker->newest = connection;
+	if(worker->oldest==NULL){
+		worker->oldest = connection;
+	}
+}
+
+/**
+ * @brief Close a connection and free its memory
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T to close
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void close_web_connection(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection){
+	if(connection->previous!=NULL){
+		connection->previous->next = connection->next;
+	}else{
+		worker->oldest = connection->next;
+	}
+	if(connection->next!=NULL){
+		connection->next->previous = connection->previous;
+	}else{
+		worker->newest = connection->previous;
+	}
+	if(connection->streaming==TRUE){
+		if(connection->previous_stream!=NULL){
+			connection->previous_stream->next_stream = connection->next_stream;
+		}else{
+			worker->streams = connection->next_stream;
+		}
+		if(connection->next_stream!=NULL){
+			connection->next_stream->previous_stream = connection->previous_stream;
+		}
+	}
+	// Closing the socket also removes it from the epoll instance
+	close(connection->fd);
+	if(connection->response!=NULL){
+		free(connection->response);
+	}
+	if(connection->segments!=NULL){
+		// Release the snapshots of the responses not sent
+		for(; connection->segments_sent<connection->segments_count; connection->segments_sent++){
+			if(connection->segments[connection->segments_sent].snapshot!=NULL){
+				release_web_snapshot(connection->segments[connection->segments_sent].snapshot);
+			}
+		}
+		free(connection->segments);
+	}
+	free(connection);
+	worker->connections--;
+}
+
+/**
+ * @brief Accept all the pending connections of the listening socket
+ * @param worker WEB_SERVER_WORKER_T with the listening socket
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void accept_web_connections(WEB_SERVER_WORKER_T *worker){
 	struct sockaddr_storage their_addr; 							// Connector's address information
 	socklen_t sin_size;												// Connector's address information size
 	char client_address[INET6_ADDRSTRLEN];							// To store a client address
-	char* response = "HTTP/1.0 200 OK\r\n";							// Default HTTP 1.0 response
-	char headers[MAXCHARS];											// To store some HTTP headers
-	char* content=NULL;
-
-	MY_DEBUG("Waiting for connections on port %s...\n", web_server_params->port);
-	sin_size = sizeof(their_addr);
-	while(1) {  // main accept() loop
-		// Lock waiting to accept a connection, and if it fails, loop to accept another one
-		if((new_fd = accept(web_server_params->sockfd, (struct sockaddr *)&their_addr, &sin_size)) == -1) {
-			if(web_server_params->shutdown==TRUE){
-				MY_DEBUG("Got the shutdown signal\n");
-				break;
+	struct epoll_event event;										// To register the connection
+	WEB_CONNECTION_T *connection;
+	int new_fd;  													// New connections on new_fd
+
+	for(;;){
+		sin_size = sizeof(their_addr);
+		if((new_fd = accept4(worker->sockfd, (struct sockaddr *)&their_addr, &sin_size, SOCK_NONBLOCK)) == -1) {
+			if(errno!=EAGAIN && errno!=EWOULDBLOCK && errno!=EINTR){
+				MY_DEBUG("Connection accept failed\n");
 			}
-			MY_DEBUG("Connection accept failed\n");
-			continue;
+			return;
 		}
 
 		inet_ntop(their_addr.ss_family, get_in_addr((struct sockaddr *)&their_addr), client_address, sizeof(client_address));
 		MY_DEBUG("Got a connection from %s\n", client_address);
 
-		// Try to lock the mutex for read
-		if (pthread_mutex_lock(web_server_params->mutex) != 0) {
-			MY_DEBUG("\nWeb Server thread lock failed\n");
-		}else{
-			// If the mutex lock was successful, build some nice HTML content
-			content = update_content(NULL, NULL, "<html><head><title>Show Stats</title></head><body><table border='1'><caption>Show Stats Output:</caption><tr><td>filename</td><td>nlines</td><td>algorithm</td><td>niterations</td><td>nswaps</td><td>time</td></tr>", web_server_params->content, "</table></body></html>");
-			// Update the headers with the content length
-			sprintf(headers, "Content-Type: text/html\r\nContent-Length:%d\r\n\r\n", (int) strlen(content));
-
-			if(write(new_fd, response, strlen(response))==-1){
-				MY_DEBUG("\nFailed to write the HTTP response\n");
-			}else if(write(new_fd, headers, strlen(headers))==-1){
-				MY_DEBUG("\nFailed to write the HTTP headers\n");
-			}else if(write(new_fd, content, strlen(content))==-1){
-				MY_DEBUG("\nFailed to write the HTML content\n");
-			}
-			// Free the used memory for content
-			if(content!=NULL){
-				free(content);
+		// Refuse the connection if this thread is full
+		if(worker->connections>=worker->params->maximum_connections || (connection = malloc(sizeof(WEB_CONNECTION_T)))==NULL){
+			MY_DEBUG("Too many connections, closing the connection from %s\n", client_address);
+			close(new_fd);
+			continue;
+		}
+		connection->fd = new_fd;
+		connection->request_length = 0;
+		connection->response = NULL;
+		connection->response_length = connection->response_capacity = 0;
+		connection->segments = NULL;
+		connection->segments_count = connection->segments_capacity = connection->segments_sent = connection->segment_offset = 0;
+		connection->pending = 0;
+		connection->close_after_response = connection->input_closed = connection->writing = FALSE;
+		connection->streaming = FALSE;
+		connection->previous_stream = connection->next_stream = NULL;
+		connection->previous = connection->next = NULL;
+		worker->connections++;
+		touch_web_connection(worker, connection);
+
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN | EPOLLRDHUP;
+		event.data.ptr = connection;
+		if(epoll_ctl(worker->epollfd, EPOLL_CTL_ADD, new_fd, &event) == -1){
+			close_web_connection(worker, connection);
+		}
+	}
+}
+
+/**
+ * @brief Check if an Accept-Encoding header accepts the gzip coding
+ * @param value of the header (a list of codings, each with an optional quality)
+ * @return integer TRUE if the gzip coding is accepted (with a quality above 0), FALSE otherwise
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int web_accepts_gzip(char* value){
+	char *coding, *parameters, *save;
+	char list[HTTP_MAXIMUM_REQUEST_SIZE+1];
+
+	snprintf(list, sizeof(list), "%s", value);
+	for(coding=strtok_r(list, ",", &save); coding!=NULL; coding=strtok_r(NULL, ",", &save)){
+		coding += strspn(coding, " \t");
+		if((parameters = strchr(coding, ';'))!=NULL){
+			*(parameters++) = '\0';
+		}
+		coding[strcspn(coding, " \t")] = '\0';
+		if(strcasecmp(coding, "gzip")==0 || strcasecmp(coding, "x-gzip")==0){
+			// The q=0 refuses the coding
+			return parameters==NULL || (parameters = strcasestr(parameters, "q="))==NULL || strtod(parameters+2, NULL)>0;
+		}
+	}
+	return FALSE;
+}
+
+/**
+ * @brief Check if an entity tag is on the list of an If-None-Match header
+ * @param list of entity tags of the header (or *)
+ * @param etag to search (with the quotes)
+ * @return integer TRUE if the client has the copy with the entity tag, FALSE otherwise
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int web_etag_matches(char* list, char* etag){
+	int length = strlen(etag);
+
+	while(*list!='\0'){
+		list += strspn(list, " \t,");
+		if(*list=='*'){
+			return TRUE;
+		}
+		// The If-None-Match uses the weak comparison
+		if(strncmp(list, "W/", 2)==0){
+			list += 2;
+		}
+		if(strncmp(list, etag, length)==0 && (list[length]=='\0' || list[length]==',' || list[length]==' ' || list[length]=='\t')){
+			return TRUE;
+		}
+		list += strcspn(list, ",");
+	}
+	return FALSE;
+}
+
+/**
+ * @brief Parse the HTTP request at the beginning of the received bytes
+ *
+ * Only the request line and the headers that change the connection handling (Connection, Content-Length) are used;
+ * the body of the request, if any, is skipped.
+ *
+ * @param data with the received bytes
+ * @param length number of received bytes
+ * @param request WEB_REQUEST_T to store the parsed request
+ * @return integer with the number of bytes of the request (headers and body), 0 if the request is incomplete, -1 if it's malformed or -2 if it's too big
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int parse_web_request(char* data, int length, WEB_REQUEST_T* request){
+	char headers[HTTP_MAXIMUM_REQUEST_SIZE+1];						// Copy of the headers, to split them in lines
+	char *line, *save, *method, *target, *version, *value, *query, *end;
+	long content_length;
+	int start=0, headers_end=0, a;
+
+	// Ignore the empty lines before the request line (some clients add them between pipelined requests)
+	while(start<length && (data[start]=='\r' || data[start]=='\n')){
+		start++;
+	}
+	// The headers end with an empty line
+	for(a=start; a<length && headers_end==0; a++){
+		if(data[a]=='\n'){
+			if(a+1<length && data[a+1]=='\n'){
+				headers_end = a+2;
+			}else if(a+2<length && data[a+1]=='\r' && data[a+2]=='\n'){
+				headers_end = a+3;
 			}
+		}
+	}
+	if(headers_end==0){
+		return 0;
+	}
+	memcpy(headers, data+start, headers_end-start);
+	headers[headers_end-start] = '\0';
+
+	// Request line: method, target and version
+	if((line = strtok_r(headers, "\r\n", &save))==NULL){
+		return -1;
+	}
+	method = strtok_r(line, " ", &end);
+	target = strtok_r(NULL, " ", &end);
+	version = strtok_r(NULL, " ", &end);
+	if(method==NULL || target==NULL || version==NULL || strtok_r(NULL, " ", &end)!=NULL || strlen(method)>HTTP_MAXIMUM_METHOD_SIZE){
+		return -1;
+	}
+	if(strncmp(version, "HTTP/1.", 7)!=0 || version[7]<'0' || version[7]>'9' || version[8]!='\0'){
+		return -1;
+	}
+	strcpy(request->method, method);
+	request->version = version[7]-'0';
+	// Only the HTTP 1.1 connections persist by default
+	request->keep_alive = (request->version>=1);
+	request->content_length = 0;
+	request->last_event_id = -1;
+	request->if_none_match[0] = '\0';
+	request->accept_gzip = FALSE;
+
+	// The absolute form of the target (used with proxies) has the host before the path
+	if(strncasecmp(target, "http://", 7)==0){
+		target = ((target = strchr(target+7, '/'))!=NULL)?target:"/";
+	}
+	if((query = strchr(target, '?'))!=NULL){
+		*(query++) = '\0';
+	}else{
+		query = "";
+	}
+	if(strlen(target)>HTTP_MAXIMUM_PATH_SIZE || strlen(query)>HTTP_MAXIMUM_PATH_SIZE){
+		return -1;
+	}
+	strcpy(request->path, target);
+	strcpy(request->query, query);
 
-			// Unlock the mutex
-			if (pthread_mutex_unlock(web_server_params->mutex) != 0) {
-				MY_DEBUG("\nWeb Server thread unlock failed\n");
+	// Headers
+	while((line = strtok_r(NULL, "\r\n", &save))!=NULL){
+		if((value = strchr(line, ':'))==NULL){
+			return -1;
+		}
+		*(value++) = '\0';
+		value += strspn(value, " \t");
+		if(strcasecmp(line, "Connection")==0){
+			if(strcasestr(value, "close")!=NULL){
+				request->keep_alive = FALSE;
+			}else if(strcasestr(value, "keep-alive")!=NULL){
+				request->keep_alive = TRUE;
+			}
+		}else if(strcasecmp(line, "Content-Length")==0){
+			errno = 0;
+			content_length = strtol(value, &end, 10);
+			if(errno!=0 || end==value || content_length<0){
+				return -1;
+			}
+			if(content_length>HTTP_MAXIMUM_REQUEST_SIZE){
+				return -2;
+			}
+			request->content_length = content_length;
+		}else if(strcasecmp(line, "Last-Event-ID")==0){
+			errno = 0;
+			content_length = strtol(value, &end, 10);
+			request->last_event_id = (errno==0 && end!=value && content_length>=0 && content_length<INT_MAX)?(int) content_length:-1;
+		}else if(strcasecmp(line, "If-None-Match")==0){
+			// A list too long to store is ignored (the full response is sent)
+			if(strlen(value)<=HTTP_MAXIMUM_PATH_SIZE){
+				strcpy(request->if_none_match, value);
 			}
+		}else if(strcasecmp(line, "Accept-Encoding")==0){
+			request->accept_gzip = web_accepts_gzip(value);
+		}else if(strcasecmp(line, "Transfer-Encoding")==0){
+			// Only the bodies with a known length can be skipped
+			return -1;
 		}
-		// The parent doesn't need to send
-		close(new_fd);
 	}
-	return NULL;
+
+	// Wait for the whole body
+	if(headers_end+request->content_length>length){
+		return (headers_end+request->content_length>HTTP_MAXIMUM_REQUEST_SIZE)?-2:0;
+	}
+	return headers_end+request->content_length;
 }
 
 /**
- * @brief Shutdown the web server thread
- * @param t_web_server with the web server thread to shutdown
- * @param web_server_params structure to recover the thread params
+ * @brief Add a part to the responses waiting to be sent on the connection
+ * @param connection WEB_CONNECTION_T with the responses
+ * @param data reference to the bytes (NULL for bytes on the response buffer of the connection)
+ * @param offset position of the bytes on the response buffer of the connection
+ * @param length number of bytes
+ * @return integer TRUE on success, FALSE if the memory allocation failed
  *
  * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-void shutdown_web_server(pthread_t *t_web_server, WEB_SERVER_PARAMS_T *web_server_params){
-	web_server_params->content = update_content(web_server_params, web_server_params->content,"<h1>", "The server is shutting down...", "</h1>");
-	MY_DEBUG("Shutting down the Web Server\n");
-	// Mark the server for shutdown
-	web_server_params->shutdown=TRUE;
-	// Shutdown the socket in both ways
-	shutdown(web_server_params->sockfd, SHUT_RDWR);
-	// Close the listening socket
-	close(web_server_params->sockfd);
-	// Wait for the thread to exit
-	pthread_join(*t_web_server, NULL);
-	// Destroy the mutex
-	if (pthread_mutex_destroy(web_server_params->mutex) != 0) {
-		MY_DEBUG("\npthread_mutex_destroy() failed!\n");
+static int add_web_segment(WEB_CONNECTION_T *connection, const char* data, int offset, int length){
+	WEB_SEGMENT_T* segments, *last;
+	int capacity;
+
+	if(length<=0){
+		return TRUE;
 	}
-	if(web_server_params->content!=NULL){
-		free(web_server_params->content);
+	// Consecutive bytes of the response buffer are sent as a single part
+	last = (connection->segments_count>connection->segments_sent)?&(connection->segments[connection->segments_count-1]):NULL;
+	if(data==NULL && last!=NULL && last->data==NULL && last->offset+last->length==offset){
+		last->length += length;
+		connection->pending += length;
+		return TRUE;
 	}
-	MY_DEBUG("Web Server stopped\n");
+	if(connection->segments_count==connection->segments_capacity){
+		capacity = (connection->segments_capacity>0)?connection->segments_capacity*2:HTTP_WRITE_SEGMENTS;
+		if((segments = realloc(connection->segments, sizeof(WEB_SEGMENT_T)*capacity))==NULL){
+			MY_DEBUG("\nMemory allocation failed for the HTTP response\n");
+			return FALSE;
+		}
+		connection->segments = segments;
+		connection->segments_capacity = capacity;
+	}
+	connection->segments[connection->segments_count].data = data;
+	connection->segments[connection->segments_count].offset = offset;
+	connection->segments[connection->segments_count].length = length;
+	connection->segments[connection->segments_count].snapshot = NULL;
+	connection->segments_count++;
+	connection->pending += length;
+	return TRUE;
+}
+
+/**
+ * @brief Append a copy of the bytes to the responses waiting to be sent on the connection
+ * @param connection WEB_CONNECTION_T with the responses
+ * @param data bytes to append
+ * @param length number of bytes
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int append_web_response(WEB_CONNECTION_T *connection, const char* data, int length){
+	char* response;
+	int capacity;
 
+	// The parts keep the position on the buffer (not the address), so it can be reallocated
+	if(connection->response_length+length>connection->response_capacity){
+		capacity = (connection->response_capacity>0)?connection->response_capacity:MAXCHARS;
+		while(capacity<connection->response_length+length){
+			capacity *= 2;
+		}
+		if((response = realloc(connection->response, capacity))==NULL){
+			MY_DEBUG("\nMemory allocation failed for the HTTP response\n");
+			return FALSE;
+		}
+		connection->response = response;
+		connection->response_capacity = capacity;
+	}
+	memcpy(connection->response+connection->response_length, data, length);
+	connection->response_length += length;
+	return add_web_segment(connection, NULL, connection->response_length-length, length);
 }
 
 /**
- * @brief Build a string with a beginning, a middle and an end
- * @param web_server_params structure to use on the thread lock
- * @param content with the reference to be free'd and appointed to the new string reference
- * @param begin string with the first part of the string
- * @param middle string to put in the middle
- * @param end string to add at the end of the generated string
- * @return a memory reference for the new string
+ * @brief Check if the response to a request has a body
+ * @param request WEB_REQUEST_T answered (NULL for a malformed request)
+ * @return integer TRUE unless it's the answer to a HEAD request
  *
  * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-char* update_content(WEB_SERVER_PARAMS_T *web_server_params, char* content, char* begin, char* middle, char* end){
-	char* aux=NULL, *aux_tmp=NULL;
-	if (web_server_params!=NULL && pthread_mutex_lock(web_server_params->mutex) != 0) {
-		MY_DEBUG("\nWeb Server thread lock failed\n");
+static int web_response_has_body(WEB_REQUEST_T *request){
+	return request==NULL || strcmp(request->method, "HEAD")!=0;
+}
+
+/**
+ * @brief Queue the status line and the headers of an HTTP response on the connection
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T answered (NULL for a malformed request, the connection is closed after the response)
+ * @param status string with the status code and the reason phrase
+ * @param content_type string with the media type of the body
+ * @param extra_headers string with additional headers, each one ending with CRLF (can be NULL)
+ * @param body_length number of bytes of the body (-1 for a body that ends when the connection is closed)
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int queue_web_headers(WEB_CONNECTION_T *connection, WEB_REQUEST_T *request, char* status, char* content_type, char* extra_headers, long body_length){
+	char headers[MAXCHARS];											// To store the status line and the HTTP headers
+	char connection_header[MAXCHARS];
+	char length_header[MAXCHARS]="";
+	int headers_length;
+
+	if(request!=NULL && request->keep_alive){
+		snprintf(connection_header, sizeof(connection_header), "Connection: keep-alive\r\nKeep-Alive: timeout=%d\r\n", HTTP_CONNECTION_TIMEOUT/1000);
+	}else{
+		snprintf(connection_header, sizeof(connection_header), "Connection: close\r\n");
+	}
+	if(body_length>=0){
+		snprintf(length_header, sizeof(length_header), "Content-Length: %ld\r\n", body_length);
+	}
+	headers_length = snprintf(headers, sizeof(headers), "HTTP/1.1 %s\r\nContent-Type: %s\r\n%s%s%s\r\n", status, content_type, length_header, connection_header, (extra_headers!=NULL)?extra_headers:"");
+
+	return append_web_response(connection, headers, headers_length);
+}
+
+/**
+ * @brief Queue an HTTP error response, with a short page describing the status
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T answered (NULL for a malformed request)
+ * @param status string with the status code and the reason phrase
+ * @param extra_headers string with additional headers, each one ending with CRLF (can be NULL)
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int queue_web_error(WEB_CONNECTION_T *connection, WEB_REQUEST_T *request, char* status, char* extra_headers){
+	char body[MAXCHARS];
+	int body_length;
+
+	body_length = snprintf(body, sizeof(body), "<html><head><title>%s</title></head><body><h1>%s</h1></body></html>", status, status);
+	if(queue_web_headers(connection, request, status, "text/html", extra_headers, body_length)==FALSE){
+		return FALSE;
+	}
+	return !web_response_has_body(request) || append_web_response(connection, body, body_length);
+}
+
+/**
+ * Beginning of the page, before the message and the rows
+ */
+static const char page_begin[] = "<html><head><title>Show Stats</title></head><body><table border='1'><caption>Show Stats Output:</caption><tr><td>filename</td><td>nlines</td><td>algorithm</td><td>niterations</td><td>nswaps</td><td>time</td><td>nduplicates</td><td>dedupe_time</td><td>time_saved</td><td>time_uncertainty</td></tr>";
+
+/**
+ * End of the page, after the rows
+ */
+static const char page_end[] = "</table></body></html>";
+
+/**
+ * @brief Compress the page of a snapshot with the gzip format
+ * @param snapshot WEB_SNAPSHOT_T with the page (the compressed copy is stored on it)
+ * @return integer TRUE on success, FALSE if the page couldn't be compressed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int compress_web_page(WEB_SNAPSHOT_T *snapshot){
+	WEB_CONTENT_CHUNK_T *chunk;
+	z_stream stream;
+	char *compressed;
+	int result;
+	uLong bound;
+
+	memset(&stream, 0, sizeof(stream));
+	// The window bits plus 16 select the gzip format
+	if(deflateInit2(&stream, HTTP_GZIP_LEVEL, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY)!=Z_OK){
+		return FALSE;
+	}
+	// The bound of the compressed size, so the whole page is compressed with a single buffer
+	bound = deflateBound(&stream, (sizeof(page_begin)-1)+snapshot->message_length+snapshot->content_length+(sizeof(page_end)-1));
+	if((compressed = malloc(bound))==NULL){
+		deflateEnd(&stream);
+		return FALSE;
+	}
+	stream.next_out = (Bytef*) compressed;
+	stream.avail_out = bound;
+
+	stream.next_in = (Bytef*) page_begin;
+	stream.avail_in = sizeof(page_begin)-1;
+	result = (deflate(&stream, Z_NO_FLUSH)!=Z_STREAM_ERROR);
+	stream.next_in = (Bytef*) snapshot->message;
+	stream.avail_in = snapshot->message_length;
+	result = result && (deflate(&stream, Z_NO_FLUSH)!=Z_STREAM_ERROR);
+	for(chunk=snapshot->first_chunk; chunk!=NULL && result==TRUE; chunk=chunk->next){
+		stream.next_in = (Bytef*) chunk->data;
+		stream.avail_in = (chunk==snapshot->last_chunk)?snapshot->last_length:chunk->length;
+		result = (deflate(&stream, Z_NO_FLUSH)!=Z_STREAM_ERROR);
+		if(chunk==snapshot->last_chunk){
+			break;
+		}
+	}
+	stream.next_in = (Bytef*) page_end;
+	stream.avail_in = sizeof(page_end)-1;
+	result = result && (deflate(&stream, Z_FINISH)==Z_STREAM_END);
+	deflateEnd(&stream);
+	if(result==FALSE){
+		free(compressed);
+		return FALSE;
+	}
+	snapshot->gzip_content = compressed;
+	snapshot->gzip_length = stream.total_out;
+	return TRUE;
+}
+
+/**
+ * @brief Build the response with the gzip compressed copy of the page of a snapshot (compressed once for each snapshot)
+ *
+ * The copy is built by the first request of the snapshot and reused by the next ones. A request that arrives while
+ * another thread compresses the page doesn't wait for it, it gets the uncompressed page instead.
+ *
+ * @param snapshot WEB_SNAPSHOT_T with the page (the reference is given to the response)
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built, -1 if the compressed copy isn't available
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_gzip_web_page(WEB_SNAPSHOT_T *snapshot, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	char etag[64], headers[MAXCHARS];
+	int result;
+
+	// Only one thread compresses the page, the state changes once the copy is complete
+	if(__sync_bool_compare_and_swap(&(snapshot->gzip_state), WEB_GZIP_NONE, WEB_GZIP_BUILDING)){
+		result = compress_web_page(snapshot);
+		__sync_bool_compare_and_swap(&(snapshot->gzip_state), WEB_GZIP_BUILDING, (result==TRUE)?WEB_GZIP_READY:WEB_GZIP_FAILED);
+	}
+	if(__sync_fetch_and_add(&(snapshot->gzip_state), 0)!=WEB_GZIP_READY){
+		return -1;
+	}
+
+	snprintf(etag, sizeof(etag), "\"%ld-gzip\"", snapshot->version);
+	snprintf(headers, sizeof(headers), "Content-Encoding: gzip\r\nETag: %s\r\nVary: Accept-Encoding\r\nCache-Control: no-cache\r\n", etag);
+	if(web_etag_matches(request->if_none_match, etag)){
+		result = queue_web_headers(connection, request, "304 Not Modified", "text/html", headers, -1);
 	}else{
-		aux = merge_strings(aux, begin);
-		aux_tmp = aux;
-		aux = merge_strings(aux, middle);
-		if(aux_tmp!=NULL){
-			free(aux_tmp);
+		result = queue_web_headers(connection, request, "200 OK", "text/html", headers, snapshot->gzip_length);
+		// The compressed copy is sent from the snapshot, that lives until the copy is sent
+		if(result==TRUE && web_response_has_body(request) && (result = add_web_segment(connection, snapshot->gzip_content, 0, snapshot->gzip_length))==TRUE){
+			connection->segments[connection->segments_count-1].snapshot = snapshot;
+			return TRUE;
 		}
-		aux_tmp = aux;
-		aux = merge_strings(aux, end);
-		if(aux_tmp!=NULL){
-			free(aux_tmp);
+	}
+	release_web_snapshot(snapshot);
+	return result;
+}
+
+/**
+ * @brief Build the response with the page (GET /)
+ *
+ * The response is built from the published snapshot of the page, without any lock shared with the writers. A client with
+ * the version of the snapshot (If-None-Match) gets a 304 without the page, and a client that accepts the gzip coding gets
+ * the compressed copy of the snapshot.
+ *
+ * @param web_server_params with the content of the web server
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_web_page(WEB_SERVER_PARAMS_T *web_server_params, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	WEB_SNAPSHOT_T *snapshot = acquire_web_snapshot(web_server_params);
+	WEB_CONTENT_CHUNK_T *chunk;
+	char etag[64], headers[MAXCHARS];
+	int result;
+
+	if(request->accept_gzip==TRUE && (result = build_gzip_web_page(snapshot, connection, request))!=-1){
+		return result;
+	}
+
+	snprintf(etag, sizeof(etag), "\"%ld\"", snapshot->version);
+	snprintf(headers, sizeof(headers), "ETag: %s\r\nVary: Accept-Encoding\r\nCache-Control: no-cache\r\n", etag);
+	if(web_etag_matches(request->if_none_match, etag)){
+		// The client has this version
+		release_web_snapshot(snapshot);
+		return queue_web_headers(connection, request, "304 Not Modified", "text/html", headers, -1);
+	}
+	result = queue_web_headers(connection, request, "200 OK", "text/html", headers, (sizeof(page_begin)-1)+snapshot->message_length+snapshot->content_length+(sizeof(page_end)-1));
+	if(result==FALSE || !web_response_has_body(request)){
+		release_web_snapshot(snapshot);
+		return result;
+	}
+
+	// The bytes are sent from the snapshot and the chunks (the rows appended later aren't part of this response)
+	result = add_web_segment(connection, page_begin, 0, sizeof(page_begin)-1) && add_web_segment(connection, snapshot->message, 0, snapshot->message_length);
+	for(chunk=snapshot->first_chunk; chunk!=NULL && result==TRUE; chunk=chunk->next){
+		result = add_web_segment(connection, chunk->data, 0, (chunk==snapshot->last_chunk)?snapshot->last_length:chunk->length);
+		if(chunk==snapshot->last_chunk){
+			break;
 		}
-		if(content!=NULL){
-			free(content);
-			content = aux;
+	}
+	if(result==FALSE || add_web_segment(connection, page_end, 0, sizeof(page_end)-1)==FALSE){
+		release_web_snapshot(snapshot);
+		return FALSE;
+	}
+	// The last part of the response releases the snapshot
+	connection->segments[connection->segments_count-1].snapshot = snapshot;
+	return TRUE;
+}
+
+/**
+ * @brief Append bytes to a buffer, growing it if needed
+ * @param buffer WEB_BUFFER_T to append
+ * @param data bytes to append
+ * @param length number of bytes
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int web_buffer_append(WEB_BUFFER_T *buffer, const char* data, int length){
+	char* new_data;
+	int capacity;
+
+	if(buffer->length+length>buffer->capacity){
+		capacity = (buffer->capacity>0)?buffer->capacity:MAXCHARS;
+		while(capacity<buffer->length+length){
+			capacity *= 2;
 		}
-		if (web_server_params!=NULL && pthread_mutex_unlock(web_server_params->mutex) != 0) {
-			MY_DEBUG("\nWeb Server thread unlock failed\n");
+		if((new_data = realloc(buffer->data, capacity))==NULL){
+			MY_DEBUG("\nMemory allocation failed for the HTTP response\n");
+			return FALSE;
 		}
+		buffer->data = new_data;
+		buffer->capacity = capacity;
+	}
+	memcpy(buffer->data+buffer->length, data, length);
+	buffer->length += length;
+	return TRUE;
+}
+
+/**
+ * @brief Append a formatted string to a buffer
+ * @param buffer WEB_BUFFER_T to append
+ * @param format of the string (printf style)
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int web_buffer_printf(WEB_BUFFER_T *buffer, const char* format, ...){
+	char text[MAXCHARS];
+	va_list arguments;
+	int length;
+
+	va_start(arguments, format);
+	length = vsnprintf(text, sizeof(text), format, arguments);
+	va_end(arguments);
+	return web_buffer_append(buffer, text, (length<(int) sizeof(text))?length:(int) sizeof(text)-1);
+}
+
+/**
+ * @brief Append a string to a buffer as a JSON string (quoted and escaped)
+ * @param buffer WEB_BUFFER_T to append
+ * @param text string to append
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int web_buffer_append_json_string(WEB_BUFFER_T *buffer, const char* text){
+	char escaped[8];
+	int result, start=0, a;
+
+	result = web_buffer_append(buffer, "\"", 1);
+	for(a=0; text[a]!='\0' && result==TRUE; a++){
+		if(text[a]=='"' || text[a]=='\\' || (unsigned char) text[a]<0x20){
+			// The characters that can't be on a JSON string as they are
+			result = web_buffer_append(buffer, text+start, a-start);
+			snprintf(escaped, sizeof(escaped), (text[a]=='"' || text[a]=='\\')?"\\%c":"\\u%04x", text[a]);
+			result = result && web_buffer_append(buffer, escaped, strlen(escaped));
+			start = a+1;
+		}
+	}
+	return result && web_buffer_append(buffer, text+start, a-start) && web_buffer_append(buffer, "\"", 1);
+}
+
+/**
+ * @brief Get the decoded value of a parameter of the query of a request
+ * @param query string with the query (name=value pairs separated by '&')
+ * @param name of the parameter
+ * @param value to store the decoded value
+ * @param size of the value buffer
+ * @return integer TRUE if the query has the parameter, FALSE otherwise
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int get_query_parameter(char* query, char* name, char* value, int size){
+	char hexadecimal[3]={'\0','\0','\0'};
+	int name_length = strlen(name), a, b;
+
+	while(query!=NULL && *query!='\0'){
+		if(strncmp(query, name, name_length)==0 && query[name_length]=='='){
+			// Decode the %XX and the '+' (space) of the value
+			for(a=name_length+1, b=0; query[a]!='\0' && query[a]!='&' && b<size-1; a++, b++){
+				if(query[a]=='%' && isxdigit((unsigned char) query[a+1]) && isxdigit((unsigned char) query[a+2])){
+					hexadecimal[0] = query[a+1];
+					hexadecimal[1] = query[a+2];
+					value[b] = (char) strtol(hexadecimal, NULL, 16);
+					a += 2;
+				}else{
+					value[b] = (query[a]=='+')?' ':query[a];
+				}
+			}
+			value[b] = '\0';
+			return TRUE;
+		}
+		if((query = strchr(query, '&'))!=NULL){
+			query++;
+		}
+	}
+	return FALSE;
+}
+
+/**
+ * @brief Get a non negative number of the query of a request
+ * @param query of the request
+ * @param name of the parameter
+ * @param value to store the number (unchanged if the query doesn't have the parameter)
+ * @param maximum value of the number (a greater one is reduced to it)
+ * @return integer TRUE on success, FALSE if the parameter isn't a valid number
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int get_query_number(char* query, char* name, long* value, long maximum){
+	char parameter[HTTP_MAXIMUM_PATH_SIZE+1];
+	char* end;
+	long number;
+
+	if(get_query_parameter(query, name, parameter, sizeof(parameter))){
+		errno = 0;
+		number = strtol(parameter, &end, 10);
+		if(errno!=0 || end==parameter || *end!='\0' || number<0){
+			return FALSE;
+		}
+		*value = (number>maximum)?maximum:number;
+	}
+	return TRUE;
+}
+
+/**
+ * @brief Append a text to a buffer, escaped for HTML
+ * @param buffer WEB_BUFFER_T to append
+ * @param text to escape
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int web_buffer_append_html(WEB_BUFFER_T *buffer, const char* text){
+	int result=TRUE, start=0, a;
+	char* entity;
+
+	for(a=0; text[a]!='\0' && result==TRUE; a++){
+		switch(text[a]){
+			case '&': entity = "&amp;"; break;
+			case '<': entity = "&lt;"; break;
+			case '>': entity = "&gt;"; break;
+			case '"': entity = "&quot;"; break;
+			case '\'': entity = "&#39;"; break;
+			default: entity = NULL;
+		}
+		if(entity!=NULL){
+			result = web_buffer_append(buffer, text+start, a-start) && web_buffer_append(buffer, entity, strlen(entity));
+			start = a+1;
+		}
+	}
+	return result && web_buffer_append(buffer, text+start, a-start);
+}
+
+/**
+ * @brief Append a row of the stats store to a buffer as a JSON object
+ * @param buffer WEB_BUFFER_T to append
+ * @param index of the row
+ * @param row ALGORITHM_STAT_T with the values of the row
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int web_buffer_append_json_result(WEB_BUFFER_T *buffer, int index, ALGORITHM_STAT_T* row){
+	return web_buffer_printf(buffer, "{\"index\":%d,\"filename\":", index)
+		&& web_buffer_append_json_string(buffer, row->filename)
+		&& web_buffer_printf(buffer, ",\"nlines\":%d,\"algorithm\":", row->nlines)
+		&& web_buffer_append_json_string(buffer, row->algorithm)
+		&& web_buffer_printf(buffer, ",\"niterations\":%d,\"nswaps\":%d,\"time\":%.6f,\"nbytes\":%ld,\"nduplicates\":%d,\"dedupe_time\":%.6f,\"time_saved\":%.0f,\"time_uncertainty\":%.3f}",
+			row->niterations, row->nswaps, isfinite(row->time)?row->time:0, row->nbytes, row->nduplicates, isfinite(row->dedupe_time)?row->dedupe_time:0, isfinite(row->time_saved)?row->time_saved:0, isfinite(row->time_uncertainty)?row->time_uncertainty:0);
+}
+
+/**
+ * @brief Append a row of the stats store to the results of the JSON API (STORE_ROW_FUNC)
+ * @param index of the row
+ * @param row ALGORITHM_STAT_T with the values of the row
+ * @param data WEB_BUFFER_T with the response
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int append_json_result(int index, ALGORITHM_STAT_T* row, void* data){
+	WEB_BUFFER_T *buffer = (WEB_BUFFER_T *) data;
+
+	// The first result follows the opening of the array
+	return (buffer->data[buffer->length-1]=='[' || web_buffer_append(buffer, ",", 1)) && web_buffer_append_json_result(buffer, index, row);
+}
+
+/**
+ * @brief Append a row of the stats store as a server-sent event (STORE_ROW_FUNC)
+ * @param index of the row (the id of the event, so a client can resume with the Last-Event-ID)
+ * @param row ALGORITHM_STAT_T with the values of the row
+ * @param data WEB_BUFFER_T with the events
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int append_stream_event(int index, ALGORITHM_STAT_T* row, void* data){
+	WEB_BUFFER_T *buffer = (WEB_BUFFER_T *) data;
+
+	return web_buffer_printf(buffer, "id: %d\nevent: result\ndata: ", index) && web_buffer_append_json_result(buffer, index, row) && web_buffer_append(buffer, "\n\n", 2);
+}
+
+/**
+ * @brief Build the response of the JSON API with the results (GET /api/results)
+ *
+ * The query selects the results: since (index of the first result, to get only the new ones), limit (maximum
+ * number of results), algorithm and filename (only the results with the given value). The response has the
+ * index to use as since on the next request (next) and if there are more results available now (more).
+ *
+ * @param web_server_params with the common data of the web server
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_api_response(WEB_SERVER_PARAMS_T *web_server_params, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	char algorithm[HTTP_MAXIMUM_PATH_SIZE+1], filename[HTTP_MAXIMUM_PATH_SIZE+1];
+	WEB_BUFFER_T buffer = {NULL, 0, 0};
+	long since=0, limit=HTTP_API_DEFAULT_LIMIT;
+	int total, next, result;
+
+	if(!get_query_number(request->query, "since", &since, INT_MAX) || !get_query_number(request->query, "limit", &limit, HTTP_API_MAXIMUM_LIMIT)){
+		return queue_web_error(connection, request, "400 Bad Request", NULL);
+	}
+
+	result = web_buffer_append(&buffer, "{\"results\":[", strlen("{\"results\":["));
+	if(result==TRUE){
+		next = store_select(web_server_params->store, since, get_query_parameter(request->query, "algorithm", algorithm, sizeof(algorithm))?algorithm:NULL,
+			get_query_parameter(request->query, "filename", filename, sizeof(filename))?filename:NULL, limit, append_json_result, &buffer, &total);
+		result = (next!=-1) && web_buffer_printf(&buffer, "],\"since\":%ld,\"next\":%d,\"more\":%s,\"total\":%d}", since, next, (next<total)?"true":"false", total);
+	}
+	if(result==TRUE){
+		result = queue_web_headers(connection, request, "200 OK", "application/json", NULL, buffer.length);
+		if(result==TRUE && web_response_has_body(request)){
+			result = append_web_response(connection, buffer.data, buffer.length);
+		}
+	}
+	free(buffer.data);
+	return result;
+}
+
+/**
+ * @brief Escape a text to a label value of the Prometheus text format
+ * @param text to escape
+ * @param label to store the escaped text
+ * @param size of the label (the text is truncated to fit)
+ * @return the label
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static char* escape_metrics_label(const char* text, char* label, int size){
+	int length=0;
+
+	for(; *text!='\0' && length<size-2; text++){
+		if(*text=='\\' || *text=='"' || *text=='\n'){
+			label[length++] = '\\';
+			label[length++] = (*text=='\n')?'n':*text;
+		}else{
+			label[length++] = *text;
+		}
+	}
+	label[length] = '\0';
+	return label;
+}
+
+/**
+ * @brief Append a counter of each algorithm in the Prometheus text format
+ * @param buffer WEB_BUFFER_T with the response
+ * @param metrics STORE_METRICS_T of each algorithm
+ * @param count number of algorithms
+ * @param name of the counter
+ * @param help description of the counter
+ * @param offset of the counter (long long) on the STORE_METRICS_T
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int append_metrics_counter(WEB_BUFFER_T *buffer, STORE_METRICS_T *metrics, int count, char* name, char* help, size_t offset){
+	char label[MAXCHARS*2];
+	int a;
+
+	if(web_buffer_printf(buffer, "# HELP %s %s\n# TYPE %s counter\n", name, help, name)==FALSE){
+		return FALSE;
+	}
+	for(a=0; a<count; a++){
+		if(web_buffer_printf(buffer, "%s{algorithm=\"%s\"} %lld\n", name, escape_metrics_label(metrics[a].algorithm, label, sizeof(label)), *((long long*) (((char*) &(metrics[a]))+offset)))==FALSE){
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * @brief Append a histogram of each algorithm in the Prometheus text format
+ * @param buffer WEB_BUFFER_T with the response
+ * @param metrics STORE_METRICS_T of each algorithm
+ * @param count number of algorithms
+ * @param name of the histogram
+ * @param help description of the histogram
+ * @param offset of the histogram (STORE_HISTOGRAM_T) on the STORE_METRICS_T
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int append_metrics_histogram(WEB_BUFFER_T *buffer, STORE_METRICS_T *metrics, int count, char* name, char* help, size_t offset){
+	STORE_HISTOGRAM_T *histogram;
+	char label[MAXCHARS*2];
+	long cumulative;
+	int a, bucket;
+
+	if(web_buffer_printf(buffer, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name)==FALSE){
+		return FALSE;
+	}
+	for(a=0; a<count; a++){
+		histogram = (STORE_HISTOGRAM_T*) (((char*) &(metrics[a]))+offset);
+		escape_metrics_label(metrics[a].algorithm, label, sizeof(label));
+		// The buckets of the exposition format are cumulative
+		for(bucket=0, cumulative=0; bucket<STORE_HISTOGRAM_BUCKETS; bucket++){
+			cumulative += histogram->buckets[bucket];
+			if(web_buffer_printf(buffer, "%s_bucket{algorithm=\"%s\",le=\"%g\"} %ld\n", name, label, store_histogram_bound(histogram, bucket), cumulative)==FALSE){
+				return FALSE;
+			}
+		}
+		if(web_buffer_printf(buffer, "%s_bucket{algorithm=\"%s\",le=\"+Inf\"} %ld\n%s_sum{algorithm=\"%s\"} %.9g\n%s_count{algorithm=\"%s\"} %ld\n",
+				name, label, histogram->count, name, label, isfinite(histogram->sum)?histogram->sum:0, name, label, histogram->count)==FALSE){
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * @brief Build the response with the aggregated measures of each algorithm, in the Prometheus text format (GET /metrics)
+ *
+ * The measures are updated by the store as the results arrive, so a scrape costs the same with any number of results.
+ *
+ * @param web_server_params with the common data of the web server
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_metrics_response(WEB_SERVER_PARAMS_T *web_server_params, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	WEB_BUFFER_T buffer = {NULL, 0, 0};
+	STORE_METRICS_T *metrics;
+	int count, result;
+
+	metrics = store_copy_metrics(web_server_params->store, &count);
+	result = web_buffer_printf(&buffer, "# HELP showstats_results Number of results received from the sorter.\n# TYPE showstats_results gauge\nshowstats_results %d\n", store_count(web_server_params->store))
+		&& append_metrics_counter(&buffer, metrics, count, "sorter_sorts_total", "Number of sorts.", offsetof(STORE_METRICS_T, count))
+		&& append_metrics_counter(&buffer, metrics, count, "sorter_lines_total", "Number of lines sorted.", offsetof(STORE_METRICS_T, nlines))
+		&& append_metrics_counter(&buffer, metrics, count, "sorter_bytes_total", "Number of bytes of the sorted files.", offsetof(STORE_METRICS_T, nbytes))
+		&& append_metrics_counter(&buffer, metrics, count, "sorter_comparisons_total", "Number of iterations (comparisons) of the sorts.", offsetof(STORE_METRICS_T, niterations))
+		&& append_metrics_counter(&buffer, metrics, count, "sorter_swaps_total", "Number of swaps of the sorts.", offsetof(STORE_METRICS_T, nswaps))
+		&& append_metrics_counter(&buffer, metrics, count, "sorter_duplicates_total", "Number of duplicated lines removed before the sorts.", offsetof(STORE_METRICS_T, nduplicates))
+		&& append_metrics_histogram(&buffer, metrics, count, "sorter_sort_duration_seconds", "Time of each sort.", offsetof(STORE_METRICS_T, duration))
+		&& append_metrics_histogram(&buffer, metrics, count, "sorter_sort_lines_per_second", "Lines sorted per second of each sort (only the sorts with a measurable time).", offsetof(STORE_METRICS_T, throughput))
+		&& append_metrics_histogram(&buffer, metrics, count, "sorter_sort_comparisons", "Number of iterations (comparisons) of each sort.", offsetof(STORE_METRICS_T, iterations))
+		&& append_metrics_histogram(&buffer, metrics, count, "sorter_sort_swaps", "Number of swaps of each sort.", offsetof(STORE_METRICS_T, swaps))
+		&& append_metrics_histogram(&buffer, metrics, count, "sorter_sort_bytes", "Number of bytes of the file of each sort.", offsetof(STORE_METRICS_T, bytes));
+	if(result==TRUE){
+		result = queue_web_headers(connection, request, "200 OK", "text/plain; version=0.0.4; charset=utf-8", "Cache-Control: no-cache\r\n", buffer.length);
+		if(result==TRUE && web_response_has_body(request)){
+			result = append_web_response(connection, buffer.data, buffer.length);
+		}
+	}
+	free(buffer.data);
+	free(metrics);
+	return result;
+}
+
+/**
+ * @brief Compare the aggregated measures of two algorithms by the mean time
+ * @param a STORE_METRICS_T to compare with the next parameter
+ * @param b STORE_METRICS_T to compare with the previous parameter
+ * @return integer lower than 0 if a is faster than b, 0 if they are equal, greater than 0 otherwise
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int compare_metrics_mean_time(const void* a, const void* b){
+	double mean_a = ((STORE_METRICS_T*) a)->time/((STORE_METRICS_T*) a)->count, mean_b = ((STORE_METRICS_T*) b)->time/((STORE_METRICS_T*) b)->count;
+
+	return (mean_a > mean_b) - (mean_a < mean_b);
+}
+
+/**
+ * @brief Get the aggregated measures of each algorithm, ranked by the mean time, and the baseline of the speedups
+ * @param web_server_params with the common data of the web server
+ * @param baseline name of the algorithm of reference (NULL or unknown for the first algorithm received)
+ * @param count to store the number of algorithms
+ * @param baseline_name to store the name of the algorithm of reference (owned by the store)
+ * @param baseline_mean to store the mean time (ms) of the algorithm of reference
+ * @return STORE_METRICS_T pointer with the measures, by rank (to free by the caller), NULL if there are none
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static STORE_METRICS_T* get_ranked_metrics(WEB_SERVER_PARAMS_T *web_server_params, char* baseline, int* count, char** baseline_name, double* baseline_mean){
+	STORE_METRICS_T *metrics;
+	int a, reference=0;
+
+	// The measures are maintained by the store on each result, so this only copies one record for each algorithm
+	if((metrics = store_copy_metrics(web_server_params->store, count))==NULL){
+		*baseline_name = NULL;
+		*baseline_mean = 0;
+		return NULL;
+	}
+	for(a=0; baseline!=NULL && a<*count; a++){
+		if(strcmp(metrics[a].algorithm, baseline)==0){
+			reference = a;
+		}
+	}
+	*baseline_name = metrics[reference].algorithm;
+	*baseline_mean = metrics[reference].time/metrics[reference].count;
+	qsort(metrics, *count, sizeof(STORE_METRICS_T), compare_metrics_mean_time);
+	return metrics;
+}
+
+/**
+ * @brief Build the response with the aggregated measures of each algorithm, ranked by the mean time (GET /api/aggregates)
+ *
+ * The query may give the algorithm of reference of the speedups (baseline), by default the first algorithm received.
+ *
+ * @param web_server_params with the common data of the web server
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_aggregates_response(WEB_SERVER_PARAMS_T *web_server_params, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	char baseline[HTTP_MAXIMUM_PATH_SIZE+1];
+	WEB_BUFFER_T buffer = {NULL, 0, 0};
+	STORE_METRICS_T *metrics;
+	double baseline_mean=0, mean;
+	int count, result, a;
+	char* name;
+
+	metrics = get_ranked_metrics(web_server_params, get_query_parameter(request->query, "baseline", baseline, sizeof(baseline))?baseline:NULL, &count, &name, &baseline_mean);
+	result = web_buffer_append(&buffer, "{\"baseline\":", strlen("{\"baseline\":"))
+		&& ((name!=NULL)?web_buffer_append_json_string(&buffer, name):web_buffer_append(&buffer, "null", 4))
+		&& web_buffer_append(&buffer, ",\"algorithms\":[", strlen(",\"algorithms\":["));
+	for(a=0; a<count && result==TRUE; a++){
+		mean = metrics[a].time/metrics[a].count;
+		result = web_buffer_printf(&buffer, "%s{\"rank\":%d,\"algorithm\":", (a>0)?",":"", a+1)
+			&& web_buffer_append_json_string(&buffer, metrics[a].algorithm)
+			&& web_buffer_printf(&buffer, ",\"count\":%lld,\"mean_time\":%.3f,\"median_time\":%.3f,\"p95_time\":%.3f,\"lines_per_second\":%.0f,\"speedup\":",
+				metrics[a].count, mean, store_quantile_value(&(metrics[a].quantiles), 0.5), store_quantile_value(&(metrics[a].quantiles), 0.95), (metrics[a].time>0)?metrics[a].nlines/(metrics[a].time/1000):0)
+			&& ((mean>0)?web_buffer_printf(&buffer, "%.3f", baseline_mean/mean):web_buffer_append(&buffer, "null", 4))
+			&& web_buffer_printf(&buffer, ",\"wins\":%lld}", metrics[a].wins);
+	}
+	result = result && web_buffer_append(&buffer, "]}", 2);
+	free(metrics);
+	if(result==TRUE){
+		result = queue_web_headers(connection, request, "200 OK", "application/json", NULL, buffer.length);
+		if(result==TRUE && web_response_has_body(request)){
+			result = append_web_response(connection, buffer.data, buffer.length);
+		}
+	}
+	free(buffer.data);
+	return result;
+}
+
+/**
+ * @brief Append the fastest algorithm of a file to the JSON API response (STORE_WINNER_FUNC)
+ * @param index of the file
+ * @param filename of the file
+ * @param algorithm fastest for the file
+ * @param time of the fastest algorithm
+ * @param results number of results of the file
+ * @param data WEB_BUFFER_T with the response
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int append_json_winner(int index, char* filename, char* algorithm, double time, int results, void* data){
+	WEB_BUFFER_T *buffer = (WEB_BUFFER_T *) data;
+
+	return (buffer->data[buffer->length-1]=='[' || web_buffer_append(buffer, ",", 1))
+		&& web_buffer_printf(buffer, "{\"index\":%d,\"filename\":", index) && web_buffer_append_json_string(buffer, filename)
+		&& web_buffer_append(buffer, ",\"algorithm\":", strlen(",\"algorithm\":")) && web_buffer_append_json_string(buffer, algorithm)
+		&& web_buffer_printf(buffer, ",\"time\":%.6f,\"results\":%d}", isfinite(time)?time:0, results);
+}
+
+/**
+ * @brief Build the response with the fastest algorithm of each file (GET /api/winners)
+ *
+ * The query selects the files like the results of the JSON API: since (index of the first file) and limit.
+ *
+ * @param web_server_params with the common data of the web server
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_winners_response(WEB_SERVER_PARAMS_T *web_server_params, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	WEB_BUFFER_T buffer = {NULL, 0, 0};
+	long since=0, limit=HTTP_API_DEFAULT_LIMIT;
+	int total, next, result;
+
+	if(!get_query_number(request->query, "since", &since, INT_MAX) || !get_query_number(request->query, "limit", &limit, HTTP_API_MAXIMUM_LIMIT)){
+		return queue_web_error(connection, request, "400 Bad Request", NULL);
+	}
+	result = web_buffer_append(&buffer, "{\"files\":[", strlen("{\"files\":["));
+	if(result==TRUE){
+		next = store_select_winners(web_server_params->store, since, limit, append_json_winner, &buffer, &total);
+		result = (next!=-1) && web_buffer_printf(&buffer, "],\"since\":%ld,\"next\":%d,\"more\":%s,\"total\":%d}", since, next, (next<total)?"true":"false", total);
+	}
+	if(result==TRUE){
+		result = queue_web_headers(connection, request, "200 OK", "application/json", NULL, buffer.length);
+		if(result==TRUE && web_response_has_body(request)){
+			result = append_web_response(connection, buffer.data, buffer.length);
+		}
+	}
+	free(buffer.data);
+	return result;
+}
+
+/**
+ * @brief Append the fastest algorithm of a file as a row of the HTML table (STORE_WINNER_FUNC)
+ * @param index of the file
+ * @param filename of the file
+ * @param algorithm fastest for the file
+ * @param time of the fastest algorithm
+ * @param results number of results of the file
+ * @param data WEB_BUFFER_T with the page
+ * @return integer TRUE on success, FALSE if the memory allocation failed
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int append_html_winner(int index, char* filename, char* algorithm, double time, int results, void* data){
+	WEB_BUFFER_T *buffer = (WEB_BUFFER_T *) data;
+
+	return web_buffer_printf(buffer, "<tr><td>%d</td><td>", index) && web_buffer_append_html(buffer, filename)
+		&& web_buffer_append(buffer, "</td><td>", strlen("</td><td>")) && web_buffer_append_html(buffer, algorithm)
+		&& web_buffer_printf(buffer, "</td><td>%.0f</td><td>%d</td></tr>", isfinite(time)?time:0, results);
+}
+
+/**
+ * @brief Build the page with the ranking of the algorithms and the fastest algorithm of each file (GET /aggregates)
+ *
+ * The query has the same parameters of the JSON API: baseline (of the speedups), since and limit (of the files).
+ *
+ * @param web_server_params with the common data of the web server
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_aggregates_page(WEB_SERVER_PARAMS_T *web_server_params, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	char baseline[HTTP_MAXIMUM_PATH_SIZE+1];
+	WEB_BUFFER_T buffer = {NULL, 0, 0};
+	STORE_METRICS_T *metrics;
+	long since=0, limit=HTTP_API_DEFAULT_LIMIT;
+	double baseline_mean=0, mean;
+	int count, total, next, result, a;
+	char* name;
+
+	if(!get_query_number(request->query, "since", &since, INT_MAX) || !get_query_number(request->query, "limit", &limit, HTTP_API_MAXIMUM_LIMIT)){
+		return queue_web_error(connection, request, "400 Bad Request", NULL);
+	}
+	metrics = get_ranked_metrics(web_server_params, get_query_parameter(request->query, "baseline", baseline, sizeof(baseline))?baseline:NULL, &count, &name, &baseline_mean);
+	result = web_buffer_printf(&buffer, "<html><head><title>Show Stats</title></head><body><table border='1'><caption>Ranking of the algorithms (speedup against ")
+		&& web_buffer_append_html(&buffer, (name!=NULL)?name:"-")
+		&& web_buffer_printf(&buffer, "):</caption><tr><td>rank</td><td>algorithm</td><td>sorts</td><td>mean time</td><td>median time</td><td>p95 time</td><td>lines/s</td><td>speedup</td><td>wins</td></tr>");
+	for(a=0; a<count && result==TRUE; a++){
+		mean = metrics[a].time/metrics[a].count;
+		result = web_buffer_printf(&buffer, "<tr><td>%d</td><td>", a+1) && web_buffer_append_html(&buffer, metrics[a].algorithm)
+			&& web_buffer_printf(&buffer, "</td><td>%lld</td><td>%.3f</td><td>%.3f</td><td>%.3f</td><td>%.0f</td>", metrics[a].count, mean,
+				store_quantile_value(&(metrics[a].quantiles), 0.5), store_quantile_value(&(metrics[a].quantiles), 0.95), (metrics[a].time>0)?metrics[a].nlines/(metrics[a].time/1000):0)
+			&& ((mean>0)?web_buffer_printf(&buffer, "<td>%.2f</td>", baseline_mean/mean):web_buffer_append(&buffer, "<td>-</td>", strlen("<td>-</td>")))
+			&& web_buffer_printf(&buffer, "<td>%lld</td></tr>", metrics[a].wins);
+	}
+	free(metrics);
+	result = result && web_buffer_printf(&buffer, "</table><br/><table border='1'><caption>Fastest algorithm of each file:</caption><tr><td>index</td><td>filename</td><td>algorithm</td><td>time</td><td>results</td></tr>");
+	if(result==TRUE){
+		next = store_select_winners(web_server_params->store, since, limit, append_html_winner, &buffer, &total);
+		result = (next!=-1) && web_buffer_printf(&buffer, "</table>%s</body></html>", (next<total)?"<p>More files available (use the since and limit parameters).</p>":"");
+	}
+	if(result==TRUE){
+		result = queue_web_headers(connection, request, "200 OK", "text/html", "Cache-Control: no-cache\r\n", buffer.length);
+		if(result==TRUE && web_response_has_body(request)){
+			result = append_web_response(connection, buffer.data, buffer.length);
+		}
+	}
+	free(buffer.data);
+	return result;
+}
+
+/**
+ * @brief Start sending the results to the connection as server-sent events (GET /events)
+ *
+ * The stream starts at the result given by the query (since), after the last event received by the client
+ * (Last-Event-ID, when the client reconnects) or, by default, at the next new result.
+ *
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T to stream
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int start_web_stream(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	char parameter[HTTP_MAXIMUM_PATH_SIZE+1];
+	char* end;
+	long since;
+	int count = store_count(worker->params->store);
+
+	if(get_query_parameter(request->query, "since", parameter, sizeof(parameter))){
+		since = strtol(parameter, &end, 10);
+		if(end==parameter || *end!='\0' || since<0){
+			return queue_web_error(connection, request, "400 Bad Request", NULL);
+		}
+	}else if(request->last_event_id>=0){
+		since = request->last_event_id+1;
+	}else{
+		since = count;
+	}
+
+	if(queue_web_headers(connection, request, "200 OK", "text/event-stream", "Cache-Control: no-cache\r\n", -1)==FALSE){
+		return FALSE;
+	}
+	if(!web_response_has_body(request)){
+		return TRUE;
+	}
+	connection->streaming = TRUE;
+	connection->stream_index = (since<count)?(int) since:count;
+	// Add it to the streams of the thread, to be woken by the new results
+	connection->previous_stream = NULL;
+	connection->next_stream = worker->streams;
+	if(worker->streams!=NULL){
+		worker->streams->previous_stream = connection;
+	}
+	worker->streams = connection;
+	return TRUE;
+}
+
+/**
+ * @brief Queue the results not sent yet to a streaming connection as events
+ *
+ * Nothing is queued while the events waiting to be sent are over HTTP_MAXIMUM_PENDING_RESPONSE: the results stay
+ * on the store, so the backlog of a slow client is bounded (and a client that stops reading expires).
+ *
+ * @param web_server_params with the common data of the web server
+ * @param connection WEB_CONNECTION_T streaming
+ * @return integer with the number of events queued, -1 if they couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int stream_web_results(WEB_SERVER_PARAMS_T *web_server_params, WEB_CONNECTION_T *connection){
+	WEB_BUFFER_T buffer = {NULL, 0, 0};
+	int total, next, queued;
+
+	if(connection->pending>=HTTP_MAXIMUM_PENDING_RESPONSE){
+		return 0;
+	}
+	next = store_select(web_server_params->store, connection->stream_index, NULL, NULL, HTTP_STREAM_BATCH, append_stream_event, &buffer, &total);
+	if(next==-1 || (buffer.length>0 && append_web_response(connection, buffer.data, buffer.length)==FALSE)){
+		free(buffer.data);
+		return -1;
+	}
+	free(buffer.data);
+	queued = next-connection->stream_index;
+	connection->stream_index = next;
+	return queued;
+}
+
+/**
+ * @brief Build the HTTP response to a request
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T to store the response
+ * @param request WEB_REQUEST_T to answer
+ * @return integer TRUE on success, FALSE if the response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int build_web_response(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection, WEB_REQUEST_T *request){
+	WEB_SERVER_PARAMS_T *web_server_params = worker->params;
+
+	if(strcmp(request->method, "GET")!=0 && strcmp(request->method, "HEAD")!=0){
+		return queue_web_error(connection, request, "405 Method Not Allowed", "Allow: GET, HEAD\r\n");
+	}
+	if(strcmp(request->path, "/")==0 || strcmp(request->path, "/index.html")==0){
+		return build_web_page(web_server_params, connection, request);
+	}
+	if(strcmp(request->path, "/api/results")==0){
+		return build_api_response(web_server_params, connection, request);
+	}
+	if(strcmp(request->path, "/aggregates")==0){
+		return build_aggregates_page(web_server_params, connection, request);
+	}
+	if(strcmp(request->path, "/api/aggregates")==0){
+		return build_aggregates_response(web_server_params, connection, request);
+	}
+	if(strcmp(request->path, "/api/winners")==0){
+		return build_winners_response(web_server_params, connection, request);
+	}
+	if(strcmp(request->path, "/metrics")==0){
+		return build_metrics_response(web_server_params, connection, request);
+	}
+	if(strcmp(request->path, "/events")==0){
+		return start_web_stream(worker, connection, request);
+	}
+	return queue_web_error(connection, request, "404 Not Found", NULL);
+}
+
+/**
+ * @brief Answer the complete requests received on the connection, in order (pipelining)
+ *
+ * Stops when the responses waiting to be sent are over HTTP_MAXIMUM_PENDING_RESPONSE, so a client that doesn't read
+ * can't make the server buffer an unbounded number of responses. A streaming connection gets the new results instead.
+ *
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T with the received requests
+ * @return integer with the number of answered requests (or queued events), -1 if a response couldn't be built
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int process_web_requests(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection){
+	WEB_REQUEST_T request;
+	int answered=0, request_size, result;
+
+	if(connection->streaming==TRUE){
+		// The stream is the last response of the connection: the client can only close it
+		connection->request_length = 0;
+		return stream_web_results(worker->params, connection);
+	}
+	while(connection->close_after_response!=TRUE && connection->pending<HTTP_MAXIMUM_PENDING_RESPONSE){
+		request_size = parse_web_request(connection->request, connection->request_length, &request);
+		if(request_size==0 && connection->request_length<HTTP_MAXIMUM_REQUEST_SIZE){
+			// Wait for the rest of the request
+			break;
+		}
+		if(request_size>0){
+			result = build_web_response(worker, connection, &request);
+			if(request.keep_alive!=TRUE && connection->streaming!=TRUE){
+				connection->close_after_response = TRUE;
+			}
+			// Keep the next pipelined requests
+			connection->request_length -= request_size;
+			memmove(connection->request, connection->request+request_size, connection->request_length);
+		}else{
+			// The rest of the received bytes can't be trusted: answer with the error and close the connection
+			if(request_size==0){
+				MY_DEBUG("\nThe HTTP request headers are too big\n");
+				result = queue_web_error(connection, NULL, "431 Request Header Fields Too Large", NULL);
+			}else if(request_size==-2){
+				MY_DEBUG("\nThe HTTP request is too big\n");
+				result = queue_web_error(connection, NULL, "413 Payload Too Large", NULL);
+			}else{
+				MY_DEBUG("\nMalformed HTTP request\n");
+				result = queue_web_error(connection, NULL, "400 Bad Request", NULL);
+			}
+			connection->close_after_response = TRUE;
+			connection->request_length = 0;
+		}
+		connection->request[connection->request_length] = '\0';
+		if(result==FALSE){
+			return -1;
+		}
+		answered++;
+		if(connection->streaming==TRUE){
+			// Send the results since the requested one
+			connection->request_length = 0;
+			return (result = stream_web_results(worker->params, connection))==-1?-1:answered+result;
+		}
+	}
+	return answered;
+}
+
+/**
+ * @brief Change the events of the connection on the epoll instance
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T to change
+ * @param writing TRUE to wait for room on the socket to send the responses, FALSE to wait for requests
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void watch_web_connection(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection, int writing){
+	struct epoll_event event;
+
+	if(connection->writing==writing){
+		return;
+	}
+	memset(&event, 0, sizeof(event));
+	// While the responses are pending the requests aren't read, so a pipelining client is slowed down by the socket
+	event.events = (writing==TRUE)?EPOLLOUT:(EPOLLIN | EPOLLRDHUP);
+	event.data.ptr = connection;
+	epoll_ctl(worker->epollfd, EPOLL_CTL_MOD, connection->fd, &event);
+	connection->writing = writing;
+}
+
+/**
+ * @brief Send as much of the responses as the socket accepts, with scatter-gather writes
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T with the responses
+ * @return integer 1 if all the responses were sent, 0 if the socket is full, -1 on error
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int write_web_response(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection){
+	struct iovec parts[HTTP_WRITE_SEGMENTS];
+	struct msghdr message;
+	WEB_SEGMENT_T *segment;
+	ssize_t sent;
+	int a, count, skip;
+
+	while(connection->segments_sent<connection->segments_count){
+		// The next parts, without the bytes of the first one already sent
+		for(a=connection->segments_sent, count=0; a<connection->segments_count && count<HTTP_WRITE_SEGMENTS; a++, count++){
+			segment = &(connection->segments[a]);
+			skip = (count==0)?connection->segment_offset:0;
+			parts[count].iov_base = (char*) ((segment->data!=NULL)?segment->data:connection->response+segment->offset)+skip;
+			parts[count].iov_len = segment->length-skip;
+		}
+		memset(&message, 0, sizeof(message));
+		message.msg_iov = parts;
+		message.msg_iovlen = count;
+		sent = sendmsg(connection->fd, &message, MSG_NOSIGNAL);
+		if(sent==-1){
+			if(errno==EINTR){
+				continue;
+			}
+			if(errno==EAGAIN || errno==EWOULDBLOCK){
+				// The socket buffer is full: wait until the client reads some data
+				watch_web_connection(worker, connection, TRUE);
+				return 0;
+			}
+			MY_DEBUG("\nFailed to write the HTTP response\n");
+			return -1;
+		}
+		connection->pending -= sent;
+		// Skip the parts sent
+		while(sent>0){
+			segment = &(connection->segments[connection->segments_sent]);
+			if(sent>=segment->length-connection->segment_offset){
+				sent -= segment->length-connection->segment_offset;
+				if(segment->snapshot!=NULL){
+					// The response doesn't need the snapshot anymore
+					release_web_snapshot(segment->snapshot);
+					segment->snapshot = NULL;
+				}
+				connection->segments_sent++;
+				connection->segment_offset = 0;
+			}else{
+				connection->segment_offset += sent;
+				sent = 0;
+			}
+		}
+		touch_web_connection(worker, connection);
+	}
+	// Reuse the buffers for the next responses
+	connection->response_length = 0;
+	connection->segments_count = connection->segments_sent = connection->segment_offset = 0;
+	return 1;
+}
+
+/**
+ * @brief Answer the received requests and send the responses, until the connection waits for the client
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T to serve
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void serve_web_connection(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection){
+	int answered, written;
+
+	do{
+		if((answered = process_web_requests(worker, connection))==-1 || (written = write_web_response(worker, connection))==-1){
+			close_web_connection(worker, connection);
+			return;
+		}
+		if(written==0){
+			// Continue once the socket has room
+			return;
+		}
+		// All the responses were sent
+		if(connection->close_after_response==TRUE || (connection->input_closed==TRUE && answered==0)){
+			close_web_connection(worker, connection);
+			return;
+		}
+	}while(answered>0);
+
+	// Wait for the next requests (the connection persists)
+	watch_web_connection(worker, connection, FALSE);
+}
+
+/**
+ * @brief Read the available bytes of the requests and answer the complete ones
+ * @param worker WEB_SERVER_WORKER_T with the connection
+ * @param connection WEB_CONNECTION_T to read from
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void read_web_request(WEB_SERVER_WORKER_T *worker, WEB_CONNECTION_T *connection){
+	ssize_t received;
+
+	// A full buffer is answered (or rejected) before reading more
+	while(connection->request_length<HTTP_MAXIMUM_REQUEST_SIZE){
+		received = recv(connection->fd, connection->request+connection->request_length, HTTP_MAXIMUM_REQUEST_SIZE-connection->request_length, 0);
+		if(received==-1 && errno==EINTR){
+			continue;
+		}
+		if(received==-1 && (errno==EAGAIN || errno==EWOULDBLOCK)){
+			break;
+		}
+		if(received==-1){
+			close_web_connection(worker, connection);
+			return;
+		}
+		if(received==0){
+			// The client won't send more requests, but still waits for the answers to the ones already sent
+			connection->input_closed = TRUE;
+			break;
+		}
+		connection->request_length += received;
+		connection->request[connection->request_length] = '\0';
+		touch_web_connection(worker, connection);
+	}
+	serve_web_connection(worker, connection);
+}
+
+/**
+ * @brief Send the new results to the streaming connections of the thread
+ * @param worker WEB_SERVER_WORKER_T with the connections
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void push_web_streams(WEB_SERVER_WORKER_T *worker){
+	WEB_CONNECTION_T *connection, *next;
+
+	for(connection=worker->streams; connection!=NULL; connection=next){
+		// The connection may be closed while served
+		next = connection->next_stream;
+		// A connection still sending the previous events gets the new ones once the socket has room
+		if(connection->writing!=TRUE){
+			serve_web_connection(worker, connection);
+		}
+	}
+}
+
+/**
+ * @brief Send a comment to the streaming connections without events for a while (so the proxies and the timeout keep them open)
+ *
+ * A client that stops reading has bytes pending and gets no heartbeat, so it expires like any idle connection.
+ *
+ * @param worker WEB_SERVER_WORKER_T with the connections
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void heartbeat_web_streams(WEB_SERVER_WORKER_T *worker){
+	WEB_CONNECTION_T *connection, *next;
+	long long now = monotonic_time_ms();
+
+	for(connection=worker->streams; connection!=NULL; connection=next){
+		next = connection->next_stream;
+		if(connection->writing!=TRUE && connection->pending==0 && now-connection->last_activity>=HTTP_STREAM_HEARTBEAT_INTERVAL){
+			if(append_web_response(connection, ": heartbeat\n\n", 12)==FALSE){
+				close_web_connection(worker, connection);
+			}else{
+				serve_web_connection(worker, connection);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Close the connections without activity for longer than the timeout
+ * @param worker WEB_SERVER_WORKER_T with the connections
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void expire_web_connections(WEB_SERVER_WORKER_T *worker){
+	long long now = monotonic_time_ms();
+
+	// The list is ordered by the last activity, so stop at the first connection still in time
+	while(worker->oldest!=NULL && now-worker->oldest->last_activity>HTTP_CONNECTION_TIMEOUT){
+		MY_DEBUG("Closing an idle connection\n");
+		close_web_connection(worker, worker->oldest);
+	}
+}
+
+/**
+ * @brief Serve the content using the given args
+ * @param arg WEB_SERVER_WORKER_T structure with the thread information
+ *
+ * @author Brian "Beej Jorgensen" Hall <beej@beej.us>, Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void *web_serve(void *arg){
+	WEB_SERVER_WORKER_T *worker = (WEB_SERVER_WORKER_T *) arg;
+	struct epoll_event events[HTTP_EPOLL_EVENTS];					// To store the events of each wait
+	WEB_CONNECTION_T *connection;
+	unsigned long long wake;
+	int a, number_of_events, push;
+
+	MY_DEBUG("Waiting for connections on port %s...\n", worker->params->port);
+	while(worker->params->shutdown!=TRUE) {  // main event loop
+		// Wake up at least once in a while, to close the idle connections
+		if((number_of_events = epoll_wait(worker->epollfd, events, HTTP_EPOLL_EVENTS, HTTP_TIMEOUT_CHECK_INTERVAL)) == -1) {
+			if(errno!=EINTR){
+				MY_DEBUG("Waiting for the web server events failed\n");
+			}
+			continue;
+		}
+
+		push = FALSE;
+		for(a=0; a<number_of_events; a++){
+			if(events[a].data.ptr==&(worker->wakefd)){
+				// Reset the counter of the eventfd
+				if(read(worker->wakefd, &wake, sizeof(wake))==-1 && errno!=EAGAIN){
+					MY_DEBUG("Failed to read the web server wake up event\n");
+				}
+				if(worker->params->shutdown==TRUE){
+					MY_DEBUG("Got the shutdown signal\n");
+					break;
+				}
+				// Pushed after the events: a stream closed now could still have an event on this batch
+				push = TRUE;
+				continue;
+			}
+			if(events[a].data.ptr==&(worker->sockfd)){
+				accept_web_connections(worker);
+				continue;
+			}
+			connection = (WEB_CONNECTION_T *) events[a].data.ptr;
+			if(events[a].events & (EPOLLERR | EPOLLHUP)){
+				close_web_connection(worker, connection);
+			}else if(connection->writing==TRUE){
+				serve_web_connection(worker, connection);
+			}else{
+				read_web_request(worker, connection);
+			}
+		}
+		if(push==TRUE && worker->params->shutdown!=TRUE){
+			push_web_streams(worker);
+		}
+		heartbeat_web_streams(worker);
+		expire_web_connections(worker);
+	}
+
+	// Close the remaining connections
+	while(worker->oldest!=NULL){
+		close_web_connection(worker, worker->oldest);
+	}
+	return NULL;
+}
+
+/**
+ * @brief Shutdown the web server threads
+ * @param web_server_params structure to recover the threads params
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void shutdown_web_server(WEB_SERVER_PARAMS_T *web_server_params){
+	WEB_CONTENT_CHUNK_T *chunk;
+	unsigned long long wake = 1;
+	int a;
+
+	set_web_message(web_server_params, "<h1>The server is shutting down...</h1>");
+	MY_DEBUG("Shutting down the Web Server\n");
+	// Mark the server for shutdown
+	web_server_params->shutdown=TRUE;
+	for(a=0; a<web_server_params->threads; a++){
+		// Wake the thread and wait for it to exit
+		if(write(web_server_params->workers[a].wakefd, &wake, sizeof(wake))==-1){
+			MY_DEBUG("\nFailed to wake the web server thread\n");
+		}
+		pthread_join(web_server_params->workers[a].thread, NULL);
+		// Close the listening socket and the event queue
+		close(web_server_params->workers[a].sockfd);
+		close(web_server_params->workers[a].wakefd);
+		close(web_server_params->workers[a].epollfd);
+	}
+	free(web_server_params->workers);
+	web_server_params->workers = NULL;
+	// Destroy the mutex
+	if (pthread_mutex_destroy(web_server_params->mutex) != 0) {
+		MY_DEBUG("\npthread_mutex_destroy() failed!\n");
+	}
+	if(web_server_params->message!=NULL){
+		free(web_server_params->message);
+		web_server_params->message = NULL;
+	}
+	// The threads released their references to the page
+	release_web_snapshot(web_server_params->snapshot);
+	web_server_params->snapshot = NULL;
+	pthread_spin_destroy(&(web_server_params->snapshot_lock));
+	// Free the rows of the page
+	while((chunk = web_server_params->first_chunk)!=NULL){
+		web_server_params->first_chunk = chunk->next;
+		free(chunk);
+	}
+	web_server_params->last_chunk = NULL;
+	web_server_params->content_length = 0;
+	if(web_server_params->store!=NULL){
+		store_free(web_server_params->store);
+		web_server_params->store = NULL;
+	}
+	MY_DEBUG("Web Server stopped\n");
+
+}
+
+/**
+ * @brief Wake the web server threads to send the new results to the streaming connections
+ * @param web_server_params structure with the threads of the web server
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void notify_web_server(WEB_SERVER_PARAMS_T *web_server_params){
+	unsigned long long wake = 1;
+	int a;
+
+	for(a=0; a<web_server_params->threads; a++){
+		// The eventfd adds the values, so several notifications before the thread wakes up cost a single wake up
+		if(write(web_server_params->workers[a].wakefd, &wake, sizeof(wake))==-1){
+			MY_DEBUG("\nFailed to wake the web server thread\n");
+		}
+	}
+}
+
+/**
+ * @brief Replace the message shown before the rows of the page
+ * @param web_server_params structure with the content of the web server
+ * @param message string with the new message (HTML)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void set_web_message(WEB_SERVER_PARAMS_T *web_server_params, char* message){
+	char* new_message;
+
+	if((new_message = merge_strings(NULL, message))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the web server message\n");
+	}
+	if (pthread_mutex_lock(web_server_params->mutex) != 0) {
+		MY_DEBUG("\nWeb Server thread lock failed\n");
+		free(new_message);
+		return;
+	}
+	// Swap the message under the lock, so no thread reads it after the free
+	if(web_server_params->message!=NULL){
+		free(web_server_params->message);
+	}
+	web_server_params->message = new_message;
+	publish_web_snapshot(web_server_params);
+	if (pthread_mutex_unlock(web_server_params->mutex) != 0) {
+		MY_DEBUG("\nWeb Server thread unlock failed\n");
+	}
+}
+
+/**
+ * @brief Append rows to the page, in the chunks of the web server
+ *
+ * The appended bytes are never moved or changed, so each row is copied only once and the responses reference them.
+ *
+ * @param web_server_params structure with the content of the web server
+ * @param data with the rows to append (HTML)
+ * @param length number of bytes to append
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void append_web_content(WEB_SERVER_PARAMS_T *web_server_params, char* data, int length){
+	WEB_CONTENT_CHUNK_T *chunk;
+	int room;
+
+	if (pthread_mutex_lock(web_server_params->mutex) != 0) {
+		MY_DEBUG("\nWeb Server thread lock failed\n");
+		return;
+	}
+	while(length>0){
+		// Start a new chunk when the last one is full
+		if(web_server_params->last_chunk==NULL || web_server_params->last_chunk->length==HTTP_CONTENT_CHUNK_SIZE){
+			if((chunk = malloc(sizeof(WEB_CONTENT_CHUNK_T)))==NULL){
+				ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the web server content\n");
+			}
+			chunk->length = 0;
+			chunk->next = NULL;
+			if(web_server_params->last_chunk!=NULL){
+				web_server_params->last_chunk->next = chunk;
+			}else{
+				web_server_params->first_chunk = chunk;
+			}
+			web_server_params->last_chunk = chunk;
+		}
+		chunk = web_server_params->last_chunk;
+		room = (length<HTTP_CONTENT_CHUNK_SIZE-chunk->length)?length:HTTP_CONTENT_CHUNK_SIZE-chunk->length;
+		memcpy(chunk->data+chunk->length, data, room);
+		chunk->length += room;
+		web_server_params->content_length += room;
+		data += room;
+		length -= room;
+	}
+	publish_web_snapshot(web_server_params);
+	if (pthread_mutex_unlock(web_server_params->mutex) != 0) {
+		MY_DEBUG("\nWeb Server thread unlock failed\n");
 	}
-	return aux;
 }
 
 /**
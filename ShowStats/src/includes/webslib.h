@@ -12,22 +12,138 @@
 #define WEBSLIB_H_
 
 /**
- * @brief To store the common data of the web server thread
- */
-typedef struct{
-	int shutdown;					/**< @brief flag to enable a socket exit */
-	int sockfd;						/**< @brief reference to a socket */
-	char *port;						/**< @brief reference to port number string */
-	char *content;					/**< @brief reference to the shared content string */
-	pthread_mutex_t *mutex;			/**< @brief reference to the mutex for content access */
+ * @brief To store the parsed data of an HTTP request
+ */
+typedef struct web_request {
+	char method[HTTP_MAXIMUM_METHOD_SIZE+1];			/**< @brief method of the request (GET, HEAD, ...) */
+	char path[HTTP_MAXIMUM_PATH_SIZE+1];				/**< @brief path of the requested resource, without the query */
+	char query[HTTP_MAXIMUM_PATH_SIZE+1];				/**< @brief query of the requested resource (after the '?', empty if none) */
+	int version;										/**< @brief minor version of the HTTP 1 protocol (0 or 1) */
+	int keep_alive;										/**< @brief TRUE if the connection persists after the response */
+	int content_length;									/**< @brief number of bytes of the request body */
+	int last_event_id;									/**< @brief index of the last event received by the client before reconnecting (Last-Event-ID), -1 if none */
+	char if_none_match[HTTP_MAXIMUM_PATH_SIZE+1];		/**< @brief entity tags of the copies cached by the client (If-None-Match, empty if none) */
+	int accept_gzip;									/**< @brief TRUE if the client accepts a gzip compressed body (Accept-Encoding) */
+} WEB_REQUEST_T;
+
+/**
+ * @brief To store a part of the responses of a connection, sent with a single scatter-gather write
+ */
+typedef struct web_segment {
+	const char* data;									/**< @brief reference to the bytes (NULL for bytes on the response buffer of the connection) */
+	int offset;											/**< @brief position of the bytes on the response buffer of the connection */
+	int length;											/**< @brief number of bytes */
+	struct web_snapshot *snapshot;						/**< @brief snapshot of the page referenced by the response, released once the part is sent (NULL if none) */
+} WEB_SEGMENT_T;
+
+/**
+ * @brief To store a chunk of the rows of the page (the chunks are append only, so the bytes can be sent without the lock)
+ */
+typedef struct web_content_chunk {
+	char data[HTTP_CONTENT_CHUNK_SIZE];					/**< @brief bytes of the rows */
+	int length;											/**< @brief number of bytes used (only changes while this is the last chunk) */
+	struct web_content_chunk *next;						/**< @brief next chunk (NULL for the last) */
+} WEB_CONTENT_CHUNK_T;
+
+/**
+ * @brief To store an immutable version of the page, shared by the responses with a reference count
+ *
+ * The writers publish a new snapshot on each change, so the readers never wait for them (nor they for the readers)
+ */
+typedef struct web_snapshot {
+	long version;										/**< @brief version of the page (for the entity tags) */
+	int references;										/**< @brief number of references (the published one and one for each response) */
+	char *message;										/**< @brief copy of the message shown before the rows (on the same allocation) */
+	int message_length;									/**< @brief number of bytes of the message */
+	WEB_CONTENT_CHUNK_T *first_chunk;					/**< @brief first chunk of the rows */
+	WEB_CONTENT_CHUNK_T *last_chunk;					/**< @brief last chunk of the rows of this version */
+	int last_length;									/**< @brief number of bytes of the last chunk of this version */
+	long content_length;								/**< @brief number of bytes of the rows */
+	int gzip_state;										/**< @brief state of the compressed copy (WEB_GZIP_NONE, WEB_GZIP_BUILDING, WEB_GZIP_READY or WEB_GZIP_FAILED) */
+	char *gzip_content;									/**< @brief gzip compressed copy of the page (only read once ready) */
+	int gzip_length;									/**< @brief number of bytes of the compressed copy */
+} WEB_SNAPSHOT_T;
+
+/**
+ * @brief To store a growable buffer of bytes (to render a response before its length is known)
+ */
+typedef struct web_buffer {
+	char* data;											/**< @brief bytes of the buffer */
+	int length;											/**< @brief number of bytes used */
+	int capacity;										/**< @brief number of bytes allocated */
+} WEB_BUFFER_T;
+
+/**
+ * @brief To store the state of a client connection of the web server
+ */
+typedef struct web_connection {
+	int fd;												/**< @brief socket of the connection */
+	char request[HTTP_MAXIMUM_REQUEST_SIZE+1];			/**< @brief received bytes of the request */
+	int request_length;									/**< @brief number of bytes received */
+	char* response;										/**< @brief bytes of the responses owned by the connection (headers, error pages) */
+	int response_length;								/**< @brief number of bytes on the response buffer */
+	int response_capacity;								/**< @brief number of bytes allocated for the response buffer */
+	WEB_SEGMENT_T* segments;							/**< @brief parts of the responses to send, in the order of the requests (pipelining) */
+	int segments_count;									/**< @brief number of parts to send */
+	int segments_capacity;								/**< @brief number of parts allocated */
+	int segments_sent;									/**< @brief number of parts already sent */
+	int segment_offset;									/**< @brief number of bytes already sent of the first part not sent */
+	long pending;										/**< @brief number of bytes still to send */
+	int close_after_response;							/**< @brief TRUE to close the connection once the responses are sent */
+	int input_closed;									/**< @brief TRUE after the client closed its side of the connection (no more requests) */
+	int writing;										/**< @brief TRUE while waiting for the socket to accept more bytes (EPOLLOUT) */
+	int streaming;										/**< @brief TRUE if the connection receives the new results as events (no more requests are answered) */
+	int stream_index;									/**< @brief index of the next result to send as an event */
+	struct web_connection *previous_stream;				/**< @brief previous streaming connection of the thread */
+	struct web_connection *next_stream;					/**< @brief next streaming connection of the thread */
+	long long last_activity;							/**< @brief monotonic time (ms) of the last read or write */
+	struct web_connection *previous;					/**< @brief connection with the previous activity (NULL for the oldest) */
+	struct web_connection *next;						/**< @brief connection with the next activity (NULL for the newest) */
+} WEB_CONNECTION_T;
+
+/**
+ * @brief To store the data of a web server thread (each one with its own listening socket and epoll instance)
+ */
+typedef struct web_server_worker {
+	int sockfd;											/**< @brief listening socket */
+	int epollfd;										/**< @brief epoll instance with the listening socket and the connections */
+	int wakefd;											/**< @brief eventfd to wake the thread on the shutdown and on new results */
+	pthread_t thread;									/**< @brief thread of the worker */
+	int connections;									/**< @brief number of open connections */
+	WEB_CONNECTION_T *oldest;							/**< @brief connection idle for the longest time */
+	WEB_CONNECTION_T *newest;							/**< @brief connection with the most recent activity */
+	WEB_CONNECTION_T *streams;							/**< @brief streaming connections, to send the new results */
+	struct web_server_params *params;					/**< @brief reference to the common data of the web server */
+} WEB_SERVER_WORKER_T;
+
+/**
+ * @brief To store the common data of the web server threads
+ */
+typedef struct web_server_params {
+	int shutdown;										/**< @brief flag to enable a socket exit */
+	char *port;											/**< @brief reference to port number string */
+	char *message;										/**< @brief reference to the message shown before the rows */
+	STATS_STORE_T *store;								/**< @brief columnar store of the results, for the JSON API */
+	WEB_CONTENT_CHUNK_T *first_chunk;					/**< @brief first chunk of the rows of the page */
+	WEB_CONTENT_CHUNK_T *last_chunk;					/**< @brief chunk where the next rows are appended */
+	long content_length;								/**< @brief number of bytes of the rows */
+	long content_version;								/**< @brief version of the page (changes with each new row or message, for the entity tags) */
+	WEB_SNAPSHOT_T *snapshot;							/**< @brief last published version of the page */
+	pthread_spinlock_t snapshot_lock;					/**< @brief lock to take a reference to the published snapshot (held only to copy the pointer) */
+	pthread_mutex_t *mutex;								/**< @brief reference to the mutex of the writers of the content */
+	int maximum_connections;							/**< @brief maximum number of simultaneous connections of each thread */
+	int threads;										/**< @brief number of threads */
+	WEB_SERVER_WORKER_T *workers;						/**< @brief data of each thread */
 } WEB_SERVER_PARAMS_T;
 
 void sigchld_handler(int);
 void *get_in_addr(void*);
-void create_web_server(char *, int, pthread_t *, WEB_SERVER_PARAMS_T *);
+void create_web_server(char *, int, int, WEB_SERVER_PARAMS_T *);
 void *web_serve(void *);
-void shutdown_web_server(pthread_t *, WEB_SERVER_PARAMS_T *);
-char* update_content(WEB_SERVER_PARAMS_T *, char *, char*, char*, char*);
+void shutdown_web_server(WEB_SERVER_PARAMS_T *);
+void notify_web_server(WEB_SERVER_PARAMS_T *);
+void set_web_message(WEB_SERVER_PARAMS_T *, char *);
+void append_web_content(WEB_SERVER_PARAMS_T *, char *, int);
 char* merge_strings(char*, char*);
 
 #endif /* WEBSLIB_H_ */
@@ -18,6 +18,8 @@
 #include <unistd.h>
 #include <string.h>
 #include <pthread.h>
+#include <errno.h>
+#include <time.h>
 
 #include "3rd/debug.h"
 #include "3rd/semaforos.h"
@@ -28,7 +30,10 @@
 #include "includes/aux.h"
 #include "includes/commonlib.h"
 #include "includes/showstatslib.h"
+#include "includes/hashlib.h"
+#include "includes/storelib.h"
 #include "includes/webslib.h"
+#include "includes/exportlib.h"
 #include "main.h"
 
 /**
@@ -42,10 +47,9 @@
 int main(int argc, char *argv[]){
 	/* Variable declarations */
 	struct gengetopt_args_info args_info;
-	FILE *csv_file = NULL;
+	EXPORTER_T *exporter = NULL;
 	CONTROLLER_STAT_T controller_stat;							// to store the statistical controller control
 	int result;													// to store a result of an operation
-	pthread_t t_web_server;
 	pthread_mutex_t web_server_mutex;
 	WEB_SERVER_PARAMS_T web_server_params;
 	
@@ -58,6 +62,18 @@ int main(int argc, char *argv[]){
 		exit(M_INVALID_PARAMETERS);
 	}
 
+	// If we have a export parameter
+	if (args_info.export_given){
+		if(strcmp(args_info.export_format_arg, "csv")!=0 && strcmp(args_info.export_format_arg, "binary")!=0){
+			printf("The export format must be csv or binary\n");
+			exit(M_INVALID_PARAMETERS);
+		}
+		if(args_info.export_rotate_size_arg<0 || args_info.export_rotate_time_arg<0 || args_info.export_sync_arg<0){
+			printf("The rotation size, the rotation time and the synchronization interval of the export can't be negative\n");
+			exit(M_INVALID_PARAMETERS);
+		}
+	}
+
 	// If we have a HTTP parameter
 	if (args_info.http_given){
 		if(args_info.http_arg<PORT_RANGE_MIN || args_info.http_arg>PORT_RANGE_MAX){
@@ -65,16 +81,28 @@ int main(int argc, char *argv[]){
 			printf("The port %d is out of the allowed range port numbers. Port to listen should be a number between %d and %d\n", args_info.http_arg, PORT_RANGE_MIN, PORT_RANGE_MAX);
 			exit(M_PORT_OUT_OF_RANGE);
 		}
+		if(args_info.http_threads_arg<1){
+			printf("The number of HTTP server threads must be at least 1\n");
+			exit(M_INVALID_PARAMETERS);
+		}
 		// Initialize the mutex for the thread
 		if (pthread_mutex_init(&web_server_mutex, NULL) != 0) {
 			ERROR(M_PTHREAD_MUTEX_INIT_FAILED, "\nWeb Server mutex initialization failed.\n");
 		}
 		web_server_params.mutex = &web_server_mutex;
+		// Initialize the lock of the published version of the page
+		if (pthread_spin_init(&(web_server_params.snapshot_lock), PTHREAD_PROCESS_PRIVATE) != 0) {
+			ERROR(M_PTHREAD_MUTEX_INIT_FAILED, "\nWeb Server snapshot lock initialization failed.\n");
+		}
+		web_server_params.snapshot = NULL;
 
-		web_server_params.content = NULL;
-		web_server_params.content = update_content(&web_server_params, web_server_params.content,"", "", "");
+		web_server_params.message = NULL;
+		web_server_params.first_chunk = web_server_params.last_chunk = NULL;
+		web_server_params.content_length = 0;
+		web_server_params.content_version = 0;
+		web_server_params.store = store_create();
 		// Activate the web server if requested by the command line
-		webnize(args_info, HTTP_MAXIMUM_CONNECTIONS, &t_web_server, &web_server_params);
+		webnize(args_info, HTTP_MAXIMUM_CONNECTIONS, &web_server_params);
 	}
 
 	// Initializes the controller and terminate the program on errors
@@ -87,7 +115,9 @@ int main(int argc, char *argv[]){
 			default:
 				printf("\nThe processing failed with the error %d\n",result);
 		}
-		shutdown_web_server(&t_web_server, &web_server_params);
+		if (args_info.http_given){
+			shutdown_web_server(&web_server_params);
+		}
 		cmdline_parser_free(&args_info);
 		return result;
 	}
@@ -95,26 +125,24 @@ int main(int argc, char *argv[]){
 	// Let's try to register this show_stats in the shared memory
 	register_show_stats(&controller_stat);
 
-	// Open a CVS file if such operation was requested or print some info
-	if((csv_file = csvnize(args_info))==NULL){
+	// Open the export file if such operation was requested or print some info
+	if((exporter = csvnize(args_info, controller_stat))==NULL){
 		print_header(controller_stat);
 	}
 
 	// Ok, let's show some stats
 	if (args_info.http_given){
-		show_stats(&controller_stat, &web_server_params);
+		show_stats(&controller_stat, &web_server_params, exporter);
 	}else{
-		show_stats(&controller_stat, NULL);
+		show_stats(&controller_stat, NULL, exporter);
 	}
 
-	// Close the csv file
-	if(csv_file!=NULL){
-		close_log_file(csv_file);
-	}
+	// Write the remaining results and close the export file
+	exporter_close(exporter);
 
 	if (args_info.http_given){
-		// Shutdown the web server thread
-		shutdown_web_server(&t_web_server, &web_server_params);
+		// Shutdown the web server threads
+		shutdown_web_server(&web_server_params);
 	}
 
 	// Free the command line parser memory
@@ -127,15 +155,16 @@ int main(int argc, char *argv[]){
  * @brief Removes the duplicated algorithms in the serial_algorithm_arg array from the gengetopt_args_info structure
  * @param controller_stat with the control structure for stats
  * @param web_server_params with the thread web server parameters
+ * @param exporter EXPORTER_T with the export file (NULL to print the results on the console)
  *
  * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-void show_stats(CONTROLLER_STAT_T* controller_stat, WEB_SERVER_PARAMS_T *web_server_params){
-	int result, aux, hold=TRUE, counter=0;
-	char line[MAXCHARS];
+void show_stats(CONTROLLER_STAT_T* controller_stat, WEB_SERVER_PARAMS_T *web_server_params, EXPORTER_T *exporter){
+	int result, aux, hold=TRUE, counter=0, line_length, export_result=0;
+	char line[EXPORT_MAXIMUM_RECORD_SIZE];
 
 	if(web_server_params!=NULL){
-		web_server_params->content = update_content(web_server_params, web_server_params->content, "", "", "");
+		set_web_message(web_server_params, "");
 	}
 	do{
 		// Critical section bellow
@@ -144,11 +173,21 @@ void show_stats(CONTROLLER_STAT_T* controller_stat, WEB_SERVER_PARAMS_T *web_ser
 		aux = controller_stat->control_data->index_stat-1;
 		// If new data was added (the Sorter flag as an update a exit request)
 		if(counter<=aux){
-			printf("%s,%d,%s,%d,%d,%.0f\n",controller_stat->stats[counter].filename, controller_stat->stats[counter].nlines, controller_stat->stats[counter].algorithm, controller_stat->stats[counter].niterations, controller_stat->stats[counter].nswaps, controller_stat->stats[counter].time);
+			if(exporter!=NULL){
+				// Only buffered here, the writes to the disk are done outside of the critical section
+				export_result = exporter_write(exporter, &(controller_stat->stats[counter]));
+			}else{
+				line_length = export_format_csv(line, sizeof(line), &(controller_stat->stats[counter]));
+				fwrite(line, 1, line_length, stdout);
+			}
 			if(web_server_params!=NULL){
-				snprintf(line, (MAXCHARS-1)*sizeof(char), "<tr><td>%s</td><td>%d</td><td>%s</td><td>%d</td><td>%d</td><td>%.0f</td></tr>",controller_stat->stats[counter].filename, controller_stat->stats[counter].nlines, controller_stat->stats[counter].algorithm, controller_stat->stats[counter].niterations, controller_stat->stats[counter].nswaps, controller_stat->stats[counter].time);
-				line[MAXCHARS]='\0';
-				web_server_params->content = update_content(web_server_params, web_server_params->content, web_server_params->content, line, "");
+				line_length = snprintf(line, MAXCHARS*sizeof(char), "<tr><td>%s</td><td>%d</td><td>%s</td><td>%d</td><td>%d</td><td>%.0f</td><td>%d</td><td>%.0f</td><td>%.0f</td><td>%.3f</td></tr>",controller_stat->stats[counter].filename, controller_stat->stats[counter].nlines, controller_stat->stats[counter].algorithm, controller_stat->stats[counter].niterations, controller_stat->stats[counter].nswaps, controller_stat->stats[counter].time, controller_stat->stats[counter].nduplicates, controller_stat->stats[counter].dedupe_time, controller_stat->stats[counter].time_saved, controller_stat->stats[counter].time_uncertainty);
+				// Each row is appended once (the rows already on the page aren't copied again)
+				append_web_content(web_server_params, line, (line_length<MAXCHARS)?line_length:MAXCHARS-1);
+				// And to the store of the JSON API
+				store_append(web_server_params->store, &(controller_stat->stats[counter]));
+				// And to the clients of the live stream
+				notify_web_server(web_server_params);
 			}
 			counter++;
 			// If we still have more data available, release the semaphore for the next iteration
@@ -161,6 +200,13 @@ void show_stats(CONTROLLER_STAT_T* controller_stat, WEB_SERVER_PARAMS_T *web_ser
 			hold=FALSE;
 		}
 		release_data_for_access(controller_stat);
+
+		// Rotate, synchronize or write the export file when due (the buffered results are written once no more are waiting)
+		if(exporter!=NULL && (export_result!=0 || exporter_maintain(exporter, (counter>aux)?TRUE:FALSE)!=0)){
+			printf("\nUnable to write to the export file (%s), the export was stopped...\n", strerror(errno));
+			// The file is closed by the caller
+			exporter = NULL;
+		}
 	}while(hold==TRUE);
 
 	// Detach from the shared memory
@@ -173,56 +219,34 @@ void show_stats(CONTROLLER_STAT_T* controller_stat, WEB_SERVER_PARAMS_T *web_ser
 }
 
 /**
- * @brief Redirect output to a file if such setting was request through command line parameter
+ * @brief Open the exporter of the results if such setting was request through command line parameter
  * @param args_info struct gengetopt_args_info with the parameters given to the application
- * @return FILE* descriptor if a file was opened, NULL otherwise
+ * @param controller_stat with the control structure for stats (for the selected algorithms)
+ * @return EXPORTER_T pointer if a file was opened, NULL otherwise
  *
  * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-FILE* csvnize(struct gengetopt_args_info args_info){
-	FILE *csv_file = NULL;
-	char* export_filename=NULL;
+EXPORTER_T* csvnize(struct gengetopt_args_info args_info, CONTROLLER_STAT_T controller_stat){
+	EXPORTER_T *exporter = NULL;
 
-	// If we have a export parameter, let's redirect the stdout directly to the file
+	// If we have a export parameter, the results are written by the exporter (the console only gets the messages)
 	if (args_info.export_given){
-		// If the user forgot to add the extension
-		if(ends_with(args_info.export_arg,SHOW_STATS_FILE_EXPORT_EXTENSION)!=TRUE){
-			// Allocate memory for the filename with the extension
-			if((export_filename=malloc(sizeof(char)*(strlen(args_info.export_arg)+strlen(SHOW_STATS_FILE_EXPORT_EXTENSION)+1)))==NULL){
-				ERROR(M_FAILED_MEMORY_ALLOCATION,"\nMemory allocation failed for the filename %s%s", args_info.export_arg, SHOW_STATS_FILE_EXPORT_EXTENSION);
-			}
-			// Adds the extension to the filename
-			sprintf(export_filename,"%s%s",args_info.export_arg,SHOW_STATS_FILE_EXPORT_EXTENSION);
-		}else{
-			// Allocate memory for the filename with the extension
-			if((export_filename=malloc(sizeof(char)*(strlen(args_info.export_arg)+1)))==NULL){
-				ERROR(M_FAILED_MEMORY_ALLOCATION,"\nMemory allocation failed for the filename %s", args_info.export_arg);
-			}
-			// Copy to the filename
-			sprintf(export_filename,"%s",args_info.export_arg);
-		}
-		// Open the log file
-		if((csv_file=open_log_file(export_filename,"w"))==NULL){
-			printf("\nUnable to export to the %s file...", export_filename);
-		}
-		// Free the memory allocated for the filename
-		if(export_filename!=NULL){
-			free(export_filename);
+		if((exporter=exporter_open(args_info.export_arg, (strcmp(args_info.export_format_arg, "binary")==0)?EXPORT_FORMAT_BINARY:EXPORT_FORMAT_CSV, (long long)args_info.export_rotate_size_arg*1024*1024, args_info.export_rotate_time_arg, args_info.export_sync_arg, controller_stat.control_data->selected_algorithms))==NULL){
+			printf("\nUnable to export to the %s file (%s)...", args_info.export_arg, strerror(errno));
 		}
 	}
-	return csv_file;
+	return exporter;
 }
 
 /**
  * @brief If requested, starts the web server on the specified port
  * @param args_info with the application arguments structure
- * @param connections with maximum number of connections to handle
- * @param t_web_server with the web server thread
+ * @param connections with maximum number of connections to handle by each thread
  * @param web_server_params with the thread web server parameters
  *
  * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-void webnize(struct gengetopt_args_info args_info, int connections, pthread_t *t_web_server, WEB_SERVER_PARAMS_T *web_server_params){
+void webnize(struct gengetopt_args_info args_info, int connections, WEB_SERVER_PARAMS_T *web_server_params){
 	char port[6];
 	if (args_info.http_given){
 		if(args_info.http_arg<PORT_RANGE_MIN || args_info.http_arg>PORT_RANGE_MAX){
@@ -231,10 +255,10 @@ void webnize(struct gengetopt_args_info args_info, int connections, pthread_t *t
 			exit(M_PORT_OUT_OF_RANGE);
 		}
 		sprintf(port, "%d", args_info.http_arg);
-		web_server_params->content = update_content(web_server_params, web_server_params->content,"<tr><td colspan='6'><h1>", "Server is initializing...", "<h1></td></tr>");
+		set_web_message(web_server_params, "<tr><td colspan='10'><h1>Server is initializing...</h1></td></tr>");
 		// Create the web server on the specified port
-		create_web_server(port, connections, t_web_server, web_server_params);
-		web_server_params->content = update_content(web_server_params, web_server_params->content,"<tr><td colspan='6'><h1>", "Server is initialized. Waiting for data...", "</h1></td></tr>");
+		create_web_server(port, connections, args_info.http_threads_arg, web_server_params);
+		set_web_message(web_server_params, "<tr><td colspan='10'><h1>Server is initialized. Waiting for data...</h1></td></tr>");
 	}
 }
 
@@ -245,12 +269,10 @@ void webnize(struct gengetopt_args_info args_info, int connections, pthread_t *t
  * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
 void print_header(CONTROLLER_STAT_T controller_stat){
-	char* date_of_the_experiment=NULL;
+	char header[MAXCHARS*2];
 
-	date_of_the_experiment = get_current_time("@%Y-%m-%d %Hh%M", strlen("@2009-10-09 15h30"));
-	printf("# showStats – sorter benchmark\n# Selected algorithms: %s\n# Date: %s\n# filename,nlines,algorithm,niterations,nswaps,time\n", controller_stat.control_data->selected_algorithms, date_of_the_experiment);
-	free(date_of_the_experiment);
-	date_of_the_experiment=NULL;
+	export_format_header(header, sizeof(header), controller_stat.control_data->selected_algorithms, time(NULL));
+	fputs(header, stdout);
 }
 
 /**
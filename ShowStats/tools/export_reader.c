@@ -0,0 +1,88 @@
+/**
+* @file export_reader.c
+* @brief Reader of the binary export files of the ShowStats (--export-format=binary)
+*
+* Usage: export_reader [-n] <file>...
+*
+* Prints the results of the files (in the given order, e.g. the rotated files) on the same CSV format of the ShowStats
+* export, with the header of the first file (-n to omit it), so the output can replace a CSV export.
+*
+* @date 2010/02/08 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/includes/definitions.h"
+#include "../src/includes/commonlib.h"
+#include "../src/includes/exportlib.h"
+
+/**
+ * @brief Print the results of a binary export file
+ * @param filename of the file
+ * @param header TRUE to print the header of the file before the results
+ * @param records to increment with the number of results printed
+ * @return integer 0 on success, M_FAILED_FILE_READ otherwise
+ */
+static int read_file(char* filename, int header, long long* records){
+	FILE* file;
+	EXPORT_FILE_HEADER_T file_header;
+	SHARED_ALGORITHM_STAT_T stat;
+	char line[EXPORT_MAXIMUM_RECORD_SIZE];
+	int result;
+
+	if((file=fopen(filename, "rb"))==NULL){
+		fprintf(stderr, "Unable to open the %s file (%s)\n", filename, strerror(errno));
+		return M_FAILED_FILE_READ;
+	}
+	if(export_read_header(file, &file_header)!=0){
+		fprintf(stderr, "The %s file isn't a binary export (or was written by another version or byte order)\n", filename);
+		fclose(file);
+		return M_FAILED_FILE_READ;
+	}
+	if(header==TRUE){
+		export_format_header(line, sizeof(line), file_header.algorithms, file_header.created);
+		fputs(line, stdout);
+	}
+	while((result=export_read_record(file, &stat))==1){
+		fwrite(line, 1, export_format_csv(line, sizeof(line), &stat), stdout);
+		(*records)++;
+	}
+	fclose(file);
+	if(result==-1){
+		// The last record of a file still being written (or of an interrupted export) can be incomplete
+		fprintf(stderr, "The %s file has a truncated record after %lld results\n", filename, *records);
+		return M_FAILED_FILE_READ;
+	}
+	return 0;
+}
+
+/**
+ * @brief Main function
+ * @param argc number of arguments
+ * @param argv arguments (-n to omit the header and the files to read)
+ * @return integer with the exit code
+ */
+int main(int argc, char *argv[]){
+	int a = 1, header = TRUE, result = 0;
+	long long records = 0;
+
+	if(argc>1 && strcmp(argv[1], "-n")==0){
+		header = FALSE;
+		a++;
+	}
+	if(a>=argc){
+		fprintf(stderr, "Usage: %s [-n] <file>...\n", argv[0]);
+		return M_INVALID_PARAMETERS;
+	}
+	for(; a<argc && result==0; a++){
+		result = read_file(argv[a], header, &records);
+		// Only the first file gets the header
+		header = FALSE;
+	}
+
+	return result;
+}
@@ -0,0 +1,369 @@
+/**
+* @file http_load.c
+* @brief Load test tool for the ShowStats web server
+*
+* Usage: http_load <host> <port> [concurrent connections] [requests] [idle connections] [requests per connection] [pipeline depth]
+*
+* Keeps the given number of connections requesting the page at the same time (with non-blocking sockets and epoll),
+* until the number of requests is reached, and reports the throughput and the latency percentiles.
+* Each connection sends the given number of requests (HTTP/1.1 keep-alive, the last one with "Connection: close"),
+* with up to the pipeline depth requests sent before the responses arrive.
+* The idle connections send an incomplete request and then stall, like slow clients, for the whole test.
+*
+* @date 2010/01/25 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#define _GNU_SOURCE // for the strcasestr
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+
+#include "../src/includes/definitions.h"
+
+/**
+ * @brief Default number of concurrent connections
+ */
+#define LOAD_CONCURRENCY 100
+
+/**
+ * @brief Default number of requests
+ */
+#define LOAD_REQUESTS 10000
+
+/**
+ * @brief Maximum number of requests sent before the responses arrive
+ */
+#define LOAD_MAXIMUM_PIPELINE 64
+
+/**
+ * @brief Maximum size of the headers of a response
+ */
+#define LOAD_HEADERS_SIZE 4096
+
+/**
+ * @brief To store the state of a connection of the load test
+ */
+typedef struct load_connection {
+	int fd;									/**< @brief socket of the connection */
+	int connected;							/**< @brief TRUE after the connection was established */
+	int to_send;							/**< @brief number of requests still to send on the connection */
+	double sent[LOAD_MAXIMUM_PIPELINE];		/**< @brief time (us) each request waiting for the response was sent (circular) */
+	int first;								/**< @brief position of the oldest request waiting for the response */
+	int outstanding;						/**< @brief number of requests waiting for the response */
+	char headers[LOAD_HEADERS_SIZE+1];		/**< @brief headers of the response being received */
+	int headers_length;						/**< @brief number of bytes on the headers */
+	long body_remaining;					/**< @brief bytes of the body still to receive (-1 while receiving the headers) */
+	int status_ok;							/**< @brief TRUE if the response being received has the status 200 */
+} LOAD_CONNECTION_T;
+
+/**
+ * @brief To store the results of the load test
+ */
+typedef struct load_results {
+	double *latencies;						/**< @brief latency (us) of each completed request */
+	int completed;							/**< @brief number of requests answered with the status 200 */
+	int failed;								/**< @brief number of requests failed */
+	int connections;						/**< @brief number of connections opened */
+	long long bytes;						/**< @brief number of bytes received */
+} LOAD_RESULTS_T;
+
+/**
+ * @brief Get the current time of the monotonic clock
+ * @return double with the time in microseconds
+ */
+static double now_us(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec*1000000.0+now.tv_nsec/1000.0;
+}
+
+/**
+ * @brief Compare two latencies for the qsort
+ * @param a latency to compare with the next parameter
+ * @param b latency to compare with the previous parameter
+ * @return integer lower than 0 if a is lower than b, 0 if they are equal, greater than 0 otherwise
+ */
+static int compare_latencies(const void* a, const void* b){
+	double latency_a = *((const double*) a), latency_b = *((const double*) b);
+
+	return (latency_a > latency_b) - (latency_a < latency_b);
+}
+
+/**
+ * @brief Start a non-blocking connection to the server
+ * @param server with the address of the server
+ * @param epollfd epoll instance to register the connection
+ * @param connection LOAD_CONNECTION_T to initialize
+ * @param requests number of requests to send on the connection
+ * @return integer TRUE on success, FALSE on error
+ */
+static int start_connection(struct addrinfo* server, int epollfd, LOAD_CONNECTION_T* connection, int requests){
+	struct epoll_event event;
+
+	connection->connected = FALSE;
+	connection->to_send = requests;
+	connection->first = connection->outstanding = 0;
+	connection->headers_length = 0;
+	connection->body_remaining = -1;
+	if((connection->fd = socket(server->ai_family, server->ai_socktype | SOCK_NONBLOCK, server->ai_protocol))==-1){
+		return FALSE;
+	}
+	if(connect(connection->fd, server->ai_addr, server->ai_addrlen)==-1 && errno!=EINPROGRESS){
+		close(connection->fd);
+		return FALSE;
+	}
+	// Writable once connected
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLOUT;
+	event.data.ptr = connection;
+	epoll_ctl(epollfd, EPOLL_CTL_ADD, connection->fd, &event);
+	return TRUE;
+}
+
+/**
+ * @brief Send the next requests of the connection, up to the pipeline depth
+ * @param connection LOAD_CONNECTION_T to send the requests
+ * @param depth maximum number of requests waiting for the response
+ * @param host string with the host of the server
+ * @return integer TRUE on success, FALSE on error
+ */
+static int send_requests(LOAD_CONNECTION_T* connection, int depth, char* host){
+	char request[MAXCHARS];
+	int length;
+
+	while(connection->to_send>0 && connection->outstanding<depth){
+		length = snprintf(request, sizeof(request), "GET / HTTP/1.1\r\nHost: %s\r\n%s\r\n", host, (connection->to_send==1)?"Connection: close\r\n":"");
+		if(send(connection->fd, request, length, MSG_NOSIGNAL)!=length){
+			return FALSE;
+		}
+		connection->sent[(connection->first+connection->outstanding)%LOAD_MAXIMUM_PIPELINE] = now_us();
+		connection->outstanding++;
+		connection->to_send--;
+	}
+	return TRUE;
+}
+
+/**
+ * @brief Parse the received bytes of the responses of a connection
+ * @param connection LOAD_CONNECTION_T with the responses
+ * @param data received bytes
+ * @param length number of received bytes
+ * @param results LOAD_RESULTS_T to store the completed requests
+ * @return integer TRUE on success, FALSE if the response is invalid
+ */
+static int parse_responses(LOAD_CONNECTION_T* connection, char* data, long length, LOAD_RESULTS_T* results){
+	char* content_length;
+	long a=0, chunk;
+
+	while(a<length){
+		if(connection->body_remaining<0){
+			// Headers: up to the empty line
+			if(connection->headers_length>=LOAD_HEADERS_SIZE || connection->outstanding==0){
+				return FALSE;
+			}
+			connection->headers[connection->headers_length++] = data[a++];
+			connection->headers[connection->headers_length] = '\0';
+			if(connection->headers_length<4 || strcmp(connection->headers+connection->headers_length-4, "\r\n\r\n")!=0){
+				continue;
+			}
+			connection->status_ok = (strncmp(connection->headers, "HTTP/1.", 7)==0 && strncmp(connection->headers+8, " 200", 4)==0);
+			if((content_length = strcasestr(connection->headers, "\r\nContent-Length:"))==NULL){
+				return FALSE;
+			}
+			connection->body_remaining = atol(content_length+17);
+			connection->headers_length = 0;
+		}else{
+			chunk = (length-a<connection->body_remaining)?length-a:connection->body_remaining;
+			connection->body_remaining -= chunk;
+			a += chunk;
+		}
+		if(connection->body_remaining==0){
+			// The response is complete
+			if(connection->status_ok){
+				results->latencies[results->completed++] = now_us()-connection->sent[connection->first];
+			}else{
+				results->failed++;
+			}
+			connection->first = (connection->first+1)%LOAD_MAXIMUM_PIPELINE;
+			connection->outstanding--;
+			connection->body_remaining = -1;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * @brief Main function
+ * @param argc number of arguments
+ * @param argv arguments
+ * @return integer with the exit code
+ */
+int main(int argc, char *argv[]){
+	char* incomplete_request = "GET / HTTP/1.1\r\n";
+	char buffer[65536];
+	struct addrinfo hints, *server;
+	struct epoll_event events[HTTP_EPOLL_EVENTS], event;
+	LOAD_CONNECTION_T *connections, *connection;
+	LOAD_RESULTS_T results;
+	int *idle_fds;
+	double start, elapsed;
+	int concurrency, requests, idle, keep_alive, depth, started=0, active=0, idle_closed=0, connection_requests;
+	int a, number_of_events, error, epollfd, socket_error, done;
+	socklen_t error_length;
+	ssize_t received;
+
+	if(argc<3){
+		fprintf(stderr, "Usage: %s <host> <port> [concurrent connections] [requests] [idle connections] [requests per connection] [pipeline depth]\n", argv[0]);
+		return M_INVALID_PARAMETERS;
+	}
+	concurrency = (argc>3)?atoi(argv[3]):LOAD_CONCURRENCY;
+	requests = (argc>4)?atoi(argv[4]):LOAD_REQUESTS;
+	idle = (argc>5)?atoi(argv[5]):0;
+	keep_alive = (argc>6)?atoi(argv[6]):1;
+	depth = (argc>7)?atoi(argv[7]):1;
+	if(concurrency<=0 || requests<=0 || idle<0 || keep_alive<=0 || depth<=0 || depth>LOAD_MAXIMUM_PIPELINE){
+		fprintf(stderr, "Usage: %s <host> <port> [concurrent connections] [requests] [idle connections] [requests per connection] [pipeline depth (up to %d)]\n", argv[0], LOAD_MAXIMUM_PIPELINE);
+		return M_INVALID_PARAMETERS;
+	}
+	if(concurrency>requests){
+		concurrency = requests;
+	}
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if((error = getaddrinfo(argv[1], argv[2], &hints, &server))!=0){
+		fprintf(stderr, "Failed to resolve %s:%s (%s)\n", argv[1], argv[2], gai_strerror(error));
+		return M_GETADDRINFO_ERROR;
+	}
+
+	memset(&results, 0, sizeof(results));
+	connections = calloc(concurrency, sizeof(LOAD_CONNECTION_T));
+	results.latencies = calloc(requests, sizeof(double));
+	idle_fds = calloc(idle+1, sizeof(int));
+	if(connections==NULL || results.latencies==NULL || idle_fds==NULL){
+		fprintf(stderr, "Error in memory allocation\n");
+		return M_FAILED_MEMORY_ALLOCATION;
+	}
+
+	// The slow clients: connected, with an incomplete request
+	for(a=0; a<idle; a++){
+		if((idle_fds[a] = socket(server->ai_family, server->ai_socktype, server->ai_protocol))==-1 || connect(idle_fds[a], server->ai_addr, server->ai_addrlen)==-1){
+			fprintf(stderr, "Failed to open the idle connection %d (%s)\n", a, strerror(errno));
+			return M_SOCKET_CREATION_ERROR;
+		}
+		if(send(idle_fds[a], incomplete_request, strlen(incomplete_request), MSG_NOSIGNAL)==-1){
+			fprintf(stderr, "Failed to write on the idle connection %d\n", a);
+		}
+	}
+
+	if((epollfd = epoll_create1(0))==-1){
+		fprintf(stderr, "Failed to create the event queue\n");
+		return M_EPOLL_CREATE_FAILED;
+	}
+
+	start = now_us();
+	for(a=0; a<concurrency && started<requests; a++){
+		connection_requests = (requests-started<keep_alive)?requests-started:keep_alive;
+		started += connection_requests;
+		results.connections++;
+		if(start_connection(server, epollfd, &(connections[a]), connection_requests)){
+			active++;
+		}else{
+			results.failed += connection_requests;
+		}
+	}
+
+	while(active>0){
+		if((number_of_events = epoll_wait(epollfd, events, HTTP_EPOLL_EVENTS, -1))==-1){
+			if(errno==EINTR){
+				continue;
+			}
+			break;
+		}
+		for(a=0; a<number_of_events; a++){
+			connection = (LOAD_CONNECTION_T*) events[a].data.ptr;
+			done = FALSE;
+			if(!connection->connected){
+				// The connection finished: send the first requests and wait for the responses
+				error_length = sizeof(socket_error);
+				getsockopt(connection->fd, SOL_SOCKET, SO_ERROR, &socket_error, &error_length);
+				if(socket_error!=0 || !send_requests(connection, depth, argv[1])){
+					done = TRUE;
+				}else{
+					connection->connected = TRUE;
+					memset(&event, 0, sizeof(event));
+					event.events = EPOLLIN;
+					event.data.ptr = connection;
+					epoll_ctl(epollfd, EPOLL_CTL_MOD, connection->fd, &event);
+				}
+			}else{
+				while((received = recv(connection->fd, buffer, sizeof(buffer), 0))>0){
+					results.bytes += received;
+					if(!parse_responses(connection, buffer, received, &results)){
+						break;
+					}
+				}
+				if(received==-1 && (errno==EAGAIN || errno==EWOULDBLOCK)){
+					// Keep the pipeline full
+					done = !send_requests(connection, depth, argv[1]) || (connection->to_send==0 && connection->outstanding==0);
+				}else{
+					done = TRUE;
+				}
+			}
+			if(!done){
+				continue;
+			}
+			// The connection is over (the requests without a response failed): start the next ones on the same slot
+			results.failed += connection->outstanding+connection->to_send;
+			close(connection->fd);
+			active--;
+			if(started<requests){
+				connection_requests = (requests-started<keep_alive)?requests-started:keep_alive;
+				started += connection_requests;
+				results.connections++;
+				if(start_connection(server, epollfd, connection, connection_requests)){
+					active++;
+				}else{
+					results.failed += connection_requests;
+				}
+			}
+		}
+	}
+	elapsed = (now_us()-start)/1000000;
+
+	// Check if the server has dropped the slow clients
+	for(a=0; a<idle; a++){
+		if(recv(idle_fds[a], buffer, sizeof(buffer), MSG_DONTWAIT)==0){
+			idle_closed++;
+		}
+		close(idle_fds[a]);
+	}
+
+	qsort(results.latencies, results.completed, sizeof(double), compare_latencies);
+	printf("requests:      %d completed, %d failed, %d concurrent, %d idle (%d closed by the server)\n", results.completed, results.failed, concurrency, idle, idle_closed);
+	printf("connections:   %d (%d requests per connection, pipeline depth %d)\n", results.connections, keep_alive, depth);
+	printf("time:          %.3f s\n", elapsed);
+	printf("throughput:    %.0f requests/s, %.1f MB/s\n", (elapsed>0)?results.completed/elapsed:0, (elapsed>0)?results.bytes/elapsed/1000000:0);
+	if(results.completed>0){
+		printf("latency (ms):  p50 %.2f, p90 %.2f, p99 %.2f, max %.2f\n", results.latencies[results.completed/2]/1000, results.latencies[(int)(results.completed*0.90)]/1000, results.latencies[(int)(results.completed*0.99)]/1000, results.latencies[results.completed-1]/1000);
+	}
+
+	close(epollfd);
+	freeaddrinfo(server);
+	free(connections);
+	free(results.latencies);
+	free(idle_fds);
+
+	return (results.failed>0)?M_PROCESSING_FAILED:0;
+}
@@ -36,13 +36,23 @@ const char *gengetopt_args_info_help[] = {
   "  -V, --version                 Print version and exit",
   "  -i, --input=<folder>          Folder with the files to sort",
   "  -o, --output=<folder>         Folder to put the sorted files",
-  "  -a, --serial-algorithm=<algorithm>\n                                Algorithms to use in the sort process  \n                                  (possible values=\"bubble\", \"merge\", \n                                  \"quick\", \"shell\")",
+  "  -a, --serial-algorithm=<algorithm>\n                                Algorithms to use in the sort process  \n                                  (possible values=\"bubble\", \"merge\", \n                                  \"quick\", \"shell\", \"parallel-merge\")",
+  "  -k, --key-field=<field>       Field of each line to use as the sort key (0 for \n                                  the whole line)  (default=`0')",
+  "  -t, --field-separator=<char>  Character that separates the fields (sequences \n                                  of blanks by default)",
+  "      --key-type=<type>         Type of the sort key  (possible \n                                  values=\"string\", \"numeric\", \n                                  \"timestamp\" default=`string')",
+  "      --stable                  Keep the original order of the lines with equal \n                                  keys  (default=off)",
+  "  -u, --unique                  Remove the lines with duplicated keys before \n                                  sorting  (default=off)",
+  "      --threads=<threads>       Number of threads of the parallel algorithms (0 \n                                  for the number of processors)  (default=`0')",
+  "      --clock=<clock>           Clock to time the sorts (the CPU time clocks \n                                  can't be used with the UDP time server)  \n                                  (possible values=\"realtime\", \n                                  \"monotonic\", \"monotonic-raw\", \n                                  \"thread-cputime\", \"process-cputime\" \n                                  default=`monotonic')",
+  "      --udp-timeout=<ms>        Time (ms) to wait for each response of the UDP \n                                  servers (doubled on each retry)  \n                                  (default=`250')",
+  "      --udp-retries=<retries>   Number of times a request to the UDP servers is \n                                  sent again without a response  (default=`4')",
   "\n Mode: Daemon",
   "  -l, --log=<filename>          Filename to log the messages",
   "  -d, --daemon                  Use program as a daemon  (default=off)",
   "\n Mode: UDP time",
   "  -s, --time-server-addr=<ipaddress>\n                                IP address of the UDP time server",
   "  -p, --time-server-port=<portnumber>\n                                The port of the UDP time server",
+  "      --time-samples=<samples>  Number of requests to the UDP time server at the \n                                  start and at the end of each sort  \n                                  (default=`4')",
   "\n Mode: UDP report",
   "      --stats-server=<ipaddress>\n                                IP address of the UDP server to publish the \n                                  results",
   "      --stats-port=<portnumber> The port of the UDP server to publish the \n                                  results",
@@ -68,7 +78,9 @@ cmdline_parser_internal (int argc, char **argv, struct gengetopt_args_info *args
 static int
 cmdline_parser_required2 (struct gengetopt_args_info *args_info, const char *prog_name, const char *additional_error);
 
-const char *cmdline_parser_serial_algorithm_values[] = {"bubble", "merge", "quick", "shell", 0}; /*< Possible values for serial-algorithm. */
+const char *cmdline_parser_serial_algorithm_values[] = {"bubble", "merge", "quick", "shell", "parallel-merge", 0}; /*< Possible values for serial-algorithm. */
+const char *cmdline_parser_key_type_values[] = {"string", "numeric", "timestamp", 0}; /*< Possible values for key-type. */
+const char *cmdline_parser_clock_values[] = {"realtime", "monotonic", "monotonic-raw", "thread-cputime", "process-cputime", 0}; /*< Possible values for clock. */
 
 static char *
 gengetopt_strdup (const char *s);
@@ -81,10 +93,20 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->input_given = 0 ;
   args_info->output_given = 0 ;
   args_info->serial_algorithm_given = 0 ;
+  args_info->key_field_given = 0 ;
+  args_info->field_separator_given = 0 ;
+  args_info->key_type_given = 0 ;
+  args_info->stable_given = 0 ;
+  args_info->unique_given = 0 ;
+  args_info->threads_given = 0 ;
+  args_info->clock_given = 0 ;
+  args_info->udp_timeout_given = 0 ;
+  args_info->udp_retries_given = 0 ;
   args_info->log_given = 0 ;
   args_info->daemon_given = 0 ;
   args_info->time_server_addr_given = 0 ;
   args_info->time_server_port_given = 0 ;
+  args_info->time_samples_given = 0 ;
   args_info->stats_server_given = 0 ;
   args_info->stats_port_given = 0 ;
   args_info->Daemon_mode_counter = 0 ;
@@ -102,12 +124,30 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->output_orig = NULL;
   args_info->serial_algorithm_arg = NULL;
   args_info->serial_algorithm_orig = NULL;
+  args_info->key_field_arg = 0;
+  args_info->key_field_orig = NULL;
+  args_info->field_separator_arg = NULL;
+  args_info->field_separator_orig = NULL;
+  args_info->key_type_arg = key_type_arg_string;
+  args_info->key_type_orig = NULL;
+  args_info->stable_flag = 0;
+  args_info->unique_flag = 0;
+  args_info->threads_arg = 0;
+  args_info->threads_orig = NULL;
+  args_info->clock_arg = clock_arg_monotonic;
+  args_info->clock_orig = NULL;
+  args_info->udp_timeout_arg = 250;
+  args_info->udp_timeout_orig = NULL;
+  args_info->udp_retries_arg = 4;
+  args_info->udp_retries_orig = NULL;
   args_info->log_arg = NULL;
   args_info->log_orig = NULL;
   args_info->daemon_flag = 0;
   args_info->time_server_addr_arg = NULL;
   args_info->time_server_addr_orig = NULL;
   args_info->time_server_port_orig = NULL;
+  args_info->time_samples_arg = 4;
+  args_info->time_samples_orig = NULL;
   args_info->stats_server_arg = NULL;
   args_info->stats_server_orig = NULL;
   args_info->stats_port_orig = NULL;
@@ -125,13 +165,23 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->output_help = gengetopt_args_info_help[3] ;
   args_info->serial_algorithm_help = gengetopt_args_info_help[4] ;
   args_info->serial_algorithm_min = 1;
-  args_info->serial_algorithm_max = 4;
-  args_info->log_help = gengetopt_args_info_help[6] ;
-  args_info->daemon_help = gengetopt_args_info_help[7] ;
-  args_info->time_server_addr_help = gengetopt_args_info_help[9] ;
-  args_info->time_server_port_help = gengetopt_args_info_help[10] ;
-  args_info->stats_server_help = gengetopt_args_info_help[12] ;
-  args_info->stats_port_help = gengetopt_args_info_help[13] ;
+  args_info->serial_algorithm_max = 5;
+  args_info->key_field_help = gengetopt_args_info_help[5] ;
+  args_info->field_separator_help = gengetopt_args_info_help[6] ;
+  args_info->key_type_help = gengetopt_args_info_help[7] ;
+  args_info->stable_help = gengetopt_args_info_help[8] ;
+  args_info->unique_help = gengetopt_args_info_help[9] ;
+  args_info->threads_help = gengetopt_args_info_help[10] ;
+  args_info->clock_help = gengetopt_args_info_help[11] ;
+  args_info->udp_timeout_help = gengetopt_args_info_help[12] ;
+  args_info->udp_retries_help = gengetopt_args_info_help[13] ;
+  args_info->log_help = gengetopt_args_info_help[15] ;
+  args_info->daemon_help = gengetopt_args_info_help[16] ;
+  args_info->time_server_addr_help = gengetopt_args_info_help[18] ;
+  args_info->time_server_port_help = gengetopt_args_info_help[19] ;
+  args_info->time_samples_help = gengetopt_args_info_help[20] ;
+  args_info->stats_server_help = gengetopt_args_info_help[22] ;
+  args_info->stats_port_help = gengetopt_args_info_help[23] ;
   
 }
 
@@ -263,11 +313,20 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->output_orig));
   free_multiple_field (args_info->serial_algorithm_given, (void *)(args_info->serial_algorithm_arg), &(args_info->serial_algorithm_orig));
   args_info->serial_algorithm_arg = 0;
+  free_string_field (&(args_info->key_field_orig));
+  free_string_field (&(args_info->field_separator_arg));
+  free_string_field (&(args_info->field_separator_orig));
+  free_string_field (&(args_info->key_type_orig));
+  free_string_field (&(args_info->threads_orig));
+  free_string_field (&(args_info->clock_orig));
+  free_string_field (&(args_info->udp_timeout_orig));
+  free_string_field (&(args_info->udp_retries_orig));
   free_string_field (&(args_info->log_arg));
   free_string_field (&(args_info->log_orig));
   free_string_field (&(args_info->time_server_addr_arg));
   free_string_field (&(args_info->time_server_addr_orig));
   free_string_field (&(args_info->time_server_port_orig));
+  free_string_field (&(args_info->time_samples_orig));
   free_string_field (&(args_info->stats_server_arg));
   free_string_field (&(args_info->stats_server_orig));
   free_string_field (&(args_info->stats_port_orig));
@@ -359,6 +418,24 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
   if (args_info->output_given)
     write_into_file(outfile, "output", args_info->output_orig, 0);
   write_multiple_into_file(outfile, args_info->serial_algorithm_given, "serial-algorithm", args_info->serial_algorithm_orig, cmdline_parser_serial_algorithm_values);
+  if (args_info->key_field_given)
+    write_into_file(outfile, "key-field", args_info->key_field_orig, 0);
+  if (args_info->field_separator_given)
+    write_into_file(outfile, "field-separator", args_info->field_separator_orig, 0);
+  if (args_info->key_type_given)
+    write_into_file(outfile, "key-type", args_info->key_type_orig, cmdline_parser_key_type_values);
+  if (args_info->stable_given)
+    write_into_file(outfile, "stable", 0, 0 );
+  if (args_info->unique_given)
+    write_into_file(outfile, "unique", 0, 0 );
+  if (args_info->threads_given)
+    write_into_file(outfile, "threads", args_info->threads_orig, 0);
+  if (args_info->clock_given)
+    write_into_file(outfile, "clock", args_info->clock_orig, cmdline_parser_clock_values);
+  if (args_info->udp_timeout_given)
+    write_into_file(outfile, "udp-timeout", args_info->udp_timeout_orig, 0);
+  if (args_info->udp_retries_given)
+    write_into_file(outfile, "udp-retries", args_info->udp_retries_orig, 0);
   if (args_info->log_given)
     write_into_file(outfile, "log", args_info->log_orig, 0);
   if (args_info->daemon_given)
@@ -367,6 +444,8 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "time-server-addr", args_info->time_server_addr_orig, 0);
   if (args_info->time_server_port_given)
     write_into_file(outfile, "time-server-port", args_info->time_server_port_orig, 0);
+  if (args_info->time_samples_given)
+    write_into_file(outfile, "time-samples", args_info->time_samples_orig, 0);
   if (args_info->stats_server_given)
     write_into_file(outfile, "stats-server", args_info->stats_server_orig, 0);
   if (args_info->stats_port_given)
@@ -1011,16 +1090,26 @@ cmdline_parser_internal (
         { "input",	1, NULL, 'i' },
         { "output",	1, NULL, 'o' },
         { "serial-algorithm",	1, NULL, 'a' },
+        { "key-field",	1, NULL, 'k' },
+        { "field-separator",	1, NULL, 't' },
+        { "key-type",	1, NULL, 0 },
+        { "stable",	0, NULL, 0 },
+        { "unique",	0, NULL, 'u' },
+        { "threads",	1, NULL, 0 },
+        { "clock",	1, NULL, 0 },
+        { "udp-timeout",	1, NULL, 0 },
+        { "udp-retries",	1, NULL, 0 },
         { "log",	1, NULL, 'l' },
         { "daemon",	0, NULL, 'd' },
         { "time-server-addr",	1, NULL, 's' },
         { "time-server-port",	1, NULL, 'p' },
+        { "time-samples",	1, NULL, 0 },
         { "stats-server",	1, NULL, 0 },
         { "stats-port",	1, NULL, 0 },
         { 0,  0, 0, 0 }
       };
 
-      c = getopt_long (argc, argv, "hVi:o:a:l:ds:p:", long_options, &option_index);
+      c = getopt_long (argc, argv, "hVi:o:a:k:t:ul:ds:p:", long_options, &option_index);
 
       if (c == -1) break;	/* Exit from `while (1)' loop.  */
 
@@ -1068,6 +1157,40 @@ cmdline_parser_internal (
               additional_error))
             goto failure;
         
+          break;
+        case 'k':	/* Field of each line to use as the sort key (0 for the whole line).  */
+        
+        
+          if (update_arg( (void *)&(args_info->key_field_arg), 
+               &(args_info->key_field_orig), &(args_info->key_field_given),
+              &(local_args_info.key_field_given), optarg, 0, "0", ARG_INT,
+              check_ambiguity, override, 0, 0,
+              "key-field", 'k',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 't':	/* Character that separates the fields (sequences of blanks by default).  */
+        
+        
+          if (update_arg( (void *)&(args_info->field_separator_arg), 
+               &(args_info->field_separator_orig), &(args_info->field_separator_given),
+              &(local_args_info.field_separator_given), optarg, 0, 0, ARG_STRING,
+              check_ambiguity, override, 0, 0,
+              "field-separator", 't',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 'u':	/* Remove the lines with duplicated keys before sorting.  */
+        
+        
+          if (update_arg((void *)&(args_info->unique_flag), 0, &(args_info->unique_given),
+              &(local_args_info.unique_given), optarg, 0, 0, ARG_FLAG,
+              check_ambiguity, override, 1, 0, "unique", 'u',
+              additional_error))
+            goto failure;
+        
           break;
         case 'l':	/* Filename to log the messages.  */
           args_info->Daemon_mode_counter += 1;
@@ -1121,8 +1244,105 @@ cmdline_parser_internal (
           break;
 
         case 0:	/* Long option with no short option */
+          /* Type of the sort key.  */
+          if (strcmp (long_options[option_index].name, "key-type") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->key_type_arg), 
+                 &(args_info->key_type_orig), &(args_info->key_type_given),
+                &(local_args_info.key_type_given), optarg, cmdline_parser_key_type_values, "string", ARG_ENUM,
+                check_ambiguity, override, 0, 0,
+                "key-type", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Keep the original order of the lines with equal keys.  */
+          else if (strcmp (long_options[option_index].name, "stable") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->stable_flag), 0, &(args_info->stable_given),
+                &(local_args_info.stable_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "stable", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Number of threads of the parallel algorithms (0 for the number of processors).  */
+          else if (strcmp (long_options[option_index].name, "threads") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->threads_arg), 
+                 &(args_info->threads_orig), &(args_info->threads_given),
+                &(local_args_info.threads_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "threads", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Clock to time the sorts (the CPU time clocks can't be used with the UDP time server).  */
+          else if (strcmp (long_options[option_index].name, "clock") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->clock_arg), 
+                 &(args_info->clock_orig), &(args_info->clock_given),
+                &(local_args_info.clock_given), optarg, cmdline_parser_clock_values, "monotonic", ARG_ENUM,
+                check_ambiguity, override, 0, 0,
+                "clock", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Time (ms) to wait for each response of the UDP servers (doubled on each retry).  */
+          else if (strcmp (long_options[option_index].name, "udp-timeout") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->udp_timeout_arg), 
+                 &(args_info->udp_timeout_orig), &(args_info->udp_timeout_given),
+                &(local_args_info.udp_timeout_given), optarg, 0, "250", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "udp-timeout", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Number of times a request to the UDP servers is sent again without a response.  */
+          else if (strcmp (long_options[option_index].name, "udp-retries") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->udp_retries_arg), 
+                 &(args_info->udp_retries_orig), &(args_info->udp_retries_given),
+                &(local_args_info.udp_retries_given), optarg, 0, "4", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "udp-retries", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* Number of requests to the UDP time server at the start and at the end of each sort.  */
+          else if (strcmp (long_options[option_index].name, "time-samples") == 0)
+          {
+            args_info->UDP_time_mode_counter += 1;
+          
+          
+            if (update_arg( (void *)&(args_info->time_samples_arg), 
+                 &(args_info->time_samples_orig), &(args_info->time_samples_given),
+                &(local_args_info.time_samples_given), optarg, 0, "4", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "time-samples", '-',
+                additional_error))
+              goto failure;
+          
+          }
           /* IP address of the UDP server to publish the results.  */
-          if (strcmp (long_options[option_index].name, "stats-server") == 0)
+          else if (strcmp (long_options[option_index].name, "stats-server") == 0)
           {
             args_info->UDP_report_mode_counter += 1;
           
@@ -1182,15 +1402,15 @@ cmdline_parser_internal (
   if (args_info->Daemon_mode_counter && args_info->UDP_time_mode_counter) {
     int Daemon_given[] = {args_info->log_given, args_info->daemon_given,  -1};
     const char *Daemon_desc[] = {"--log", "--daemon",  0};
-    int UDP_time_given[] = {args_info->time_server_addr_given, args_info->time_server_port_given,  -1};
-    const char *UDP_time_desc[] = {"--time-server-addr", "--time-server-port",  0};
+    int UDP_time_given[] = {args_info->time_server_addr_given, args_info->time_server_port_given, args_info->time_samples_given,  -1};
+    const char *UDP_time_desc[] = {"--time-server-addr", "--time-server-port", "--time-samples",  0};
     error += check_modes(Daemon_given, Daemon_desc, UDP_time_given, UDP_time_desc);
   }
   if (args_info->UDP_report_mode_counter && args_info->UDP_time_mode_counter) {
     int UDP_report_given[] = {args_info->stats_server_given, args_info->stats_port_given,  -1};
     const char *UDP_report_desc[] = {"--stats-server", "--stats-port",  0};
-    int UDP_time_given[] = {args_info->time_server_addr_given, args_info->time_server_port_given,  -1};
-    const char *UDP_time_desc[] = {"--time-server-addr", "--time-server-port",  0};
+    int UDP_time_given[] = {args_info->time_server_addr_given, args_info->time_server_port_given, args_info->time_samples_given,  -1};
+    const char *UDP_time_desc[] = {"--time-server-addr", "--time-server-port", "--time-samples",  0};
     error += check_modes(UDP_report_given, UDP_report_desc, UDP_time_given, UDP_time_desc);
   }
   
@@ -34,7 +34,9 @@ extern "C" {
 #define CMDLINE_PARSER_VERSION "1.0"
 #endif
 
-enum enum_serial_algorithm { serial_algorithm_arg_bubble = 0 , serial_algorithm_arg_merge, serial_algorithm_arg_quick, serial_algorithm_arg_shell };
+enum enum_serial_algorithm { serial_algorithm_arg_bubble = 0 , serial_algorithm_arg_merge, serial_algorithm_arg_quick, serial_algorithm_arg_shell, serial_algorithm_arg_parallelMINUS_merge };
+enum enum_key_type { key_type_arg_string = 0 , key_type_arg_numeric, key_type_arg_timestamp };
+enum enum_clock { clock_arg_realtime = 0 , clock_arg_monotonic, clock_arg_monotonicMINUS_raw, clock_arg_threadMINUS_cputime, clock_arg_processMINUS_cputime };
 
 /** @brief Where the command line options are stored */
 struct gengetopt_args_info
@@ -52,6 +54,31 @@ struct gengetopt_args_info
   unsigned int serial_algorithm_min; /**< @brief Algorithms to use in the sort process's minimum occurreces */
   unsigned int serial_algorithm_max; /**< @brief Algorithms to use in the sort process's maximum occurreces */
   const char *serial_algorithm_help; /**< @brief Algorithms to use in the sort process help description.  */
+  int key_field_arg;	/**< @brief Field of each line to use as the sort key (0 for the whole line) (default='0').  */
+  char * key_field_orig;	/**< @brief Field of each line to use as the sort key (0 for the whole line) original value given at command line.  */
+  const char *key_field_help; /**< @brief Field of each line to use as the sort key (0 for the whole line) help description.  */
+  char * field_separator_arg;	/**< @brief Character that separates the fields (sequences of blanks by default).  */
+  char * field_separator_orig;	/**< @brief Character that separates the fields (sequences of blanks by default) original value given at command line.  */
+  const char *field_separator_help; /**< @brief Character that separates the fields (sequences of blanks by default) help description.  */
+  enum enum_key_type key_type_arg;	/**< @brief Type of the sort key (default='string').  */
+  char * key_type_orig;	/**< @brief Type of the sort key original value given at command line.  */
+  const char *key_type_help; /**< @brief Type of the sort key help description.  */
+  int stable_flag;	/**< @brief Keep the original order of the lines with equal keys (default=off).  */
+  const char *stable_help; /**< @brief Keep the original order of the lines with equal keys help description.  */
+  int unique_flag;	/**< @brief Remove the lines with duplicated keys before sorting (default=off).  */
+  const char *unique_help; /**< @brief Remove the lines with duplicated keys before sorting help description.  */
+  int threads_arg;	/**< @brief Number of threads of the parallel algorithms (0 for the number of processors) (default='0').  */
+  char * threads_orig;	/**< @brief Number of threads of the parallel algorithms (0 for the number of processors) original value given at command line.  */
+  const char *threads_help; /**< @brief Number of threads of the parallel algorithms (0 for the number of processors) help description.  */
+  enum enum_clock clock_arg;	/**< @brief Clock to time the sorts (the CPU time clocks can't be used with the UDP time server) (default='monotonic').  */
+  char * clock_orig;	/**< @brief Clock to time the sorts (the CPU time clocks can't be used with the UDP time server) original value given at command line.  */
+  const char *clock_help; /**< @brief Clock to time the sorts (the CPU time clocks can't be used with the UDP time server) help description.  */
+  int udp_timeout_arg;	/**< @brief Time (ms) to wait for each response of the UDP servers (doubled on each retry) (default='250').  */
+  char * udp_timeout_orig;	/**< @brief Time (ms) to wait for each response of the UDP servers (doubled on each retry) original value given at command line.  */
+  const char *udp_timeout_help; /**< @brief Time (ms) to wait for each response of the UDP servers (doubled on each retry) help description.  */
+  int udp_retries_arg;	/**< @brief Number of times a request to the UDP servers is sent again without a response (default='4').  */
+  char * udp_retries_orig;	/**< @brief Number of times a request to the UDP servers is sent again without a response original value given at command line.  */
+  const char *udp_retries_help; /**< @brief Number of times a request to the UDP servers is sent again without a response help description.  */
   char * log_arg;	/**< @brief Filename to log the messages.  */
   char * log_orig;	/**< @brief Filename to log the messages original value given at command line.  */
   const char *log_help; /**< @brief Filename to log the messages help description.  */
@@ -63,6 +90,9 @@ struct gengetopt_args_info
   int time_server_port_arg;	/**< @brief The port of the UDP time server.  */
   char * time_server_port_orig;	/**< @brief The port of the UDP time server original value given at command line.  */
   const char *time_server_port_help; /**< @brief The port of the UDP time server help description.  */
+  int time_samples_arg;	/**< @brief Number of requests to the UDP time server at the start and at the end of each sort (default='4').  */
+  char * time_samples_orig;	/**< @brief Number of requests to the UDP time server at the start and at the end of each sort original value given at command line.  */
+  const char *time_samples_help; /**< @brief Number of requests to the UDP time server at the start and at the end of each sort help description.  */
   char * stats_server_arg;	/**< @brief IP address of the UDP server to publish the results.  */
   char * stats_server_orig;	/**< @brief IP address of the UDP server to publish the results original value given at command line.  */
   const char *stats_server_help; /**< @brief IP address of the UDP server to publish the results help description.  */
@@ -75,10 +105,20 @@ struct gengetopt_args_info
   unsigned int input_given ;	/**< @brief Whether input was given.  */
   unsigned int output_given ;	/**< @brief Whether output was given.  */
   unsigned int serial_algorithm_given ;	/**< @brief Whether serial-algorithm was given.  */
+  unsigned int key_field_given ;	/**< @brief Whether key-field was given.  */
+  unsigned int field_separator_given ;	/**< @brief Whether field-separator was given.  */
+  unsigned int key_type_given ;	/**< @brief Whether key-type was given.  */
+  unsigned int stable_given ;	/**< @brief Whether stable was given.  */
+  unsigned int unique_given ;	/**< @brief Whether unique was given.  */
+  unsigned int threads_given ;	/**< @brief Whether threads was given.  */
+  unsigned int clock_given ;	/**< @brief Whether clock was given.  */
+  unsigned int udp_timeout_given ;	/**< @brief Whether udp-timeout was given.  */
+  unsigned int udp_retries_given ;	/**< @brief Whether udp-retries was given.  */
   unsigned int log_given ;	/**< @brief Whether log was given.  */
   unsigned int daemon_given ;	/**< @brief Whether daemon was given.  */
   unsigned int time_server_addr_given ;	/**< @brief Whether time-server-addr was given.  */
   unsigned int time_server_port_given ;	/**< @brief Whether time-server-port was given.  */
+  unsigned int time_samples_given ;	/**< @brief Whether time-samples was given.  */
   unsigned int stats_server_given ;	/**< @brief Whether stats-server was given.  */
   unsigned int stats_port_given ;	/**< @brief Whether stats-port was given.  */
 
@@ -207,6 +247,8 @@ int cmdline_parser_required (struct gengetopt_args_info *args_info,
   const char *prog_name);
 
 extern const char *cmdline_parser_serial_algorithm_values[];  /**< @brief Possible values for serial-algorithm. */
+extern const char *cmdline_parser_key_type_values[];  /**< @brief Possible values for key-type. */
+extern const char *cmdline_parser_clock_values[];  /**< @brief Possible values for clock. */
 
 
 #ifdef __cplusplus
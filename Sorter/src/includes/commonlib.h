@@ -19,7 +19,12 @@ typedef struct algorithm_stat {
 	char* algorithm; 											/**< @brief reference to the algorithm name used on the sort */
 	int niterations;											/**< @brief reference to the number of iterations. */
 	int nswaps;													/**< @brief reference to the number of swaps. */
-	float time;													/**< @brief reference to the time of the operation. */
+	double time;												/**< @brief reference to the time of the operation (ms, with the nanoseconds). */
+	long nbytes;												/**< @brief number of bytes of the sorted file */
+	int nduplicates;											/**< @brief number of lines with duplicated keys removed before the sort (unique mode) */
+	double dedupe_time;											/**< @brief time spent removing the duplicated lines (ms, with the nanoseconds) */
+	float time_saved;											/**< @brief estimated sort time saved by sorting only the distinct lines */
+	float time_uncertainty;										/**< @brief estimated error of the time (when measured with the UDP time server) */
 } ALGORITHM_STAT_T;
 
 /**
@@ -31,7 +36,12 @@ typedef struct shared_algorithm_stat {
 	char algorithm[MAXCHARS]; 									/**< @brief reference to the algorithm name used on the sort */
 	int niterations;											/**< @brief reference to the number of iterations. */
 	int nswaps;													/**< @brief reference to the number of swaps. */
-	float time;													/**< @brief reference to the time of the operation. */
+	double time;												/**< @brief reference to the time of the operation (ms, with the nanoseconds). */
+	long nbytes;												/**< @brief number of bytes of the sorted file */
+	int nduplicates;											/**< @brief number of lines with duplicated keys removed before the sort (unique mode) */
+	double dedupe_time;											/**< @brief time spent removing the duplicated lines (ms, with the nanoseconds) */
+	float time_saved;											/**< @brief estimated sort time saved by sorting only the distinct lines */
+	float time_uncertainty;										/**< @brief estimated error of the time (when measured with the UDP time server) */
 } SHARED_ALGORITHM_STAT_T;
 
 /**
@@ -38,6 +38,62 @@
  */
 #define PORT_RANGE_MAX 65535
 
+/**
+ * Magic number of the binary time protocol ("UT"), on the first 2 bytes of the requests and of the responses
+ */
+#define UDP_TIME_MAGIC 0x5554
+
+/**
+ * Version of the binary time protocol (the servers without it answer with the text time)
+ */
+#define UDP_TIME_VERSION 1
+
+/**
+ * Number of bytes of a binary request: magic (2), version (1), reserved (5) and nonce (8), in network byte order
+ */
+#define UDP_TIME_REQUEST_SIZE 16
+
+/**
+ * Number of bytes of a binary response: magic (2), version (1), clock (1), reserved (4), nonce of the request (8),
+ * receive time (8) and transmit time (8), in network byte order (times in nanoseconds since the epoch)
+ */
+#define UDP_TIME_RESPONSE_SIZE 32
+
+/**
+ * Maximum number of requests to the UDP time server at the start and at the end of each sort
+ */
+#define UDP_TIME_MAXIMUM_SAMPLES 64
+
+/**
+ * Maximum time (ms) to wait for a response of the UDP servers (the timeout of the retries is doubled up to it)
+ */
+#define UDP_MAXIMUM_TIMEOUT 4000
+
+/**
+ * Number of results waiting to be sent to the results server (the results queued with all of them waiting are dropped)
+ */
+#define RESULTS_QUEUE_SIZE 256
+
+/**
+ * Maximum number of bytes of a results datagram (the UDP payload of an Ethernet frame, so a batch is never fragmented)
+ */
+#define RESULTS_BATCH_SIZE 1472
+
+/**
+ * Maximum number of results of a batch (the ones after it aren't acknowledged)
+ */
+#define RESULTS_BATCH_MAXIMUM_RECORDS 32
+
+/**
+ * First line of a batch of results and of its response, followed by a space and the number of the batch ("#BATCH 42")
+ */
+#define RESULTS_BATCH_HEADER "#BATCH"
+
+/**
+ * Time (ms) the results sender waits for more results before sending a batch that isn't full
+ */
+#define RESULTS_BATCH_DELAY 50
+
 /**
  * The nickname for the results server
  */
@@ -78,6 +134,46 @@
  */
 #define HTTP_MAXIMUM_CONNECTIONS 10
 
+/**
+ * Key type constant for the sort keys compared as strings
+ */
+#define KEY_TYPE_STRING 0
+
+/**
+ * Key type constant for the sort keys compared by their numerical value
+ */
+#define KEY_TYPE_NUMERIC 1
+
+/**
+ * Key type constant for the sort keys compared as timestamps
+ */
+#define KEY_TYPE_TIMESTAMP 2
+
+/**
+ * Minimum number of lines that each thread of the parallel algorithms must sort
+ */
+#define PARALLEL_SORT_MINIMUM_RUN 4096
+
+/**
+ * Initial number of slots of a hash map (must be a power of two)
+ */
+#define HASH_MAP_MINIMUM_CAPACITY 16
+
+/**
+ * Maximum fraction of the slots of a hash map in use before it grows
+ */
+#define HASH_MAP_MAXIMUM_LOAD 0.85
+
+/**
+ * Seed of the hash function of the hash maps
+ */
+#define HASH_MAP_SEED 0x9747b28cULL
+
+/**
+ * Initial number of elements of a vector
+ */
+#define VECTOR_MINIMUM_CAPACITY 16
+
 // mutexes
 /**
  * Mutex constant for the statistical control semaphore
@@ -410,4 +506,14 @@
  */
 #define M_NUMBER_OF_FILES 61
 
+/**
+ * Define the exit value for the invalid key specification error
+ */
+#define M_INVALID_KEY_SPECIFICATION 62
+
+/**
+ * Define the exit value for a UDP server without response after all the retries
+ */
+#define M_UDP_SERVER_TIMEOUT 63
+
 #endif /* DEFINITIONS_H_ */
@@ -0,0 +1,357 @@
+/**
+* @file hashlib.c
+* @brief source file for the open addressing hash map
+* @date 2010/01/18 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../3rd/debug.h"
+#include "definitions.h"
+#include "hashlib.h"
+
+/**
+ * @brief Allocate and empty the slots of the hash map for the given capacity
+ * @param map HASH_MAP_T to initialize
+ * @param capacity number of slots (power of two)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void hash_map_allocate_entries(HASH_MAP_T* map, int capacity){
+	// calloc leaves all the distances at 0, so all the slots start empty
+	if((map->entries = calloc(capacity, sizeof(HASH_MAP_ENTRY_T)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+	}
+	map->capacity = capacity;
+	map->maximum_count = (int)(capacity*HASH_MAP_MAXIMUM_LOAD);
+}
+
+/**
+ * @brief Move the entries of the hash map to a new slots array with the given capacity
+ * @param map HASH_MAP_T to resize
+ * @param capacity new number of slots (power of two)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void hash_map_rehash(HASH_MAP_T* map, int capacity){
+	HASH_MAP_ENTRY_T *old_entries = map->entries, entry, swap;
+	int old_capacity = map->capacity, a, position, mask;
+
+	hash_map_allocate_entries(map, capacity);
+	mask = capacity-1;
+
+	for(a=0; a<old_capacity; a++){
+		if(old_entries[a].distance==0){
+			continue;
+		}
+		// The keys are already distinct, so just place them with the Robin Hood rule (the stored hash avoids hashing them again)
+		entry = old_entries[a];
+		entry.distance = 1;
+		position = entry.hash & mask;
+		while(map->entries[position].distance!=0){
+			if(map->entries[position].distance<entry.distance){
+				swap = map->entries[position];
+				map->entries[position] = entry;
+				entry = swap;
+			}
+			position = (position+1) & mask;
+			entry.distance++;
+		}
+		map->entries[position] = entry;
+	}
+	free(old_entries);
+}
+
+/**
+ * @brief Calculate the capacity needed to store the given number of keys without growing
+ * @param elements number of keys
+ * @return integer with the capacity (power of two)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int hash_map_capacity_for(int elements){
+	int capacity = HASH_MAP_MINIMUM_CAPACITY;
+
+	while((int)(capacity*HASH_MAP_MAXIMUM_LOAD)<elements){
+		capacity <<= 1;
+	}
+	return capacity;
+}
+
+/**
+ * @brief Calculate a 64 bits hash of a sequence of bytes (MurmurHash64A, a fast non cryptographic hash)
+ * @param key with the bytes to hash
+ * @param length number of bytes
+ * @param seed to initialize the hash
+ * @return unsigned long long with the hash
+ *
+ * @see https://github.com/aappleby/smhasher/blob/master/src/MurmurHash2.cpp
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+unsigned long long hash_bytes(const void* key, int length, unsigned long long seed){
+	const unsigned long long m = 0xc6a4a7935bd1e995ULL;
+	const int r = 47;
+	const unsigned char* data = (const unsigned char*) key;
+	const unsigned char* end = data+(length & ~7);
+	unsigned long long h = seed ^ (length*m), k;
+
+	// Mix 8 bytes at a time (memcpy allows unaligned keys, and compiles to a single load)
+	while(data!=end){
+		memcpy(&k, data, sizeof(k));
+		data += 8;
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		h ^= k;
+		h *= m;
+	}
+
+	// Mix the remaining bytes
+	switch(length & 7){
+		case 7: h ^= (unsigned long long)(data[6]) << 48; // fall through
+		case 6: h ^= (unsigned long long)(data[5]) << 40; // fall through
+		case 5: h ^= (unsigned long long)(data[4]) << 32; // fall through
+		case 4: h ^= (unsigned long long)(data[3]) << 24; // fall through
+		case 3: h ^= (unsigned long long)(data[2]) << 16; // fall through
+		case 2: h ^= (unsigned long long)(data[1]) << 8; // fall through
+		case 1: h ^= (unsigned long long)(data[0]);
+			h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+}
+
+/**
+ * @brief Create a hash map, with room for the given number of keys
+ * @param elements number of keys to reserve room for (0 for the minimum capacity)
+ * @return HASH_MAP_T pointer with the hash map
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+HASH_MAP_T* hash_map_create(int elements){
+	HASH_MAP_T* map = NULL;
+
+	if((map=(HASH_MAP_T *)malloc(sizeof(HASH_MAP_T)))!=NULL){
+		map->count = 0;
+		hash_map_allocate_entries(map, hash_map_capacity_for(elements));
+	}else{
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+	}
+	return map;
+}
+
+/**
+ * @brief Free the memory of the hash map (the keys and the values are not freed)
+ * @param map HASH_MAP_T to free
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void hash_map_free(HASH_MAP_T* map){
+	free(map->entries);
+	map->entries = NULL;
+	map->capacity = map->count = map->maximum_count = 0;
+	free(map);
+}
+
+/**
+ * @brief Grow the hash map to store the given number of keys without any further rehash
+ * @param map HASH_MAP_T to grow
+ * @param elements number of keys
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void hash_map_reserve(HASH_MAP_T* map, int elements){
+	int capacity = hash_map_capacity_for(elements);
+
+	if(capacity>map->capacity){
+		hash_map_rehash(map, capacity);
+	}
+}
+
+/**
+ * @brief Insert a key on the hash map, if the key isn't there yet
+ * @param map HASH_MAP_T to insert into
+ * @param key with the bytes of the key (the map keeps the reference, not a copy)
+ * @param length number of bytes of the key
+ * @param value to store with the key (can't be NULL)
+ * @return the value already stored with the key, or NULL if the key was inserted
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* hash_map_insert(HASH_MAP_T* map, const void* key, int length, void* value){
+	HASH_MAP_ENTRY_T entry, swap, *slot;
+	int position, mask;
+
+	if(map->count>=map->maximum_count){
+		hash_map_rehash(map, map->capacity<<1);
+	}
+
+	entry.hash = (unsigned int) hash_bytes(key, length, HASH_MAP_SEED);
+	entry.distance = 1;
+	entry.key = key;
+	entry.length = length;
+	entry.value = value;
+
+	mask = map->capacity-1;
+	position = entry.hash & mask;
+
+	// Search the key until an empty slot or a key closer to its home slot (Robin Hood: the key would be there)
+	for(;;){
+		slot = &(map->entries[position]);
+		if(slot->distance<entry.distance){
+			break;
+		}
+		if(slot->hash==entry.hash && slot->length==length && memcmp(slot->key, key, length)==0){
+			return slot->value;
+		}
+		position = (position+1) & mask;
+		entry.distance++;
+	}
+
+	// Take the slot and shift the richer entries forward until an empty slot
+	while(map->entries[position].distance!=0){
+		if(map->entries[position].distance<entry.distance){
+			swap = map->entries[position];
+			map->entries[position] = entry;
+			entry = swap;
+		}
+		position = (position+1) & mask;
+		entry.distance++;
+	}
+	map->entries[position] = entry;
+	map->count++;
+
+	return NULL;
+}
+
+/**
+ * @brief Find the position of a key on the hash map
+ * @param map HASH_MAP_T to search
+ * @param key with the bytes of the key
+ * @param length number of bytes of the key
+ * @return integer with the position of the slot with the key, -1 if not found
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int hash_map_position(HASH_MAP_T* map, const void* key, int length){
+	unsigned int hash = (unsigned int) hash_bytes(key, length, HASH_MAP_SEED);
+	int mask = map->capacity-1, position = hash & mask, distance = 1;
+	HASH_MAP_ENTRY_T* slot;
+
+	for(;;){
+		slot = &(map->entries[position]);
+		if(slot->distance<distance){
+			return -1;
+		}
+		if(slot->hash==hash && slot->length==length && memcmp(slot->key, key, length)==0){
+			return position;
+		}
+		position = (position+1) & mask;
+		distance++;
+	}
+}
+
+/**
+ * @brief Find the value stored with a key
+ * @param map HASH_MAP_T to search
+ * @param key with the bytes of the key
+ * @param length number of bytes of the key
+ * @return the value stored with the key, NULL if not found
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* hash_map_find(HASH_MAP_T* map, const void* key, int length){
+	int position = hash_map_position(map, key, length);
+
+	return (position<0)?NULL:map->entries[position].value;
+}
+
+/**
+ * @brief Remove a key from the hash map
+ * @param map HASH_MAP_T to remove from
+ * @param key with the bytes of the key
+ * @param length number of bytes of the key
+ * @return the value that was stored with the key, NULL if not found
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* hash_map_remove(HASH_MAP_T* map, const void* key, int length){
+	int position = hash_map_position(map, key, length), next, mask = map->capacity-1;
+	void* value;
+
+	if(position<0){
+		return NULL;
+	}
+	value = map->entries[position].value;
+
+	// Shift the following entries of the cluster one slot back, so no tombstones are needed
+	next = (position+1) & mask;
+	while(map->entries[next].distance>1){
+		map->entries[position] = map->entries[next];
+		map->entries[position].distance--;
+		position = next;
+		next = (next+1) & mask;
+	}
+	map->entries[position].distance = 0;
+	map->count--;
+
+	return value;
+}
+
+/**
+ * @brief Remove all the keys from the hash map, keeping its capacity
+ * @param map HASH_MAP_T to clear
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void hash_map_clear(HASH_MAP_T* map){
+	memset(map->entries, 0, sizeof(HASH_MAP_ENTRY_T)*map->capacity);
+	map->count = 0;
+}
+
+/**
+ * @brief Get the number of keys on the hash map
+ * @param map HASH_MAP_T to count
+ * @return integer with the number of keys
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int hash_map_count(HASH_MAP_T* map){
+	return map->count;
+}
+
+/**
+ * @brief Iterate over the entries of the hash map (in no particular order)
+ * @param map HASH_MAP_T to iterate
+ * @param position with the iteration state (set to 0 before the first call)
+ * @param key to store the reference to the key of the entry (can be NULL)
+ * @param length to store the number of bytes of the key (can be NULL)
+ * @param value to store the value of the entry (can be NULL)
+ * @return integer TRUE if an entry was found, FALSE at the end of the map
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int hash_map_next(HASH_MAP_T* map, int* position, const void** key, int* length, void** value){
+	HASH_MAP_ENTRY_T* slot;
+
+	while(*position<map->capacity){
+		slot = &(map->entries[(*position)++]);
+		if(slot->distance!=0){
+			if(key!=NULL) *key = slot->key;
+			if(length!=NULL) *length = slot->length;
+			if(value!=NULL) *value = slot->value;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
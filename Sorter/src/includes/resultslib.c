@@ -0,0 +1,290 @@
+/**
+* @file resultslib.c
+* @brief Source file for the asynchronous sender of the results to the UDP results server
+*
+* The sort loop only formats each result and adds it to a bounded queue; the sender thread takes all the queued
+* results at once and sends them in batches, each one with its timeout and retries, while the next files are sorted.
+*
+* A batch is a datagram with a first line with RESULTS_BATCH_HEADER and its number, and then a result on each line.
+* The response has the same first line and then the RESULTS_SERVER_* code of each result, on the same order; a retry
+* keeps the number of the batch, so the server answers it without counting its results again. A server that answers
+* without the first line only accepts the results on their own, so they are sent that way for the rest of the run.
+*
+* @date 2010/02/16 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "../3rd/debug.h"
+#include "definitions.h"
+#include "aux.h"
+#include "commonlib.h"
+#include "sorterlib.h"
+#include "resultslib.h"
+
+/**
+ * @brief Send a result to the results server, and wait for its response
+ * @param rur_info with the connection information (and the timeout and retries)
+ * @param data with the formatted result
+ * @return integer TRUE if accepted, FALSE if refused by the server, -1 without response after all the retries
+ *
+ * The responses don't identify the result: the responses already received (late ones of older results) are discarded
+ * before the send, but a response still on the way can be taken as the response of this one.
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int send_udp_result(REMOTE_UDP_REQUEST_T rur_info, char* data){
+	char response[MAXCHARS]="";				// To store the server response
+	int endindex, retry, timeout = rur_info.timeout;
+	struct timespec deadline;
+
+	// Discard the late responses of the older results
+	while(recv(rur_info.sock_fd, response, sizeof(char)*(MAXCHARS-1), MSG_DONTWAIT)>=0){
+		MY_DEBUG("\nLate response discarded\n");
+	}
+	for(retry=0; retry<=rur_info.retries; retry++){
+		// Send a request to the server
+		if (sendto(rur_info.sock_fd, data, strlen(data)*sizeof(char), 0, (struct sockaddr *) rur_info.server_addr, sizeof(*(rur_info.server_addr))) < 0){
+			ERROR(M_SENDTO_ERROR, "\nError while sending the data to the server\n");
+		}
+		set_udp_deadline(&deadline, timeout);
+		// Get a response from the server
+		if((endindex = receive_udp_response(rur_info, response, sizeof(char)*(MAXCHARS-1), &deadline))>=0){
+			// Terminate the string from the response
+			response[endindex]=0;
+			MY_DEBUG("\nThe server response was %s\n",response);
+			return (strncmp(response, RESULTS_SERVER_OK, strlen(RESULTS_SERVER_OK))==0)?TRUE:FALSE;
+		}
+		MY_DEBUG("\nNo response from the results server after %d ms\n", timeout);
+		timeout = next_udp_timeout(timeout);
+	}
+	return -1;
+}
+
+/**
+ * @brief Send a batch with the first queued results to the results server, and wait for the code of each one
+ * @param sender RESULTS_SENDER_T with the queue, the connection and the counters
+ * @param first position of the first result to send
+ * @param count number of results to send
+ * @return integer with the number of results sent on the batch (and counted), 0 if the server doesn't accept batches
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int send_udp_batch(RESULTS_SENDER_T* sender, int first, int count){
+	char request[RESULTS_BATCH_SIZE];		// To store the batch
+	char response[MAXCHARS];				// To store the server response
+	char *record, *line, *next;
+	int header_length, length, record_length, records, endindex, retry, timeout = sender->rur_info.timeout, a;
+	struct timespec deadline;
+
+	// Build the batch, with the results that fit on a datagram
+	header_length = length = sprintf(request, "%s %llu\n", RESULTS_BATCH_HEADER, ++(sender->batch));
+	for(records=0; records<count && records<RESULTS_BATCH_MAXIMUM_RECORDS; records++){
+		record = sender->records[(first+records)%RESULTS_QUEUE_SIZE];
+		record_length = strlen(record);
+		if(length+record_length+1>RESULTS_BATCH_SIZE){
+			break;
+		}
+		memcpy(request+length, record, record_length);
+		length += record_length;
+		request[length++] = '\n';
+	}
+
+	for(retry=0; retry<=sender->rur_info.retries; retry++){
+		// Send the batch to the server
+		if (sendto(sender->rur_info.sock_fd, request, length, 0, (struct sockaddr *) sender->rur_info.server_addr, sizeof(*(sender->rur_info.server_addr))) < 0){
+			ERROR(M_SENDTO_ERROR, "\nError while sending the data to the server\n");
+		}
+		set_udp_deadline(&deadline, timeout);
+		// Get the response from the server
+		while((endindex = receive_udp_response(sender->rur_info, response, sizeof(char)*(MAXCHARS-1), &deadline))>=0){
+			// Terminate the string from the response
+			response[endindex]=0;
+			if(strncmp(response, RESULTS_BATCH_HEADER, strlen(RESULTS_BATCH_HEADER))!=0){
+				MY_DEBUG("\nThe results server doesn't accept batches (response %s)\n", response);
+				sender->batched = FALSE;
+				return 0;
+			}
+			if(strncmp(response, request, header_length)!=0){
+				MY_DEBUG("\nResponse to an older batch discarded\n");
+				continue;
+			}
+			// The code of each result
+			line = response+header_length;
+			for(a=0; a<records; a++){
+				if(*line=='\0'){
+					sender->lost += records-a;
+					break;
+				}
+				if((next = strchr(line, '\n'))!=NULL){
+					*next = '\0';
+				}
+				if(strcmp(line, RESULTS_SERVER_OK)==0){
+					sender->accepted++;
+				}else{
+					MY_DEBUG("\nThe server refused %s: %s\n", sender->records[(first+a)%RESULTS_QUEUE_SIZE], line);
+					sender->rejected++;
+				}
+				line = (next!=NULL)?next+1:line+strlen(line);
+			}
+			return records;
+		}
+		MY_DEBUG("\nNo response from the results server after %d ms\n", timeout);
+		timeout = next_udp_timeout(timeout);
+	}
+	sender->lost += records;
+	return records;
+}
+
+/**
+ * @brief Send the queued results until the sender is stopped (function of the sender thread)
+ * @param arg RESULTS_SENDER_T with the queue
+ * @return NULL
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void *results_sender_serve(void *arg){
+	RESULTS_SENDER_T *sender = (RESULTS_SENDER_T*) arg;
+	struct timespec deadline;
+	int first, count, sent, a;
+
+	while(1){
+		pthread_mutex_lock(&(sender->mutex));
+		while(sender->count==0 && !sender->to_exit){
+			pthread_cond_wait(&(sender->queued), &(sender->mutex));
+		}
+		if(sender->count==0){
+			pthread_mutex_unlock(&(sender->mutex));
+			break;
+		}
+		// Wait a little for more results, so the batch is fuller (the sorts don't wait for it)
+		if(sender->batched==TRUE){
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_nsec += RESULTS_BATCH_DELAY*1000000L;
+			if(deadline.tv_nsec>=1000000000L){
+				deadline.tv_sec++;
+				deadline.tv_nsec -= 1000000000L;
+			}
+			while(sender->count<RESULTS_BATCH_MAXIMUM_RECORDS && !sender->to_exit){
+				if(pthread_cond_timedwait(&(sender->queued), &(sender->mutex), &deadline)!=0){
+					break;
+				}
+			}
+		}
+		// Take all the queued results: they stay on the queue (the new ones are added after them) until sent
+		first = sender->first;
+		count = sender->count;
+		pthread_mutex_unlock(&(sender->mutex));
+
+		for(a=0; a<count; a+=sent){
+			if(sender->batched==TRUE && (sent = send_udp_batch(sender, first+a, count-a))>0){
+				continue;
+			}
+			// A result on its own
+			switch(send_udp_result(sender->rur_info, sender->records[(first+a)%RESULTS_QUEUE_SIZE])){
+				case TRUE:
+					sender->accepted++;
+					break;
+				case FALSE:
+					sender->rejected++;
+					break;
+				default:
+					sender->lost++;
+			}
+			sent = 1;
+		}
+
+		pthread_mutex_lock(&(sender->mutex));
+		sender->first = (first+count)%RESULTS_QUEUE_SIZE;
+		sender->count -= count;
+		pthread_mutex_unlock(&(sender->mutex));
+	}
+	return NULL;
+}
+
+/**
+ * @brief Start the results sender thread
+ * @param sender RESULTS_SENDER_T to initialize
+ * @param rur_info with the connection information (and the timeout and retries)
+ * @return integer 0 on success, the error code otherwise
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int start_results_sender(RESULTS_SENDER_T* sender, REMOTE_UDP_REQUEST_T rur_info){
+	struct timeval now;
+
+	memset(sender, 0, sizeof(RESULTS_SENDER_T));
+	sender->rur_info = rur_info;
+	sender->batched = TRUE;
+	// The numbers of the batches start on a value of this process
+	gettimeofday(&now, NULL);
+	sender->batch = ((unsigned long long)getpid()<<40)^((unsigned long long)now.tv_sec<<20)^now.tv_usec;
+	if((sender->records = malloc(sizeof(*(sender->records))*RESULTS_QUEUE_SIZE))==NULL){
+		return M_FAILED_MEMORY_ALLOCATION;
+	}
+	if(pthread_mutex_init(&(sender->mutex), NULL)!=0){
+		free(sender->records);
+		return M_PTHREAD_MUTEX_INIT_FAILED;
+	}
+	pthread_cond_init(&(sender->queued), NULL);
+	if(pthread_create(&(sender->thread), NULL, results_sender_serve, sender)!=0){
+		pthread_cond_destroy(&(sender->queued));
+		pthread_mutex_destroy(&(sender->mutex));
+		free(sender->records);
+		return M_PTHREAD_CREATE_FAILED;
+	}
+	return 0;
+}
+
+/**
+ * @brief Queue a result to be sent to the results server (without waiting for the server)
+ * @param sender RESULTS_SENDER_T with the queue
+ * @param stat with the statistical data
+ * @param nickname with the name of the group
+ * @param machine_model_name with the model name of the computer which sorted the file
+ * @param md5sum of the sorted file
+ *
+ * With the queue full, the result is dropped (and counted).
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void queue_udp_result(RESULTS_SENDER_T* sender, ALGORITHM_STAT_T* stat, char* nickname, char* machine_model_name, char* md5sum){
+	pthread_mutex_lock(&(sender->mutex));
+	if(sender->count<RESULTS_QUEUE_SIZE){
+		// Build the data string to send
+		snprintf(sender->records[(sender->first+sender->count)%RESULTS_QUEUE_SIZE], MAXCHARS, "%s,%s,%s,%s,%s,%.0f", nickname, machine_model_name, stat->filename, md5sum, stat->algorithm, stat->time);
+		sender->count++;
+		pthread_cond_signal(&(sender->queued));
+	}else{
+		sender->dropped++;
+	}
+	pthread_mutex_unlock(&(sender->mutex));
+}
+
+/**
+ * @brief Wait for the sender thread to send the queued results, and free its resources
+ * @param sender RESULTS_SENDER_T to stop
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void stop_results_sender(RESULTS_SENDER_T* sender){
+	pthread_mutex_lock(&(sender->mutex));
+	sender->to_exit = TRUE;
+	pthread_cond_signal(&(sender->queued));
+	pthread_mutex_unlock(&(sender->mutex));
+	pthread_join(sender->thread, NULL);
+
+	pthread_cond_destroy(&(sender->queued));
+	pthread_mutex_destroy(&(sender->mutex));
+	free(sender->records);
+	sender->records = NULL;
+}
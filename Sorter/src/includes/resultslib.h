@@ -0,0 +1,41 @@
+/**
+* @file resultslib.h
+* @brief Header file for the asynchronous sender of the results to the UDP results server
+* @date 2010/02/16 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef RESULTSLIB_H_
+#define RESULTSLIB_H_
+
+#include <pthread.h>
+
+/**
+ * @brief Type declaration to a structure to store the data of the results sender thread, with the queue of the results
+ * to send (bounded, so the sorts never wait for the server)
+ *
+ * The results are sent in batches of up to RESULTS_BATCH_MAXIMUM_RECORDS results (and RESULTS_BATCH_SIZE bytes), each
+ * one answered with the code of each of its results
+ */
+typedef struct results_sender {
+	REMOTE_UDP_REQUEST_T rur_info;				/**< @brief connection to the results server (with the timeout and retries) */
+	char (*records)[MAXCHARS];					/**< @brief results to send, formatted (circular, RESULTS_QUEUE_SIZE of them) */
+	int first;									/**< @brief position of the oldest result of the queue */
+	int count;									/**< @brief number of results on the queue (including the ones being sent) */
+	int to_exit;								/**< @brief TRUE when no more results are queued (the thread exits with the queue empty) */
+	pthread_mutex_t mutex;						/**< @brief lock of the queue */
+	pthread_cond_t queued;						/**< @brief signaled when a result is queued, or to exit */
+	pthread_t thread;							/**< @brief the thread */
+	int batched;								/**< @brief TRUE while the results are sent in batches (FALSE for a server that only accepts them on their own) */
+	unsigned long long batch;					/**< @brief number of the last batch sent (the first one is random, so the processes don't share them) */
+	long accepted;								/**< @brief number of results accepted by the server (only changed by the thread) */
+	long rejected;								/**< @brief number of results refused by the server (only changed by the thread) */
+	long lost;									/**< @brief number of results without response after all the retries (only changed by the thread) */
+	long dropped;								/**< @brief number of results not queued, with the queue full */
+} RESULTS_SENDER_T;
+
+int start_results_sender(RESULTS_SENDER_T*, REMOTE_UDP_REQUEST_T);
+void queue_udp_result(RESULTS_SENDER_T*, ALGORITHM_STAT_T*, char*, char*, char*);
+void stop_results_sender(RESULTS_SENDER_T*);
+
+#endif /* RESULTSLIB_H_ */
@@ -8,7 +8,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <unistd.h>
+#include <time.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
@@ -16,6 +18,9 @@
 #include <sys/sem.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#include <endian.h>
+#include <errno.h>
+#include <poll.h>
 
 #include "../3rd/debug.h"
 #include "../3rd/semaforos.h"
@@ -23,6 +28,17 @@
 #include "aux.h"
 #include "commonlib.h"
 #include "sorterlib.h"
+#include "hashlib.h"
+
+/**
+ * @brief Nonce of the last request to the time server (the first one is random, so the processes don't share them)
+ */
+static uint64_t udp_time_nonce = 0;
+
+/**
+ * @brief Clock to time the sorts
+ */
+static clockid_t _sort_clock = CLOCK_MONOTONIC;
 
 /**
  * @brief This function allocates the necessary memory to reference the lines of a file in memory
@@ -48,6 +64,9 @@ FILE_LINES_T* allocate_memory_for_lines(int numlines){
 			flines->lines=lines;
 			// Store the number of lines on the structure
 			flines->num_lines = numlines;
+			// The sort keys are only built on request
+			flines->keys = NULL;
+			flines->key_spec = NULL;
 		}else{
 			ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
 		}
@@ -72,13 +91,17 @@ void free_memory_of_lines(FILE_LINES_T* flines){
 	}
 	free(flines->lines);
 	flines->lines=NULL;
+	if(flines->keys!=NULL){
+		free(flines->keys);
+		flines->keys=NULL;
+	}
 	flines->num_lines=0;
 	free(flines);
 	flines=NULL;
 }
 
 /**
- * @brief Create a partial clone from a FILE_LINES_T object (just the index)
+ * @brief Create a partial clone from a FILE_LINES_T object (just the index and the sort keys)
  * @param flines FILE_LINES_T to clone
  * @return FILE_LINES_T clone
  *
@@ -93,6 +116,14 @@ FILE_LINES_T* clone_of_lines(FILE_LINES_T* flines){
 		for(a=0;a<flines->num_lines;a++){
 			flines_clone->lines[a]=flines->lines[a];
 		}
+		// The keys are sorted in place, so each clone needs its own copy of them
+		if(flines->keys!=NULL){
+			if((flines_clone->keys=malloc(sizeof(SORT_KEY_T)*flines->num_lines))==NULL){
+				ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+			}
+			memcpy(flines_clone->keys, flines->keys, sizeof(SORT_KEY_T)*flines->num_lines);
+		}
+		flines_clone->key_spec = flines->key_spec;
 	}
 	return flines_clone;
 }
@@ -115,6 +146,9 @@ int copy_lines_from_clone(FILE_LINES_T* flines_src, FILE_LINES_T* flines_dest){
 	for(a=0;a<flines_src->num_lines;a++){
 		flines_dest->lines[a]=flines_src->lines[a];
 	}
+	if(flines_src->keys!=NULL && flines_dest->keys!=NULL){
+		memcpy(flines_dest->keys, flines_src->keys, sizeof(SORT_KEY_T)*flines_src->num_lines);
+	}
 	return TRUE;
 }
 
@@ -132,6 +166,10 @@ void free_memory_of_clone_of_lines(FILE_LINES_T* flines){
 	}
 	free(flines->lines);
 	flines->lines=NULL;
+	if(flines->keys!=NULL){
+		free(flines->keys);
+		flines->keys=NULL;
+	}
 	flines->num_lines=0;
 	free(flines);
 	flines=NULL;
@@ -156,6 +194,11 @@ ALGORITHM_STAT_T* allocate_memory_for_stat(char* filename, char* algorithm){
 		stat->nlines = 0;
 		stat->nswaps = 0;
 		stat->time=0;
+		stat->nbytes = 0;
+		stat->nduplicates = 0;
+		stat->dedupe_time = 0;
+		stat->time_saved = 0;
+		stat->time_uncertainty = 0;
 	}else{
 		ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
 	}
@@ -177,6 +220,11 @@ void reset_stat(ALGORITHM_STAT_T* stat, char* filename, char* algorithm){
 	stat->nlines = 0;
 	stat->nswaps = 0;
 	stat->time=0;
+	stat->nbytes = 0;
+	stat->nduplicates = 0;
+	stat->dedupe_time = 0;
+	stat->time_saved = 0;
+	stat->time_uncertainty = 0;
 }
 
 /**
@@ -378,6 +426,11 @@ void copy_stat(SHARED_ALGORITHM_STAT_T* stat_dest, ALGORITHM_STAT_T stat_src){
 	stat_dest->nlines = stat_src.nlines;
 	stat_dest->nswaps = stat_src.nswaps;
 	stat_dest->time = stat_src.time;
+	stat_dest->nbytes = stat_src.nbytes;
+	stat_dest->nduplicates = stat_src.nduplicates;
+	stat_dest->dedupe_time = stat_src.dedupe_time;
+	stat_dest->time_saved = stat_src.time_saved;
+	stat_dest->time_uncertainty = stat_src.time_uncertainty;
 }
 
 /**
@@ -442,6 +495,29 @@ FILE_LINES_T* read_file(char* filename, int maxchars){
 	return flines;
 }
 
+/**
+ * @brief Set the clock to time the sorts
+ * @param clock clockid_t of the clock (CLOCK_REALTIME, CLOCK_MONOTONIC, CLOCK_MONOTONIC_RAW, CLOCK_THREAD_CPUTIME_ID or CLOCK_PROCESS_CPUTIME_ID)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void set_sort_clock(clockid_t clock){
+	_sort_clock = clock;
+}
+
+/**
+ * @brief Get the current time of the clock of the sorts
+ * @return long long with the time (ns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+long long get_sort_clock_time(void){
+	struct timespec now;
+
+	clock_gettime(_sort_clock, &now);
+	return now.tv_sec*1000000000LL+now.tv_nsec;
+}
+
 /**
  * Sort the lines with the specified algorithm function
  *
@@ -454,60 +530,227 @@ FILE_LINES_T* read_file(char* filename, int maxchars){
  * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
 FILE_LINES_T* sort_lines(FILE_LINES_T* flines, ALGORITHM_FUNC algorithm_function, ALGORITHM_STAT_T* stat, REMOTE_UDP_REQUEST_T rur_info){
-	struct timeval start, end;
-	unsigned long long udp_start=0, udp_end=0;
+	UDP_TIME_OFFSET_T offset_start, offset_end;
+	long long local_start, local_end;
 
 	if(rur_info.sock_fd>0){
-		udp_start = get_udp_time(rur_info);
+		// The offsets of the server clock are measured outside of the sort, which is timed with the local clock
+		if(get_udp_time_offset(rur_info, &offset_start)!=TRUE){
+			ERROR(M_UDP_SERVER_TIMEOUT, "\nThe time server didn't answer after %d retries\n", rur_info.retries);
+		}
+		local_start = get_sort_clock_time();
 		// Call the sorter algorithm function
 		algorithm_function(flines, stat);
-		udp_end = get_udp_time(rur_info);
+		local_end = get_sort_clock_time();
+		if(get_udp_time_offset(rur_info, &offset_end)!=TRUE){
+			ERROR(M_UDP_SERVER_TIMEOUT, "\nThe time server didn't answer after %d retries\n", rur_info.retries);
+		}
 
-		// Save the difference
-		stat->time = ((float)(udp_end-udp_start))/1000;
+		// Save the difference on the server clock (ms), with the error of both offsets
+		stat->time = ((local_end-local_start)+(offset_end.offset-offset_start.offset))/1000000.0;
+		stat->time_uncertainty = (offset_start.uncertainty+offset_end.uncertainty)/1000000.0;
 	}else{
 		// start ticking
-		gettimeofday(&start, NULL);
+		local_start = get_sort_clock_time();
 		// Call the sorter algorithm function
 		algorithm_function(flines, stat);
 		// stop timer
-		gettimeofday(&end, NULL);
+		local_end = get_sort_clock_time();
 
-		// Save the difference
-		stat->time = time_diff(start,end)*1000;
+		// Save the difference (ms)
+		stat->time = (local_end-local_start)/1000000.0;
 	}
 
+	// Put the lines in the order of the sorted keys
+	apply_sorted_keys(flines);
+
 	return flines;
 }
 
 /**
- * @brief Get a timestamp using the given parameters
+ * @brief Set the deadline of a response
+ * @param deadline to store the time (CLOCK_MONOTONIC) to stop waiting
+ * @param timeout time (ms) from now
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void set_udp_deadline(struct timespec* deadline, int timeout){
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeout/1000;
+	deadline->tv_nsec += (timeout%1000)*1000000L;
+	if(deadline->tv_nsec>=1000000000L){
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000L;
+	}
+}
+
+/**
+ * @brief Get the time to wait for the response to the next retry of a request (exponential backoff)
+ * @param timeout time (ms) waited for the last one
+ * @return integer with the double of the timeout, up to UDP_MAXIMUM_TIMEOUT
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int next_udp_timeout(int timeout){
+	return (timeout>UDP_MAXIMUM_TIMEOUT/2)?UDP_MAXIMUM_TIMEOUT:timeout*2;
+}
+
+/**
+ * @brief Wait for a datagram from the server, until a deadline
  * @param rur_info with the connection information
- * @return timestamp returned by the server
+ * @param response to store the datagram
+ * @param size of the response buffer
+ * @param deadline time (CLOCK_MONOTONIC) to stop waiting
+ * @return integer with the length of the datagram, -1 if none arrived before the deadline
+ *
+ * The datagrams from other addresses are discarded.
  *
  * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-unsigned long long get_udp_time(REMOTE_UDP_REQUEST_T rur_info){
-	socklen_t server_length;
-	char response[255];
-	int endindex;
-	unsigned long long timestamp;
+int receive_udp_response(REMOTE_UDP_REQUEST_T rur_info, char* response, int size, struct timespec* deadline){
+	struct sockaddr_in source;				// To store the address of each received datagram
+	socklen_t source_length;
+	struct pollfd pfd;
+	struct timespec now;
+	long long remaining;
+	int length;
 
-	server_length=sizeof(*(rur_info.server_addr));
-	// Send a request to the server
-	if (sendto(rur_info.sock_fd, NULL, 0, 0, (struct sockaddr *) rur_info.server_addr, server_length) < 0){
-		ERROR(M_SENDTO_ERROR, "\nError while sending the request to the server\n");
+	pfd.fd = rur_info.sock_fd;
+	pfd.events = POLLIN;
+	while(1){
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		remaining = (deadline->tv_sec-now.tv_sec)*1000000000LL+(deadline->tv_nsec-now.tv_nsec);
+		if(remaining<=0){
+			return -1;
+		}
+		// Wait for the rest of the time (rounded up to the next ms)
+		switch(poll(&pfd, 1, (int)((remaining+999999)/1000000))){
+			case -1:
+				if(errno==EINTR){
+					continue;
+				}
+				ERROR(M_RECVFROM_ERROR, "\nError while waiting for the response from the server\n");
+			case 0:
+				continue;
+		}
+		source_length = sizeof(source);
+		if ((length = recvfrom(rur_info.sock_fd, response, size, MSG_DONTWAIT, (struct sockaddr *) &source, &source_length)) < 0){
+			if(errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR){
+				continue;
+			}
+			ERROR(M_RECVFROM_ERROR, "\nError while receiving the response from the server\n");
+		}
+		if(source.sin_addr.s_addr!=rur_info.server_addr->sin_addr.s_addr || source.sin_port!=rur_info.server_addr->sin_port){
+			MY_DEBUG("\nDatagram from an unknown address discarded\n");
+			continue;
+		}
+		return length;
 	}
-	// Get a response from the server
-	if ((endindex = recvfrom(rur_info.sock_fd, response, sizeof(char)*254, 0, (struct sockaddr *) rur_info.server_addr, &server_length)) < 0){
-		ERROR(M_RECVFROM_ERROR, "\nError while receiving the response from the server\n");
+}
+
+/**
+ * @brief Request the time to the server
+ * @param rur_info with the connection information
+ * @param sent to store the time (ns, on the clock of the sorts) the answered request was sent
+ * @param received to store the time (ns, on the clock of the sorts) its response was received
+ * @param receive to store the time (ns) the server received the request
+ * @param transmit to store the time (ns) the server sent the response
+ * @return integer TRUE on success, FALSE if the server didn't answer any of the retries
+ *
+ * The request uses the binary protocol, with a new nonce on each retry: the responses to older requests (late or
+ * duplicated) are discarded, so a late response is never timed with the send of a retry. A server without the binary
+ * protocol answers with the text time (us), used as both the receive and the transmit times.
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int udp_time_request(REMOTE_UDP_REQUEST_T rur_info, long long* sent, long long* received, long long* receive, long long* transmit){
+	char request[UDP_TIME_REQUEST_SIZE];	// To store the request
+	char response[255];						// To store the response
+	uint16_t magic = htons(UDP_TIME_MAGIC);
+	uint64_t nonce, value;
+	int endindex, retry, timeout = rur_info.timeout;
+	char *endptr;
+	unsigned long long timestamp;
+	struct timespec deadline;
+
+	for(retry=0; retry<=rur_info.retries; retry++){
+		// Build the binary request with a new nonce
+		memset(request, 0, sizeof(request));
+		memcpy(request, &magic, sizeof(magic));
+		request[2] = UDP_TIME_VERSION;
+		nonce = htobe64(++udp_time_nonce);
+		memcpy(request+8, &nonce, sizeof(nonce));
+
+		// Send a request to the server
+		*sent = get_sort_clock_time();
+		if (sendto(rur_info.sock_fd, request, sizeof(request), 0, (struct sockaddr *) rur_info.server_addr, sizeof(*(rur_info.server_addr))) < 0){
+			ERROR(M_SENDTO_ERROR, "\nError while sending the request to the server\n");
+		}
+		set_udp_deadline(&deadline, timeout);
+		// Get a response from the server
+		while((endindex = receive_udp_response(rur_info, response, sizeof(char)*254, &deadline))>=0){
+			*received = get_sort_clock_time();
+			if(endindex==UDP_TIME_RESPONSE_SIZE && memcmp(response, &magic, sizeof(magic))==0 && response[2]==UDP_TIME_VERSION){
+				if(memcmp(response+8, &nonce, sizeof(nonce))!=0){
+					MY_DEBUG("\nResponse to an older request discarded\n");
+					continue;
+				}
+				memcpy(&value, response+16, sizeof(value));
+				*receive = be64toh(value);
+				memcpy(&value, response+24, sizeof(value));
+				*transmit = be64toh(value);
+				return TRUE;
+			}
+			// Terminate the string from the response
+			response[endindex]=0;
+			// Convert the string to a timestamp (text protocol)
+			timestamp = strtoull(response, &endptr, 10);
+			if(endptr!=response && *endptr=='\0'){
+				*receive = *transmit = timestamp*1000;
+				return TRUE;
+			}
+			MY_DEBUG("\nInvalid response discarded\n");
+		}
+		MY_DEBUG("\nNo response from the time server after %d ms\n", timeout);
+		timeout = next_udp_timeout(timeout);
 	}
-	// Terminate the string from the response
-	response[endindex]=0;
-	// Convert the string to a timestamp
-	sscanf(response,"%llu",&timestamp);
+	return FALSE;
+}
+
+/**
+ * @brief Estimate the offset of the clock of the time server (NTP-style), with several requests
+ * @param rur_info with the connection information (and the number of requests)
+ * @param offset UDP_TIME_OFFSET_T to store the offset and its uncertainty
+ * @return integer TRUE on success, FALSE if the server didn't answer any of the requests
+ *
+ * For each request, with the send (t1) and receive (t4) times on the clock of the sorts and the server receive (t2) and transmit (t3)
+ * times, the offset is ((t2-t1)+(t3-t4))/2 and the round trip is (t4-t1)-(t3-t2). The request with the shortest round
+ * trip is the one less delayed by the network, so its offset is used, with half of its round trip as the uncertainty.
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int get_udp_time_offset(REMOTE_UDP_REQUEST_T rur_info, UDP_TIME_OFFSET_T* offset){
+	long long sent, received, receive, transmit, round_trip;
+	int a;
 
-	return timestamp;
+	offset->offset = 0;
+	offset->uncertainty = -1;
+	for(a=0; a<rur_info.samples || a==0; a++){
+		// A request without response is only a sample less
+		if(udp_time_request(rur_info, &sent, &received, &receive, &transmit)!=TRUE){
+			continue;
+		}
+
+		round_trip = (received-sent)-(transmit-receive);
+		if(round_trip<0){
+			round_trip = 0;
+		}
+		if(offset->uncertainty<0 || round_trip/2<offset->uncertainty){
+			offset->offset = ((receive-sent)+(transmit-received))/2;
+			offset->uncertainty = round_trip/2;
+		}
+	}
+	return (offset->uncertainty<0)?FALSE:TRUE;
 }
 
 /**
@@ -518,6 +761,13 @@ unsigned long long get_udp_time(REMOTE_UDP_REQUEST_T rur_info){
  * @return 0 on success, the error code otherwise
  */
 int initialize_udp_connection(REMOTE_UDP_REQUEST_T* rur_info, char* ip_address, int port){
+	struct timeval now;
+
+	// The nonces of the time requests start on a value of this process
+	if(udp_time_nonce==0){
+		gettimeofday(&now, NULL);
+		udp_time_nonce = ((uint64_t)getpid()<<40)^((uint64_t)now.tv_sec<<20)^now.tv_usec;
+	}
 	/* Creates the socket */
 	if ((rur_info->sock_fd = socket(AF_INET, SOCK_DGRAM, 0)) == -1){
 		ERROR(M_SOCKET_CREATION_ERROR, "Error while creating the socket.");
@@ -548,42 +798,6 @@ int initialize_udp_connection(REMOTE_UDP_REQUEST_T* rur_info, char* ip_address,
 	return 0;
 }
 
-/**
- * @brief Send a result to a remove UDP results server
- * @param rur_result with the connection information
- * @param stat with the statistical data
- * @param nickname with the name of the group
- * @param machine_model_name with the model name of the computer which sorted the file
- * @param md5sum of the sorted file
- *
- * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
- */
-void send_udp_result(REMOTE_UDP_REQUEST_T rur_result, ALGORITHM_STAT_T* stat, char* nickname, char* machine_model_name, char* md5sum){
-	socklen_t server_length;
-	char data[MAXCHARS]="";					// To store the data to send to the server
-	char response[MAXCHARS]="";				// To store the server response
-	int endindex;							// To store the size of the response
-
-	if(rur_result.sock_fd>0){
-		// Build the data string to send
-		sprintf(data, "%s,%s,%s,%s,%s,%.0f", nickname, machine_model_name, stat->filename, md5sum, stat->algorithm, stat->time);
-
-		server_length=sizeof(*(rur_result.server_addr));
-		// Send a request to the server
-		if (sendto(rur_result.sock_fd, data, strlen(data)*sizeof(char), 0, (struct sockaddr *) rur_result.server_addr, server_length) < 0){
-			ERROR(M_SENDTO_ERROR, "\nError while sending the data to the server\n");
-		}
-
-		// Get a response from the server
-		if ((endindex = recvfrom(rur_result.sock_fd, response, sizeof(char)*MAXCHARS, 0, (struct sockaddr *) rur_result.server_addr, &server_length)) < 0){
-			ERROR(M_RECVFROM_ERROR, "\nError while receiving the response from the server\n");
-		}
-		// Terminate the string from the response
-		response[endindex]=0;
-		MY_DEBUG("\nThe server response was %s\n",response);
-	}
-}
-
 /**
  * Save the lines to the file
  *
@@ -607,3 +821,247 @@ int save_file(char* filename, FILE_LINES_T* flines){
 	}
 	return FALSE;
 }
+
+/**
+ * @brief Build the sort keys for all the lines, parsing the key of each line only once
+ * @param flines FILE_LINES_T with the lines to build the keys from
+ * @param key_spec KEY_SPEC_T with the specification of the key to extract
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void build_sort_keys(FILE_LINES_T* flines, KEY_SPEC_T* key_spec){
+	int a;
+
+	if(flines->keys!=NULL){
+		free(flines->keys);
+	}
+	if((flines->keys=malloc(sizeof(SORT_KEY_T)*flines->num_lines))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+	}
+	flines->key_spec = key_spec;
+
+	for(a=0; a<flines->num_lines; a++){
+		extract_sort_key(&(flines->keys[a]), (char*) flines->lines[a], key_spec);
+		flines->keys[a].index = a;
+	}
+}
+
+/**
+ * @brief Extract the key from a line, according to the key specification
+ * @param key SORT_KEY_T to store the key
+ * @param line with the line to extract the key from
+ * @param key_spec KEY_SPEC_T with the specification of the key to extract
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void extract_sort_key(SORT_KEY_T* key, char* line, KEY_SPEC_T* key_spec){
+	char *start=line, *end=NULL;
+	int field, year=0, month=0, day=0, hour=0, minute=0, second=0;
+
+	key->line = line;
+
+	if(key_spec->field<=0){
+		// The whole line is the key
+		end = line+strlen(line);
+	}else{
+		// Advance to the beginning of the requested field
+		for(field=1; field<key_spec->field && *start!='\0'; field++){
+			if(key_spec->separator!='\0'){
+				while(*start!='\0' && *start!=key_spec->separator) start++;
+				if(*start!='\0') start++;
+			}else{
+				while(*start==' ' || *start=='\t') start++;
+				while(*start!='\0' && *start!=' ' && *start!='\t') start++;
+			}
+		}
+		if(key_spec->separator=='\0'){
+			while(*start==' ' || *start=='\t') start++;
+		}
+		// Find the end of the field
+		end = start;
+		if(key_spec->separator!='\0'){
+			while(*end!='\0' && *end!=key_spec->separator && *end!='\n' && *end!='\r') end++;
+		}else{
+			while(*end!='\0' && *end!=' ' && *end!='\t' && *end!='\n' && *end!='\r') end++;
+		}
+	}
+
+	switch(key_spec->type){
+		case KEY_TYPE_NUMERIC:
+			// Like the sort -n, a key without a number is worth 0
+			key->value.number = strtod(start, NULL);
+			break;
+		case KEY_TYPE_TIMESTAMP:
+			// Date and time (YYYY-MM-DD[ T]HH:MM:SS) packed into a comparable integer, otherwise a numeric timestamp
+			if(sscanf(start, "%4d-%2d-%2d%*1[ T]%2d:%2d:%2d", &year, &month, &day, &hour, &minute, &second)>=3){
+				key->value.timestamp = ((((year*100LL+month)*100+day)*100+hour)*100+minute)*100+second;
+			}else{
+				key->value.timestamp = strtoll(start, NULL, 10);
+			}
+			break;
+		default:
+			key->value.text.start = start;
+			key->value.text.length = (int)(end-start);
+	}
+}
+
+/**
+ * @brief Compare two sort keys
+ * @param a SORT_KEY_T to compare with the next parameter
+ * @param b SORT_KEY_T to compare with the previous parameter
+ * @param key_spec KEY_SPEC_T with the specification used to build the keys
+ * @return integer lower than 0 if a is lower than b, 0 if they are equal, greater than 0 otherwise
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int compare_sort_keys(SORT_KEY_T* a, SORT_KEY_T* b, KEY_SPEC_T* key_spec){
+	int result;
+
+	switch(key_spec->type){
+		case KEY_TYPE_NUMERIC:
+			result = (a->value.number > b->value.number) - (a->value.number < b->value.number);
+			break;
+		case KEY_TYPE_TIMESTAMP:
+			result = (a->value.timestamp > b->value.timestamp) - (a->value.timestamp < b->value.timestamp);
+			break;
+		default:
+			// Same order as the strcmp, but without searching for the end of the strings
+			result = memcmp(a->value.text.start, b->value.text.start, (a->value.text.length < b->value.text.length)?a->value.text.length:b->value.text.length);
+			if(result==0){
+				result = a->value.text.length - b->value.text.length;
+			}
+	}
+	// On a stable sort, equal keys keep the original order of the lines (this makes every algorithm stable)
+	if(result==0 && key_spec->stable){
+		result = a->index - b->index;
+	}
+	return result;
+}
+
+/**
+ * @brief Put the lines in the same order of the sorted keys
+ * @param flines FILE_LINES_T with the sorted keys
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void apply_sorted_keys(FILE_LINES_T* flines){
+	int a;
+
+	if(flines->keys!=NULL){
+		for(a=0; a<flines->num_lines; a++){
+			flines->lines[a] = flines->keys[a].line;
+		}
+	}
+}
+
+/**
+ * @brief Get the bytes that identify the value of a sort key, in a way that two keys have the same bytes only if compare_sort_keys finds them equal (ignoring the stable order)
+ * @param key SORT_KEY_T with the key (a numeric -0 is changed to 0)
+ * @param key_spec KEY_SPEC_T with the specification used to build the key
+ * @return reference to the bytes of the key
+ *
+ * @see sort_key_length for the number of bytes
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+const void* sort_key_bytes(SORT_KEY_T* key, KEY_SPEC_T* key_spec){
+	switch(key_spec->type){
+		case KEY_TYPE_NUMERIC:
+			// The -0 and 0 are the same number for the comparison, so they must have the same bytes too
+			if(key->value.number==0){
+				key->value.number = 0.0;
+			}
+			return &(key->value.number);
+		case KEY_TYPE_TIMESTAMP:
+			return &(key->value.timestamp);
+		default:
+			return key->value.text.start;
+	}
+}
+
+/**
+ * @brief Get the number of bytes that identify the value of a sort key
+ * @param key SORT_KEY_T with the key
+ * @param key_spec KEY_SPEC_T with the specification used to build the key
+ * @return integer with the number of bytes
+ *
+ * @see sort_key_bytes for reference
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int sort_key_length(SORT_KEY_T* key, KEY_SPEC_T* key_spec){
+	switch(key_spec->type){
+		case KEY_TYPE_NUMERIC:
+			return sizeof(key->value.number);
+		case KEY_TYPE_TIMESTAMP:
+			return sizeof(key->value.timestamp);
+		default:
+			return key->value.text.length;
+	}
+}
+
+/**
+ * @brief Remove the lines with duplicated keys, keeping the first occurrence of each key in the original order of the lines
+ * @param flines FILE_LINES_T with the lines and the sort keys already built
+ * @return integer with the number of lines removed
+ *
+ * @see build_sort_keys for reference
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int remove_duplicate_lines(FILE_LINES_T* flines){
+	HASH_MAP_T* seen_keys = NULL;					// set of the keys already found
+	SORT_KEY_T* key;								// reference to the slot of the next distinct key
+	int a, distinct=0, duplicates;
+
+	if(flines->keys==NULL){
+		return 0;
+	}
+
+	// Reserve room for all the lines up front, so the map never grows during the pass
+	seen_keys = hash_map_create(flines->num_lines);
+
+	for(a=0; a<flines->num_lines; a++){
+		// Move the key to its slot on the distinct set first: the map references the bytes of the key, which must stay in place
+		key = &(flines->keys[distinct]);
+		*key = flines->keys[a];
+
+		if(hash_map_insert(seen_keys, sort_key_bytes(key, flines->key_spec), sort_key_length(key, flines->key_spec), key)==NULL){
+			// First occurrence of the key
+			key->index = distinct;
+			flines->lines[distinct] = flines->lines[a];
+			distinct++;
+		}else{
+			free(flines->lines[a]);
+		}
+	}
+	hash_map_free(seen_keys);
+
+	duplicates = flines->num_lines-distinct;
+	for(a=distinct; a<flines->num_lines; a++){
+		flines->lines[a]=NULL;
+	}
+	flines->num_lines = distinct;
+
+	return duplicates;
+}
+
+/**
+ * @brief Store the unique mode data on the statistical data of a sort operation and estimate the sort time saved by it
+ * @param stat ALGORITHM_STAT_T with the data of the sort of the distinct lines
+ * @param nduplicates number of lines removed before the sort
+ * @param dedupe_time time spent removing the lines
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void set_dedupe_stat(ALGORITHM_STAT_T* stat, int nduplicates, double dedupe_time){
+	double distinct_cost, total_cost;
+
+	stat->nduplicates = nduplicates;
+	stat->dedupe_time = dedupe_time;
+
+	// Scale the measured time by the n*log(n) cost of sorting all the lines instead of only the distinct ones
+	distinct_cost = (stat->nlines>1)?stat->nlines*log2(stat->nlines):1;
+	total_cost = (stat->nlines+nduplicates>1)?(stat->nlines+nduplicates)*log2(stat->nlines+nduplicates):1;
+	stat->time_saved = stat->time*(total_cost/distinct_cost)-stat->time-dedupe_time;
+}
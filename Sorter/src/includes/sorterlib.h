@@ -13,6 +13,34 @@
 /*
  * data structures
  */
+/**
+ * @brief Type declaration to a structure to store the specification of the sort key to extract from each line
+ */
+typedef struct key_spec {
+	int field;						/**< @brief field of the line to use as the key (starting at 1, 0 for the whole line) */
+	char separator;					/**< @brief character that separates the fields ('\0' for sequences of blanks) */
+	int type;						/**< @brief type of the key (one of the KEY_TYPE_* constants) */
+	int stable;						/**< @brief TRUE to break the ties between equal keys by the original position of the lines */
+} KEY_SPEC_T;
+
+/**
+ * @brief Type declaration to a structure to store the sort key of a line, parsed once before the sort operation
+ *
+ * @see build_sort_keys for reference
+ */
+typedef struct sort_key {
+	void* line;						/**< @brief reference to the line that owns the key */
+	int index;						/**< @brief original position of the line (used by the stable sort) */
+	union {
+		double number;				/**< @brief value of a numeric key */
+		long long timestamp;		/**< @brief value of a timestamp key */
+		struct {
+			char* start;			/**< @brief reference to the first character of the key inside the line */
+			int length;				/**< @brief number of characters of the key */
+		} text;						/**< @brief slice of the line with a string key */
+	} value;						/**< @brief the parsed value of the key */
+} SORT_KEY_T;
+
 /**
  * @brief Type declaration to a structure to store the references to lines of files, and the number of lines that the structure has access
  *
@@ -21,6 +49,8 @@
 typedef struct file_lines {
 	void** lines; 	/**< @brief reference to the lines. */
 	int num_lines;	/**< @brief reference to the number of lines. */
+	SORT_KEY_T* keys;	/**< @brief reference to the sort keys of the lines (the array the algorithms sort). */
+	KEY_SPEC_T* key_spec;	/**< @brief reference to the specification used to build and compare the keys. */
 } FILE_LINES_T;
 
 /**
@@ -38,8 +68,19 @@ typedef FILE_LINES_T* (*ALGORITHM_FUNC) (FILE_LINES_T*, ALGORITHM_STAT_T*);
 typedef struct remote_udp_request {
 	int sock_fd; 						/**< @brief reference to the socket to use in the communication process */
 	struct sockaddr_in *server_addr;	/**< @brief reference to the server address socket to use */
+	int samples;						/**< @brief number of requests of each time measure (the one with the shortest round trip is used) */
+	int timeout;						/**< @brief time (ms) to wait for the first response to a request (doubled on each retry) */
+	int retries;						/**< @brief number of times a request is sent again without a response */
 } REMOTE_UDP_REQUEST_T;
 
+/**
+ * @brief Type declaration to a structure to store the offset of the clock of the UDP time server (NTP-style)
+ */
+typedef struct udp_time_offset {
+	long long offset;					/**< @brief time of the server minus the time of the clock of the sorts (ns) */
+	long long uncertainty;				/**< @brief maximum error of the offset (ns), half the round trip of the request without the time on the server */
+} UDP_TIME_OFFSET_T;
+
 /*
  * functions prototypes
  */
@@ -58,9 +99,21 @@ void copy_stat(SHARED_ALGORITHM_STAT_T*, ALGORITHM_STAT_T);
 void wait_for_exit_unlock(CONTROLLER_STAT_T*);
 FILE_LINES_T *read_file(char*, int);
 FILE_LINES_T* sort_lines(FILE_LINES_T*, ALGORITHM_FUNC, ALGORITHM_STAT_T*, REMOTE_UDP_REQUEST_T);
-unsigned long long get_udp_time(REMOTE_UDP_REQUEST_T);
+void set_sort_clock(clockid_t);
+long long get_sort_clock_time(void);
+int get_udp_time_offset(REMOTE_UDP_REQUEST_T, UDP_TIME_OFFSET_T*);
 int initialize_udp_connection(REMOTE_UDP_REQUEST_T*, char*, int);
-void send_udp_result(REMOTE_UDP_REQUEST_T, ALGORITHM_STAT_T*, char*, char*, char*);
+int receive_udp_response(REMOTE_UDP_REQUEST_T, char*, int, struct timespec*);
+void set_udp_deadline(struct timespec*, int);
+int next_udp_timeout(int);
 int save_file(char*, FILE_LINES_T*);
+void build_sort_keys(FILE_LINES_T*, KEY_SPEC_T*);
+void extract_sort_key(SORT_KEY_T*, char*, KEY_SPEC_T*);
+int compare_sort_keys(SORT_KEY_T*, SORT_KEY_T*, KEY_SPEC_T*);
+void apply_sorted_keys(FILE_LINES_T*);
+const void* sort_key_bytes(SORT_KEY_T*, KEY_SPEC_T*);
+int sort_key_length(SORT_KEY_T*, KEY_SPEC_T*);
+int remove_duplicate_lines(FILE_LINES_T*);
+void set_dedupe_stat(ALGORITHM_STAT_T*, int, double);
 
 #endif /* SORTERLIB_H_ */
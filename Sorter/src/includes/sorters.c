@@ -8,6 +8,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 
 #include "../3rd/debug.h"
 #include "definitions.h"
@@ -15,6 +17,16 @@
 #include "sorterlib.h"
 #include "sorters.h"
 
+/**
+ * @brief Key specification used by the q_sort_aux comparison function (the qsort doesn't allow to pass it as an argument)
+ */
+static KEY_SPEC_T* _q_sort_key_spec=NULL;
+
+/**
+ * @brief Number of threads used by the parallel algorithms (0 for the number of processors)
+ */
+static int _sort_threads=0;
+
 
 /**
  * @brief Sort the FILE_LINES_T using the merge sort algorithm
@@ -23,74 +35,89 @@
  * @return FILE_LINES_T with the sorted lines
  */
 FILE_LINES_T* merge_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat) {
-	FILE_LINES_T* flines_clone = NULL;
+	SORT_KEY_T* aux = NULL;
 
 	stat->nlines = flines->num_lines;
 
-	if((flines_clone = clone_of_lines(flines))==NULL){
-		ERROR(M_CLONE_CREATION_FAILED, "\nError creation a copy of the lines object");
+	if((aux = malloc(sizeof(SORT_KEY_T)*flines->num_lines))==NULL && flines->num_lines>0){
+		ERROR(M_CLONE_CREATION_FAILED, "\nError creation a copy of the keys");
 	}
 
-	merge_sort_aux((char**)flines->lines,(char**)flines_clone->lines, flines->num_lines, stat);
-	free_memory_of_clone_of_lines(flines_clone);
+	merge_sort_aux(flines->keys, aux, flines->num_lines, flines->key_spec, stat);
+	free(aux);
 
 	return flines;
 }
 
 /**
  * @brief Auxiliary function with the merge sort algorithm
- * @param **flines_src with the lines to sort
- * @param **aux with with the lines clone to use as auxiliary object
- * @param size integer with the number of lines to process
+ * @param keys with the keys to sort
+ * @param aux with the keys buffer to use as auxiliary object
+ * @param size integer with the number of keys to process
+ * @param key_spec KEY_SPEC_T with the specification to compare the keys
  * @param stat ALGORITHM_STAT_T with the structure to store the statistical data of the sort operation
  *
  * @see http://www.codecodex.com/wiki/Merge_sort#C
  * @see https://www-927.ibm.com/ibm/cas/hspc/MergeSort1.shtml
  * @see http://en.literateprograms.org/Merge_sort_(C)
  */
-void merge_sort_aux(char** flines_src, char** aux, int size, ALGORITHM_STAT_T* stat){
-    int i1, i2, tempi;
+void merge_sort_aux(SORT_KEY_T* keys, SORT_KEY_T* aux, int size, KEY_SPEC_T* key_spec, ALGORITHM_STAT_T* stat){
 
     // If we can't divide anymore, this is the end
     if (size <= 1) {
 		return;
 	}
 
-    merge_sort_aux(flines_src, aux, size/2, stat);
-    merge_sort_aux(flines_src + size/2, aux, size - size/2, stat);
+    merge_sort_aux(keys, aux, size/2, key_spec, stat);
+    merge_sort_aux(keys + size/2, aux, size - size/2, key_spec, stat);
+
+    merge_sorted_keys(keys, aux, size/2, size, key_spec, stat);
+}
+
+/**
+ * @brief Merge two consecutive sorted runs of keys; on equal keys the left one goes first, so the merge is stable
+ * @param keys with the runs to merge (the first run ends on middle, the second on size)
+ * @param aux with the keys buffer to use as auxiliary object
+ * @param middle integer with the position where the second run begins
+ * @param size integer with the number of keys of both runs
+ * @param key_spec KEY_SPEC_T with the specification to compare the keys
+ * @param stat ALGORITHM_STAT_T with the structure to store the statistical data of the sort operation
+ */
+void merge_sorted_keys(SORT_KEY_T* keys, SORT_KEY_T* aux, int middle, int size, KEY_SPEC_T* key_spec, ALGORITHM_STAT_T* stat){
+    int i1, i2, tempi;
 
     i1 = 0;
-    i2 = size/2;
+    i2 = middle;
     tempi = 0;
-    while (i1 < size/2 && i2 < size) {
+    while (i1 < middle && i2 < size) {
 		stat->niterations++;
-        if (strcmp(flines_src[i1],flines_src[i2])<0) {
-        	aux[tempi] = flines_src[i1];
+        if (compare_sort_keys(&keys[i1], &keys[i2], key_spec)<=0) {
+        	aux[tempi] = keys[i1];
             i1++;
         } else {
-        	aux[tempi] = flines_src[i2];
+        	aux[tempi] = keys[i2];
             i2++;
         }
         tempi++;
     }
     // First half
-    while (i1 < size/2) {
+    while (i1 < middle) {
 		stat->nswaps++;
-    	aux[tempi] = flines_src[i1];
+    	aux[tempi] = keys[i1];
         i1++;
         tempi++;
     }
     // Second half
     while (i2 < size) {
 		stat->nswaps++;
-    	aux[tempi] = flines_src[i2];
+    	aux[tempi] = keys[i2];
         i2++;
         tempi++;
     }
 
     // Copy from the clone to the sorted object
     for(tempi=0; tempi<size; tempi++){
-    	flines_src[tempi] = aux[tempi];
+    	keys[tempi] = aux[tempi];
     }
 }
 
@@ -104,7 +131,7 @@ void merge_sort_aux(char** flines_src, char** aux, int size, ALGORITHM_STAT_T* s
  */
 FILE_LINES_T* shell_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat) {
 	int i, j, gap = 1;
-	char* aux;
+	SORT_KEY_T aux;
 
 	stat->nlines = flines->num_lines;
 
@@ -116,15 +143,15 @@ FILE_LINES_T* shell_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat) {
 		gap /= 3;
 		for(i=gap; i<flines->num_lines; i++) {
 			stat->niterations++;
-			aux=flines->lines[i];
+			aux=flines->keys[i];
 			j=i-gap;
 
-			while (j>=0 && strcmp(aux,flines->lines[j])<0) {
+			while (j>=0 && compare_sort_keys(&aux,&flines->keys[j],flines->key_spec)<0) {
 				stat->nswaps++;
-				flines->lines[j+gap] = flines->lines[j];
+				flines->keys[j+gap] = flines->keys[j];
                 j-=gap;
             }
-			flines->lines[j+gap] = aux;
+			flines->keys[j+gap] = aux;
         }
     } while ( gap > 1);
 
@@ -153,23 +180,23 @@ FILE_LINES_T* quick_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat) {
  * @see http://www.codecodex.com/wiki/Quicksort#C
  */
 FILE_LINES_T* quick_sort_aux(FILE_LINES_T* flines, int begin, int end, ALGORITHM_STAT_T* stat){
-	char* piv; char* tmp;
+	SORT_KEY_T piv, tmp;
 	int  l,r,p;
 
 	while (begin<end){    // This while loop will avoid the second recursive call
 		stat->niterations++;
 		l = begin; p = (begin+end)/2; r = end;
-		piv = flines->lines[p];
+		piv = flines->keys[p];
 		while (1){
-			while ( (l<=r) && ( strcmp(flines->lines[l],piv) <= 0 ) ) l++;
-			while ( (l<=r) && ( strcmp(flines->lines[r],piv)  > 0 ) ) r--;
+			while ( (l<=r) && ( compare_sort_keys(&flines->keys[l],&piv,flines->key_spec) <= 0 ) ) l++;
+			while ( (l<=r) && ( compare_sort_keys(&flines->keys[r],&piv,flines->key_spec)  > 0 ) ) r--;
 			if (l>r) break;
-			tmp=flines->lines[l]; flines->lines[l]=flines->lines[r]; flines->lines[r]=tmp;
+			tmp=flines->keys[l]; flines->keys[l]=flines->keys[r]; flines->keys[r]=tmp;
 			stat->nswaps++;
 			if (p==r) p=l;
 			l++; r--;
 		}
-		flines->lines[p]=flines->lines[r]; flines->lines[r]=piv;
+		flines->keys[p]=flines->keys[r]; flines->keys[r]=piv;
 		r--;
 		// Recursion on the shorter side & loop (with new indexes) on the longer
 		if ((r-begin)<(end-l)){
@@ -193,7 +220,7 @@ FILE_LINES_T* quick_sort_aux(FILE_LINES_T* flines, int begin, int end, ALGORITHM
  */
 FILE_LINES_T* bubble_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat){
 	int i, j, test;
-	char* aux;
+	SORT_KEY_T aux;
 
 	stat->nlines = flines->num_lines;
 
@@ -201,11 +228,11 @@ FILE_LINES_T* bubble_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat){
 		test=0;
 		for(j = 0; j < i; j++){
 			stat->niterations++;
-			if(strcmp(flines->lines[j], flines->lines[j+1])>0){
+			if(compare_sort_keys(&flines->keys[j], &flines->keys[j+1], flines->key_spec)>0){
 				stat->nswaps++;
-				aux = flines->lines[j];    //swap array[j] and array[j+1]
-				flines->lines[j] = flines->lines[j+1];
-				flines->lines[j+1] = aux;
+				aux = flines->keys[j];    //swap array[j] and array[j+1]
+				flines->keys[j] = flines->keys[j+1];
+				flines->keys[j+1] = aux;
 				test=1;
 			}
 		} //end for j
@@ -224,19 +251,126 @@ FILE_LINES_T* bubble_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat){
 FILE_LINES_T* q_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat){
 	stat->nlines = flines->num_lines;
 
-	qsort(flines->lines, flines->num_lines, sizeof(char*), q_sort_aux);
+	_q_sort_key_spec = flines->key_spec;
+	qsort(flines->keys, flines->num_lines, sizeof(SORT_KEY_T), q_sort_aux);
 	return flines;
 }
 
 /**
  * @brief Auxiliary function for q_sort algorithm
- * @param a string to be compared with the next parameter
- * @param b string to be compared with the previous parameter
- * @return integer 0 if the strings are equal, 1 or -1 otherwise
+ * @param a SORT_KEY_T to be compared with the next parameter
+ * @param b SORT_KEY_T to be compared with the previous parameter
+ * @return integer 0 if the keys are equal, lower or greater than 0 otherwise
  */
 int q_sort_aux(const void *a, const void *b){
-	const char **ia = (const char **)a;
-	const char **ib = (const char **)b;
+	return compare_sort_keys((SORT_KEY_T *)a, (SORT_KEY_T *)b, _q_sort_key_spec);
+}
+
+/**
+ * @brief Set the number of threads to be used by the parallel algorithms
+ * @param threads integer with the number of threads (0 for the number of online processors)
+ */
+void set_sort_threads(int threads){
+	_sort_threads = threads;
+}
+
+/**
+ * @brief Sort the FILE_LINES_T using a parallel (and stable) merge sort: each thread sorts a run of the keys, and the runs are merged in pairs, also in parallel, until only one remains
+ * @param flines FILE_LINES_T with the lines to sort
+ * @param stat ALGORITHM_STAT_T with the structure to store the statistical data of the sort operation
+ * @return FILE_LINES_T with the sorted lines
+ */
+FILE_LINES_T* parallel_merge_sort(FILE_LINES_T* flines, ALGORITHM_STAT_T* stat){
+	SORT_KEY_T* aux = NULL;
+	int threads, runs, a, b;
+
+	stat->nlines = flines->num_lines;
 
-	return strcmp(*ia, *ib);
+	// Choose the number of threads, without creating threads for tiny runs
+	if((threads = _sort_threads)<=0 && (threads = (int) sysconf(_SC_NPROCESSORS_ONLN))<=0){
+		threads = 1;
+	}
+	if(threads > flines->num_lines/PARALLEL_SORT_MINIMUM_RUN){
+		threads = flines->num_lines/PARALLEL_SORT_MINIMUM_RUN;
+	}
+	if(threads <= 1){
+		return merge_sort(flines, stat);
+	}
+
+	{
+		int bounds[threads+1];								// to store the limits of each run
+		pthread_t workers[threads];							// to store the working threads
+		PARALLEL_SORT_TASK_T tasks[threads];				// to store the work of each thread
+
+		if((aux = malloc(sizeof(SORT_KEY_T)*flines->num_lines))==NULL){
+			ERROR(M_CLONE_CREATION_FAILED, "\nError creation a copy of the keys");
+		}
+
+		// Split the keys in runs with (almost) the same size
+		for(a=0; a<=threads; a++){
+			bounds[a] = (int)(((long long) flines->num_lines*a)/threads);
+		}
+
+		// Sort each run on its own thread
+		for(a=0; a<threads; a++){
+			tasks[a].keys = flines->keys+bounds[a];
+			tasks[a].aux = aux+bounds[a];
+			tasks[a].middle = 0;
+			tasks[a].size = bounds[a+1]-bounds[a];
+			tasks[a].key_spec = flines->key_spec;
+			reset_stat(&(tasks[a].stat), NULL, NULL);
+			if(pthread_create(&workers[a], NULL, parallel_merge_sort_worker, &tasks[a])!=0){
+				ERROR(M_PTHREAD_CREATE_FAILED, "\nSort thread creation failed.\n");
+			}
+		}
+		for(a=0; a<threads; a++){
+			pthread_join(workers[a], NULL);
+			stat->niterations += tasks[a].stat.niterations;
+			stat->nswaps += tasks[a].stat.nswaps;
+		}
+
+		// Merge the neighbour runs in pairs until only one remains
+		for(runs=threads; runs>1; runs=(runs+1)/2){
+			for(a=0; a<runs/2; a++){
+				tasks[a].keys = flines->keys+bounds[2*a];
+				tasks[a].aux = aux+bounds[2*a];
+				tasks[a].middle = bounds[2*a+1]-bounds[2*a];
+				tasks[a].size = bounds[2*a+2]-bounds[2*a];
+				tasks[a].key_spec = flines->key_spec;
+				reset_stat(&(tasks[a].stat), NULL, NULL);
+				if(pthread_create(&workers[a], NULL, parallel_merge_sort_worker, &tasks[a])!=0){
+					ERROR(M_PTHREAD_CREATE_FAILED, "\nSort thread creation failed.\n");
+				}
+			}
+			for(a=0; a<runs/2; a++){
+				pthread_join(workers[a], NULL);
+				stat->niterations += tasks[a].stat.niterations;
+				stat->nswaps += tasks[a].stat.nswaps;
+			}
+			// The merged runs now end on the end of the second run of each pair (an odd run is kept as it is)
+			for(a=0, b=0; a<=runs; a+=2, b++){
+				bounds[b] = bounds[a];
+			}
+			bounds[(runs+1)/2] = bounds[runs];
+		}
+		free(aux);
+	}
+
+	return flines;
+}
+
+/**
+ * @brief Thread function of the parallel merge sort: sorts a run of keys or, when a middle is given, merges two sorted runs
+ * @param arg PARALLEL_SORT_TASK_T with the work to do
+ * @return NULL
+ */
+void *parallel_merge_sort_worker(void *arg){
+	PARALLEL_SORT_TASK_T *task = (PARALLEL_SORT_TASK_T *) arg;
+
+	if(task->middle>0){
+		merge_sorted_keys(task->keys, task->aux, task->middle, task->size, task->key_spec, &(task->stat));
+	}else{
+		merge_sort_aux(task->keys, task->aux, task->size, task->key_spec, &(task->stat));
+	}
+	return NULL;
 }
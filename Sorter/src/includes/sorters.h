@@ -7,13 +7,30 @@
 
 #ifndef SORTERS_H_
 #define SORTERS_H_
+
+/**
+ * @brief Type declaration to a structure to store the work of a thread of the parallel merge sort
+ */
+typedef struct parallel_sort_task {
+	SORT_KEY_T* keys;				/**< @brief reference to the keys to sort or merge */
+	SORT_KEY_T* aux;				/**< @brief reference to the auxiliary keys buffer (with the same size) */
+	int middle;						/**< @brief position where the second run to merge begins (0 to sort the keys) */
+	int size;						/**< @brief number of keys to process */
+	KEY_SPEC_T* key_spec;			/**< @brief reference to the specification to compare the keys */
+	ALGORITHM_STAT_T stat;			/**< @brief statistical data of the work done by the thread */
+} PARALLEL_SORT_TASK_T;
+
 FILE_LINES_T* bubble_sort(FILE_LINES_T*, ALGORITHM_STAT_T*);
 FILE_LINES_T* quick_sort(FILE_LINES_T*, ALGORITHM_STAT_T*);
 FILE_LINES_T* quick_sort_aux(FILE_LINES_T* , int, int, ALGORITHM_STAT_T*);
 FILE_LINES_T* shell_sort(FILE_LINES_T*, ALGORITHM_STAT_T*);
 FILE_LINES_T* merge_sort(FILE_LINES_T*, ALGORITHM_STAT_T*);
-void merge_sort_aux(char**, char**, int, ALGORITHM_STAT_T*);
+void merge_sort_aux(SORT_KEY_T*, SORT_KEY_T*, int, KEY_SPEC_T*, ALGORITHM_STAT_T*);
+void merge_sorted_keys(SORT_KEY_T*, SORT_KEY_T*, int, int, KEY_SPEC_T*, ALGORITHM_STAT_T*);
 int q_sort_aux(const void *, const void *);
 FILE_LINES_T* q_sort(FILE_LINES_T*, ALGORITHM_STAT_T*);
+void set_sort_threads(int);
+FILE_LINES_T* parallel_merge_sort(FILE_LINES_T*, ALGORITHM_STAT_T*);
+void *parallel_merge_sort_worker(void *);
 
 #endif /* SORTERS_H_ */
@@ -0,0 +1,331 @@
+/**
+* @file vectorlib.c
+* @brief source file for the contiguous vector of elements
+* @date 2010/01/20 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../3rd/debug.h"
+#include "definitions.h"
+#include "vectorlib.h"
+
+/**
+ * @brief Create a vector, with room for the given number of elements
+ * @param elements number of elements to reserve room for (0 for the minimum capacity)
+ * @param free_element function to free the memory of an element (NULL if the vector doesn't own the elements)
+ * @return VECTOR_T pointer with the vector
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+VECTOR_T* vector_criar(int elements, LIBERTAR_FUNC free_element){
+	VECTOR_T* vector = NULL;
+
+	if((vector=(VECTOR_T *)malloc(sizeof(VECTOR_T)))!=NULL){
+		vector->count = 0;
+		vector->capacity = 0;
+		vector->elements = NULL;
+		vector->free_element = free_element;
+		vector_reservar(vector, (elements>VECTOR_MINIMUM_CAPACITY)?elements:VECTOR_MINIMUM_CAPACITY);
+	}else{
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+	}
+	return vector;
+}
+
+/**
+ * @brief Grow the vector to store the given number of elements without any further reallocation
+ * @param vector VECTOR_T to grow
+ * @param elements number of elements
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_reservar(VECTOR_T* vector, int elements){
+	void** new_elements;
+
+	if(elements>vector->capacity){
+		if((new_elements=realloc(vector->elements, sizeof(void*)*elements))==NULL){
+			ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+		}
+		vector->elements = new_elements;
+		vector->capacity = elements;
+	}
+}
+
+/**
+ * @brief Insert an element on the vector (at the end, like the list)
+ * @param vector VECTOR_T to insert into
+ * @param element reference to the element (allocated by the caller)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_inserir(VECTOR_T* vector, void* element){
+	vector_inserir_fim(vector, element);
+}
+
+/**
+ * @brief Insert an element at the end of the vector
+ * @param vector VECTOR_T to insert into
+ * @param element reference to the element (allocated by the caller)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_inserir_fim(VECTOR_T* vector, void* element){
+	// Doubling the capacity keeps the insertion at a constant amortized cost
+	if(vector->count==vector->capacity){
+		vector_reservar(vector, vector->capacity*2);
+	}
+	vector->elements[vector->count++] = element;
+}
+
+/**
+ * @brief Insert an element at the beginning of the vector (moves all the others)
+ * @param vector VECTOR_T to insert into
+ * @param element reference to the element (allocated by the caller)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_inserir_inicio(VECTOR_T* vector, void* element){
+	if(vector->count==vector->capacity){
+		vector_reservar(vector, vector->capacity*2);
+	}
+	memmove(vector->elements+1, vector->elements, sizeof(void*)*vector->count);
+	vector->elements[0] = element;
+	vector->count++;
+}
+
+/**
+ * @brief Remove an element from the vector, keeping the order of the others
+ * @param vector VECTOR_T to remove from
+ * @param element reference to the element to remove
+ * @return the reference to the removed element (not freed), NULL if it isn't on the vector
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* vector_remover(VECTOR_T* vector, void* element){
+	int a;
+
+	for(a=0; a<vector->count; a++){
+		if(vector->elements[a]==element){
+			memmove(vector->elements+a, vector->elements+a+1, sizeof(void*)*(vector->count-a-1));
+			vector->count--;
+			return element;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Remove all the elements of the vector, freeing them with the vector free function (the capacity is kept)
+ * @param vector VECTOR_T to empty
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_remover_todos(VECTOR_T* vector){
+	int a;
+
+	if(vector->free_element!=NULL){
+		for(a=0; a<vector->count; a++){
+			vector->free_element(vector->elements[a]);
+		}
+	}
+	vector->count = 0;
+}
+
+/**
+ * @brief Get the number of elements of the vector
+ * @param vector VECTOR_T to count
+ * @return integer with the number of elements
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int vector_numero_elementos(VECTOR_T* vector){
+	return vector->count;
+}
+
+/**
+ * @brief Get the element on the given position
+ * @param vector VECTOR_T with the elements
+ * @param position of the element
+ * @return the reference to the element, NULL if the position is out of the vector
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* vector_consultar(VECTOR_T* vector, int position){
+	return (position>=0 && position<vector->count)?vector->elements[position]:NULL;
+}
+
+/**
+ * @brief Free the vector and, if it has a free function, its elements
+ * @param vector reference to the VECTOR_T pointer to free (set to NULL)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_destruir(VECTOR_T** vector){
+	vector_remover_todos(*vector);
+	free((*vector)->elements);
+	free(*vector);
+	*vector = NULL;
+}
+
+/**
+ * @brief Search the vector for an element
+ * @param vector VECTOR_T to search
+ * @param element with the fields used by the comparison function
+ * @param compare function that returns 0 for the element to find
+ * @return the reference to the first element found, NULL if not found
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* vector_pesquisar(VECTOR_T* vector, void* element, COMPARAR_FUNC compare){
+	int a;
+
+	for(a=0; a<vector->count; a++){
+		if(compare(vector->elements[a], element)==0){
+			return vector->elements[a];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Call a function for each element of the vector
+ * @param vector VECTOR_T with the elements
+ * @param apply function to call
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_aplicar_todos(VECTOR_T* vector, APLICAR_FUNC apply){
+	int a;
+
+	for(a=0; a<vector->count; a++){
+		apply(vector->elements[a]);
+	}
+}
+
+/**
+ * @brief Auxiliary function with the merge sort of the references
+ * @param elements to sort
+ * @param aux buffer with the same size
+ * @param size number of elements
+ * @param compare function to order the elements
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void vector_ordenar_aux(void** elements, void** aux, int size, COMPARAR_FUNC compare){
+	int middle = size/2, a, left, right;
+
+	if(size<2){
+		return;
+	}
+	vector_ordenar_aux(elements, aux, middle, compare);
+	vector_ordenar_aux(elements+middle, aux, size-middle, compare);
+
+	// The runs are already in order
+	if(compare(elements[middle-1], elements[middle])<=0){
+		return;
+	}
+
+	// Merge, taking the left element on ties to keep the sort stable
+	for(a=0, left=0, right=middle; a<size; a++){
+		if(right>=size || (left<middle && compare(elements[left], elements[right])<=0)){
+			aux[a] = elements[left++];
+		}else{
+			aux[a] = elements[right++];
+		}
+	}
+	memcpy(elements, aux, sizeof(void*)*size);
+}
+
+/**
+ * @brief Sort the elements of the vector (stable)
+ * @param vector VECTOR_T to sort
+ * @param compare function to order the elements
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_ordenar(VECTOR_T* vector, COMPARAR_FUNC compare){
+	void** aux;
+
+	if(vector->count<2){
+		return;
+	}
+	if((aux=malloc(sizeof(void*)*vector->count))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+	}
+	vector_ordenar_aux(vector->elements, aux, vector->count, compare);
+	free(aux);
+}
+
+/**
+ * @brief Initialize an iterator over the vector (without any allocation, for iterators on the stack)
+ * @param iterator VECTOR_ITERADOR_T to initialize
+ * @param vector VECTOR_T to iterate
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_iterador_iniciar(VECTOR_ITERADOR_T* iterator, VECTOR_T* vector){
+	iterator->vector = vector;
+	iterator->position = 0;
+}
+
+/**
+ * @brief Create an iterator over the vector
+ * @param vector VECTOR_T to iterate
+ * @return VECTOR_ITERADOR_T pointer with the iterator
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+VECTOR_ITERADOR_T* vector_criar_iterador(VECTOR_T* vector){
+	VECTOR_ITERADOR_T* iterator = NULL;
+
+	if((iterator=(VECTOR_ITERADOR_T *)malloc(sizeof(VECTOR_ITERADOR_T)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION,"Error in memory allocation");
+	}
+	vector_iterador_iniciar(iterator, vector);
+	return iterator;
+}
+
+/**
+ * @brief Create an iterator over the sorted vector
+ *
+ * Unlike the lista_criar_iterador_ordenado, the vector itself is sorted (no copy of the elements is made), so the vector keeps the new order
+ *
+ * @param vector VECTOR_T to sort and iterate
+ * @param compare function to order the elements
+ * @return VECTOR_ITERADOR_T pointer with the iterator
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+VECTOR_ITERADOR_T* vector_criar_iterador_ordenado(VECTOR_T* vector, COMPARAR_FUNC compare){
+	vector_ordenar(vector, compare);
+	return vector_criar_iterador(vector);
+}
+
+/**
+ * @brief Get the next element of the iterator
+ * @param iterator VECTOR_ITERADOR_T with the iteration state
+ * @return the reference to the next element, NULL at the end of the vector
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* vector_iterador_proximo_elemento(VECTOR_ITERADOR_T* iterator){
+	if(iterator->position<iterator->vector->count){
+		return iterator->vector->elements[iterator->position++];
+	}
+	return NULL;
+}
+
+/**
+ * @brief Free the memory of the iterator (the vector is kept)
+ * @param iterator reference to the VECTOR_ITERADOR_T pointer to free (set to NULL)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void vector_iterador_destruir(VECTOR_ITERADOR_T** iterator){
+	free(*iterator);
+	*iterator = NULL;
+}
@@ -0,0 +1,56 @@
+/**
+* @file vectorlib.h
+* @brief Header file for the contiguous vector of elements
+* @date 2010/01/20 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef VECTORLIB_H_
+#define VECTORLIB_H_
+
+#include "../3rd/listas.h"
+
+/**
+ * @brief Type declaration to a structure to store a dynamic array of references to elements
+ *
+ * Same operations (and names, with the vector_ prefix) of the LISTA_GENERICA_T, but the references are stored in a single array, so the iteration is sequential
+ *
+ * @see vector_criar for reference
+ */
+typedef struct vector {
+	void** elements;				/**< @brief reference to the array with the references to the elements */
+	int count;						/**< @brief number of elements stored */
+	int capacity;					/**< @brief number of elements that fit on the array without growing */
+	LIBERTAR_FUNC free_element;		/**< @brief function to free the memory of an element (can be NULL) */
+} VECTOR_T;
+
+/**
+ * @brief Type declaration to a structure to store the iteration state over a vector
+ *
+ * @see vector_criar_iterador for reference
+ */
+typedef struct vector_iterador {
+	VECTOR_T* vector;				/**< @brief reference to the vector to iterate */
+	int position;					/**< @brief position of the next element */
+} VECTOR_ITERADOR_T;
+
+VECTOR_T* vector_criar(int, LIBERTAR_FUNC);
+void vector_reservar(VECTOR_T*, int);
+void vector_inserir(VECTOR_T*, void*);
+void vector_inserir_inicio(VECTOR_T*, void*);
+void vector_inserir_fim(VECTOR_T*, void*);
+void* vector_remover(VECTOR_T*, void*);
+void vector_remover_todos(VECTOR_T*);
+int vector_numero_elementos(VECTOR_T*);
+void* vector_consultar(VECTOR_T*, int);
+void vector_destruir(VECTOR_T**);
+void* vector_pesquisar(VECTOR_T*, void*, COMPARAR_FUNC);
+void vector_aplicar_todos(VECTOR_T*, APLICAR_FUNC);
+void vector_ordenar(VECTOR_T*, COMPARAR_FUNC);
+void vector_iterador_iniciar(VECTOR_ITERADOR_T*, VECTOR_T*);
+VECTOR_ITERADOR_T* vector_criar_iterador(VECTOR_T*);
+VECTOR_ITERADOR_T* vector_criar_iterador_ordenado(VECTOR_T*, COMPARAR_FUNC);
+void* vector_iterador_proximo_elemento(VECTOR_ITERADOR_T*);
+void vector_iterador_destruir(VECTOR_ITERADOR_T**);
+
+#endif /* VECTORLIB_H_ */
@@ -38,6 +38,7 @@
 #include "includes/commonlib.h"
 #include "includes/sorterlib.h"
 #include "includes/sorters.h"
+#include "includes/resultslib.h"
 #include "main.h"
 
 /**
@@ -57,6 +58,7 @@ int main(int argc, char *argv[]){
 	/* Variable declarations */
 	struct gengetopt_args_info args_info;						// structure for the command line parameters processing
 	FILE *log_file = NULL;										// log file reference
+	KEY_SPEC_T key_spec;										// specification of the sort key
 	int result = 0;
 	/* Main code */
 
@@ -73,6 +75,27 @@ int main(int argc, char *argv[]){
 		DEBUG("\nNo files found to sort");
 		result = M_NUMBER_OF_FILES;
 	}
+
+	// Check the sort key options
+	if(result == 0 && (result = parse_key_spec(args_info, &key_spec))!=0){
+		DEBUG("\nInvalid sort key specification");
+	}
+
+	// Check the number of sort threads
+	if(result == 0){
+		if(args_info.threads_arg<0){
+			printf("The number of threads %d is not valid; use 0 for the number of processors\n", args_info.threads_arg);
+			DEBUG("\nInvalid number of threads");
+			result = M_INVALID_PARAMETERS;
+		}else{
+			set_sort_threads(args_info.threads_arg);
+		}
+	}
+
+	// Check the clock options
+	if(result == 0 && (result = parse_clock(args_info))!=0){
+		DEBUG("\nInvalid clock");
+	}
 	
 	// If no error occurred
 	if(result == 0){
@@ -93,7 +116,7 @@ int main(int argc, char *argv[]){
 
 
 		// Let's process the directory
-		if((result = processDir(args_info, argc, argv))!=TRUE){
+		if((result = processDir(args_info, &key_spec, argc, argv))!=TRUE){
 			printf("\nThe processing failed with the error %d\n",result);
 			result = M_PROCESSING_FAILED;
 		}
@@ -158,16 +181,93 @@ void print_log_header(struct gengetopt_args_info args_info, int argc, char *argv
 	printf("#-----------------------\n");
 }
 
+/**
+ * @brief Set the clock to time the sorts from the application parameters
+ * @param args_info struct gengetopt_args_info with the parameters given to the application
+ * @return integer 0 if the clock is valid, M_INVALID_PARAMETERS otherwise
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int parse_clock(struct gengetopt_args_info args_info){
+	switch(args_info.clock_arg){
+		case clock_arg_realtime:
+			set_sort_clock(CLOCK_REALTIME);
+			break;
+		case clock_arg_monotonicMINUS_raw:
+			set_sort_clock(CLOCK_MONOTONIC_RAW);
+			break;
+		case clock_arg_threadMINUS_cputime:
+			set_sort_clock(CLOCK_THREAD_CPUTIME_ID);
+			break;
+		case clock_arg_processMINUS_cputime:
+			set_sort_clock(CLOCK_PROCESS_CPUTIME_ID);
+			break;
+		default:
+			set_sort_clock(CLOCK_MONOTONIC);
+	}
+	// The offset of the time server is only valid for a clock that runs while the process waits
+	if(args_info.time_server_addr_given && (args_info.clock_arg==clock_arg_threadMINUS_cputime || args_info.clock_arg==clock_arg_processMINUS_cputime)){
+		printf("The CPU time clocks can't be used with the UDP time server\n");
+		return M_INVALID_PARAMETERS;
+	}
+	return 0;
+}
+
+/**
+ * @brief Fill the sort key specification from the application parameters
+ * @param args_info struct gengetopt_args_info with the parameters given to the application
+ * @param key_spec KEY_SPEC_T to fill
+ * @return integer 0 if the specification is valid, M_INVALID_KEY_SPECIFICATION otherwise
+ *
+ * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int parse_key_spec(struct gengetopt_args_info args_info, KEY_SPEC_T* key_spec){
+	key_spec->field = args_info.key_field_arg;
+	key_spec->separator = '\0';
+	key_spec->type = KEY_TYPE_STRING;
+	key_spec->stable = args_info.stable_flag;
+
+	if(key_spec->field<0){
+		printf("The key field %d is not valid; use 0 for the whole line or the number of the field, starting at 1\n", key_spec->field);
+		return M_INVALID_KEY_SPECIFICATION;
+	}
+
+	if(args_info.field_separator_given){
+		// Accept the escaped form of the tab, since it is hard to type in the shell
+		if(strcmp(args_info.field_separator_arg, "\\t")==0){
+			key_spec->separator = '\t';
+		}else if(strlen(args_info.field_separator_arg)==1){
+			key_spec->separator = args_info.field_separator_arg[0];
+		}else{
+			printf("The field separator '%s' is not valid; it must be a single character\n", args_info.field_separator_arg);
+			return M_INVALID_KEY_SPECIFICATION;
+		}
+	}
+
+	switch(args_info.key_type_arg){
+		case key_type_arg_numeric:
+			key_spec->type = KEY_TYPE_NUMERIC;
+			break;
+		case key_type_arg_timestamp:
+			key_spec->type = KEY_TYPE_TIMESTAMP;
+			break;
+		default:
+			key_spec->type = KEY_TYPE_STRING;
+	}
+	return 0;
+}
+
 /**
  * @brief Process the input directory items
  * @param args_info the gengetopt_args_info object
+ * @param key_spec KEY_SPEC_T with the specification of the sort key
  * @param argc integer with main argument count
  * @param argv with the arguments
  * @return integer TRUE if the directory exists, FALSE otherwise
  *
  * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
-int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
+int processDir(struct gengetopt_args_info args_info, KEY_SPEC_T* key_spec, int argc, char *argv[]){
 	unsigned int a=0;																	// auxiliary integer for the algorithms parameters loop
 	int files_counter=0, files_total=0, algorithm_counter=0;							// integers to store some counters
 	int result;																			// auxiliary result integer
@@ -183,16 +283,31 @@ int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
 	ALGORITHM_FUNC algorithm_function=NULL;												// to store the algorithm function to use on the sort operation
 	CONTROLLER_STAT_T controller_stat;													// to store the statistical controller control
 	REMOTE_UDP_REQUEST_T rur_time, rur_results;											// to store the UDP request data for the UDP time server
+	RESULTS_SENDER_T results_sender;													// to send the results to the UDP results server on the background
+	long long dedupe_start;																// to measure the duplicates removal time
+	int nduplicates=0;																	// number of duplicated lines removed from the file
+	double dedupe_time=0;																// time spent removing the duplicated lines
 
 	// Begin of the function code
 	(void) argc; // silence the unused warning
 
 	// Verify if we really have a input and output parameters
 	if (args_info.input_given && args_info.output_given && args_info.serial_algorithm_given>0){
+		if(args_info.udp_timeout_arg<1 || args_info.udp_timeout_arg>UDP_MAXIMUM_TIMEOUT || args_info.udp_retries_arg<0){
+			printf("The UDP timeout %d or retries %d are not valid; use a timeout between 1 and %d ms\n", args_info.udp_timeout_arg, args_info.udp_retries_arg, UDP_MAXIMUM_TIMEOUT);
+			return M_INVALID_PARAMETERS;
+		}
 		// Initializes and, if requested, creates a socket UDP for the time server
 		rur_time.sock_fd = -1;
 		rur_time.server_addr = &udp_time_server_addr;
+		rur_time.samples = args_info.time_samples_arg;
+		rur_time.timeout = args_info.udp_timeout_arg;
+		rur_time.retries = args_info.udp_retries_arg;
 		if(args_info.time_server_addr_given && args_info.time_server_port_given){
+			if(rur_time.samples<1 || rur_time.samples>UDP_TIME_MAXIMUM_SAMPLES){
+				printf("The number of time samples %d is not valid; use a number between 1 and %d\n", rur_time.samples, UDP_TIME_MAXIMUM_SAMPLES);
+				return M_INVALID_PARAMETERS;
+			}
 			if((result = initialize_udp_connection(&rur_time, args_info.time_server_addr_arg, args_info.time_server_port_arg))!=0){
 				return result;
 			}
@@ -200,6 +315,9 @@ int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
 		// Initializes and, if requested, creates a socket UDP for the results server
 		rur_results.sock_fd = -1;
 		rur_results.server_addr = &udp_results_server_addr;
+		rur_results.samples = 0;
+		rur_results.timeout = args_info.udp_timeout_arg;
+		rur_results.retries = args_info.udp_retries_arg;
 		if(args_info.stats_server_given && args_info.stats_port_given){
 			if((result = initialize_udp_connection(&rur_results, args_info.stats_server_arg, args_info.stats_port_arg))!=0){
 				return result;
@@ -244,6 +362,13 @@ int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
 			ERROR(M_OPEN_DIR_FAILED,"\nError while open the input directory %s", args_info.input_arg);
 		}
 
+		// Start the thread that sends the results, so the sorts don't wait for the results server
+		if(rur_results.sock_fd>-1){
+			if((result = start_results_sender(&results_sender, rur_results))!=0){
+				ERROR(result, "\nError while starting the results sender thread\n");
+			}
+		}
+
 		// Set selected algorithms variable
 		for(a=0; a<args_info.serial_algorithm_given; a++){
 			if(a!=0){
@@ -275,6 +400,15 @@ int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
 					// Read the file to memory
 					if((flines = read_file(input_filename, MAXCHARS))!=NULL){
 						MY_DEBUG("Loading OK!\n");
+						// Parse the sort key of each line only once, for all the algorithms
+						build_sort_keys(flines, key_spec);
+						// On the unique mode, the algorithms only sort the distinct lines
+						if(args_info.unique_flag){
+							dedupe_start = get_sort_clock_time();
+							nduplicates = remove_duplicate_lines(flines);
+							dedupe_time = (get_sort_clock_time()-dedupe_start)/1000000.0;
+							MY_DEBUG("Removed %d duplicated lines\n", nduplicates);
+						}
 						files_counter++;
 						algorithm_counter=0;
 
@@ -310,12 +444,22 @@ int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
 								algorithm_function = shell_sort;
 								// Resets the statistical data for the current sort process
 								reset_stat(stat, dirItem->d_name, "shell");
+							}else if(args_info.serial_algorithm_arg[a]==serial_algorithm_arg_parallelMINUS_merge){
+								MY_DEBUG(" using the %s algorithm... \n", "parallel merge sort");
+								// Sets the sort function for the parallel merge sort algorithm
+								algorithm_function = parallel_merge_sort;
+								// Resets the statistical data for the current sort process
+								reset_stat(stat, dirItem->d_name, "parallel-merge");
 							}else{
 								ERROR(M_UNKNOWN_ALGORITHM, "Unknown algorithm\n");
 							}
+							stat->nbytes = (long) fileDetails.st_size;
 
 							// Sort the data
 							if((sorted_flines = sort_lines(clone_of_lines(flines), algorithm_function, stat, rur_time))!=NULL){
+								if(args_info.unique_flag){
+									set_dedupe_stat(stat, nduplicates, dedupe_time);
+								}
 								// Check if the output file exists
 								if(file_exists(output_filename, "r")!=TRUE){
 									// if not, write the file
@@ -332,11 +476,17 @@ int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
 								md5sum(md5sum_char,output_filename);
 
 								// Output the results or log it to the log file
-								printf("[%d/%d]%s:[%d/%d]%s:%.0f\n", files_counter, files_total, stat->filename, algorithm_counter, args_info.serial_algorithm_given, stat->algorithm, stat->time);
+								if(args_info.unique_flag){
+									printf("[%d/%d]%s:[%d/%d]%s:%.0f:%d duplicates (%.1f%%) removed in %.0f, %.0f saved\n", files_counter, files_total, stat->filename, algorithm_counter, args_info.serial_algorithm_given, stat->algorithm, stat->time, stat->nduplicates, ((stat->nlines+stat->nduplicates)>0)?100.0*stat->nduplicates/(stat->nlines+stat->nduplicates):0.0, stat->dedupe_time, stat->time_saved);
+								}else{
+									printf("[%d/%d]%s:[%d/%d]%s:%.0f\n", files_counter, files_total, stat->filename, algorithm_counter, args_info.serial_algorithm_given, stat->algorithm, stat->time);
+								}
 								// Append this new data to the shared memory
 								append_stat(&controller_stat, stat, _sigint_time!=NULL);
-								// Send result to the UDP results server
-								send_udp_result(rur_results, stat, NICKNAME, model_name, md5sum_char);
+								// Queue the result to the UDP results server
+								if(rur_results.sock_fd>-1){
+									queue_udp_result(&results_sender, stat, NICKNAME, model_name, md5sum_char);
+								}
 
 								// free the used memory for the lines clone
 								free_memory_of_clone_of_lines(sorted_flines);
@@ -379,8 +529,10 @@ int processDir(struct gengetopt_args_info args_info, int argc, char *argv[]){
 		if(rur_time.sock_fd>-1){
 			close(rur_time.sock_fd);
 		}
-		// If we have a results socket open, close it
+		// If we have a results socket open, send the queued results and close it
 		if(rur_results.sock_fd>-1){
+			stop_results_sender(&results_sender);
+			printf("Results: %ld accepted, %ld refused, %ld without response, %ld dropped\n", results_sender.accepted, results_sender.rejected, results_sender.lost, results_sender.dropped);
 			close(rur_results.sock_fd);
 		}
 
@@ -2,7 +2,9 @@
 #define __MAIN_H
 
 void print_log_header(struct gengetopt_args_info, int, char **);
-int processDir(struct gengetopt_args_info, int, char **);
+int parse_key_spec(struct gengetopt_args_info, KEY_SPEC_T*);
+int parse_clock(struct gengetopt_args_info);
+int processDir(struct gengetopt_args_info, KEY_SPEC_T*, int, char **);
 void handle_signal(int);
 void register_signal_handlers(void);
 void daemonize(struct gengetopt_args_info);
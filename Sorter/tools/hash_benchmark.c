@@ -0,0 +1,170 @@
+/**
+* @file hash_benchmark.c
+* @brief Microbenchmark of the HASHTABLE_T (3rd libs) against the open addressing HASH_MAP_T
+*
+* Usage: hash_benchmark [number of keys] [number of distinct keys]
+*
+* Runs the same deduplication pass (insert the key if absent) and a lookup pass of all the keys
+* on both tables, with and without reserving the room for the keys up front.
+*
+* @date 2010/01/18 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "../src/3rd/hashtables.h"
+#include "../src/includes/definitions.h"
+#include "../src/includes/aux.h"
+#include "../src/includes/hashlib.h"
+
+/**
+ * @brief Default number of keys of the benchmark
+ */
+#define BENCHMARK_KEYS 1000000
+
+/**
+ * @brief Default number of distinct keys of the benchmark
+ */
+#define BENCHMARK_DISTINCT_KEYS 200000
+
+/**
+ * @brief Print the results of a benchmark pass
+ * @param name of the table
+ * @param operation done on the pass
+ * @param keys number of keys processed
+ * @param distinct number of distinct keys found
+ * @param start of the pass
+ * @param end of the pass
+ * @param bytes used by the table
+ */
+static void print_result(char* name, char* operation, int keys, int distinct, struct timeval start, struct timeval end, long bytes){
+	float seconds = time_diff(start, end);
+
+	printf("%-22s %-7s %10d %10d %10.1f %10.2f %12ld\n", name, operation, keys, distinct, seconds*1000, (seconds>0)?keys/seconds/1000000:0, bytes);
+}
+
+/**
+ * @brief Benchmark the HASHTABLE_T from the 3rd libs
+ * @param name of the test
+ * @param keys to insert
+ * @param num_keys number of keys
+ * @param initial_size of the table
+ */
+static void benchmark_hashtable(char* name, char** keys, int num_keys, int initial_size){
+	HASHTABLE_T* table = tabela_criar(initial_size, NULL);
+	struct timeval start, end;
+	long bytes;
+	int a, found=0;
+
+	gettimeofday(&start, NULL);
+	for(a=0; a<num_keys; a++){
+		if(tabela_consultar(table, keys[a])==NULL){
+			tabela_inserir(table, keys[a], keys[a]);
+		}
+	}
+	gettimeofday(&end, NULL);
+
+	// Array of pointers, plus an entry and a copy of the key per insert
+	bytes = table->tamanho*sizeof(ENTRADA_T*)+tabela_numero_elementos(table)*sizeof(ENTRADA_T);
+	for(a=0; a<table->tamanho; a++){
+		if(table->entradas[a]!=NULL){
+			bytes += strlen(table->entradas[a]->chave)+1;
+		}
+	}
+	print_result(name, "dedupe", num_keys, tabela_numero_elementos(table), start, end, bytes);
+
+	gettimeofday(&start, NULL);
+	for(a=0; a<num_keys; a++){
+		found += (tabela_consultar(table, keys[a])!=NULL);
+	}
+	gettimeofday(&end, NULL);
+	print_result(name, "lookup", num_keys, found, start, end, bytes);
+
+	tabela_destruir(&table);
+}
+
+/**
+ * @brief Benchmark the open addressing HASH_MAP_T
+ * @param name of the test
+ * @param keys to insert
+ * @param num_keys number of keys
+ * @param elements to reserve room for
+ */
+static void benchmark_hash_map(char* name, char** keys, int num_keys, int elements){
+	HASH_MAP_T* map = hash_map_create(elements);
+	struct timeval start, end;
+	long bytes;
+	int a, found=0;
+
+	gettimeofday(&start, NULL);
+	for(a=0; a<num_keys; a++){
+		hash_map_insert(map, keys[a], strlen(keys[a]), keys[a]);
+	}
+	gettimeofday(&end, NULL);
+
+	// Only the slots array, the keys aren't copied
+	bytes = map->capacity*sizeof(HASH_MAP_ENTRY_T);
+	print_result(name, "dedupe", num_keys, hash_map_count(map), start, end, bytes);
+
+	gettimeofday(&start, NULL);
+	for(a=0; a<num_keys; a++){
+		found += (hash_map_find(map, keys[a], strlen(keys[a]))!=NULL);
+	}
+	gettimeofday(&end, NULL);
+	print_result(name, "lookup", num_keys, found, start, end, bytes);
+
+	hash_map_free(map);
+}
+
+/**
+ * @brief Main function
+ * @param argc number of arguments
+ * @param argv arguments (number of keys and number of distinct keys)
+ * @return integer with the exit code
+ */
+int main(int argc, char *argv[]){
+	int num_keys = (argc>1)?atoi(argv[1]):BENCHMARK_KEYS;
+	int num_distinct = (argc>2)?atoi(argv[2]):BENCHMARK_DISTINCT_KEYS;
+	char** distinct_keys = NULL;
+	char** keys = NULL;
+	char key[MAXCHARS];
+	int a;
+
+	if(num_keys<=0 || num_distinct<=0){
+		fprintf(stderr, "Usage: %s [number of keys] [number of distinct keys]\n", argv[0]);
+		return M_INVALID_PARAMETERS;
+	}
+
+	if((distinct_keys = malloc(sizeof(char*)*num_distinct))==NULL || (keys = malloc(sizeof(char*)*num_keys))==NULL){
+		fprintf(stderr, "Error in memory allocation\n");
+		return M_FAILED_MEMORY_ALLOCATION;
+	}
+
+	// Lines like the ones of a CSV file, picked at random from the distinct set (with a fixed seed, so the runs can be compared)
+	srand(1);
+	for(a=0; a<num_distinct; a++){
+		snprintf(key, sizeof(key), "%d,%08x,row %d of the benchmark\n", rand(), rand(), a);
+		distinct_keys[a] = strdup(key);
+	}
+	for(a=0; a<num_keys; a++){
+		keys[a] = distinct_keys[rand()%num_distinct];
+	}
+
+	printf("%-22s %-7s %10s %10s %10s %10s %12s\n", "table", "pass", "keys", "distinct", "ms", "Mkeys/s", "bytes");
+	benchmark_hashtable("HASHTABLE_T", keys, num_keys, 16);
+	benchmark_hashtable("HASHTABLE_T reserved", keys, num_keys, num_distinct*2+1);
+	benchmark_hash_map("HASH_MAP_T", keys, num_keys, 0);
+	benchmark_hash_map("HASH_MAP_T reserved", keys, num_keys, num_distinct);
+
+	for(a=0; a<num_distinct; a++){
+		free(distinct_keys[a]);
+	}
+	free(distinct_keys);
+	free(keys);
+
+	return 0;
+}
@@ -0,0 +1,196 @@
+/**
+* @file vector_benchmark.c
+* @brief Microbenchmark of the LISTA_GENERICA_T (3rd libs) against the contiguous VECTOR_T
+*
+* Usage: vector_benchmark [number of elements] [number of elements of the sorted iteration]
+*
+* Fills both containers with the same statistical records, iterates them and iterates them sorted by time.
+* The sorted iteration of the list inserts each element in order (quadratic), so it uses a smaller count by default.
+*
+* @date 2010/01/20 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "../src/3rd/listas.h"
+#include "../src/includes/definitions.h"
+#include "../src/includes/aux.h"
+#include "../src/includes/commonlib.h"
+#include "../src/includes/vectorlib.h"
+
+/**
+ * @brief Default number of elements of the benchmark
+ */
+#define BENCHMARK_ELEMENTS 1000000
+
+/**
+ * @brief Default number of elements of the sorted iteration benchmark
+ */
+#define BENCHMARK_SORTED_ELEMENTS 20000
+
+/**
+ * @brief Print the results of a benchmark pass
+ * @param name of the container
+ * @param operation done on the pass
+ * @param elements number of elements processed
+ * @param start of the pass
+ * @param end of the pass
+ * @param checksum of the pass, to compare the containers
+ */
+static void print_result(char* name, char* operation, int elements, struct timeval start, struct timeval end, double checksum){
+	float seconds = time_diff(start, end);
+
+	printf("%-18s %-8s %10d %10.1f %10.2f %16.0f\n", name, operation, elements, seconds*1000, (seconds>0)?elements/seconds/1000000:0, checksum);
+}
+
+/**
+ * @brief Compare two statistical records by the time
+ * @param a ALGORITHM_STAT_T to compare with the next parameter
+ * @param b ALGORITHM_STAT_T to compare with the previous parameter
+ * @return integer lower than 0 if a is lower than b, 0 if they are equal, greater than 0 otherwise
+ */
+static int compare_stats_time(void* a, void* b){
+	double time_a = ((ALGORITHM_STAT_T*) a)->time, time_b = ((ALGORITHM_STAT_T*) b)->time;
+
+	return (time_a > time_b) - (time_a < time_b);
+}
+
+/**
+ * @brief Benchmark the LISTA_GENERICA_T from the 3rd libs
+ * @param stats records to store
+ * @param num_elements number of records
+ * @param num_sorted number of records of the sorted iteration
+ */
+static void benchmark_list(ALGORITHM_STAT_T* stats, int num_elements, int num_sorted){
+	LISTA_GENERICA_T* list;
+	ITERADOR_T* iterator;
+	ALGORITHM_STAT_T* stat;
+	struct timeval start, end;
+	double checksum = 0, weight = 0;
+	int a;
+
+	list = lista_criar(NULL);
+	gettimeofday(&start, NULL);
+	for(a=0; a<num_elements; a++){
+		lista_inserir(list, &(stats[a]));
+	}
+	gettimeofday(&end, NULL);
+	print_result("LISTA_GENERICA_T", "insert", num_elements, start, end, lista_numero_elementos(list));
+
+	gettimeofday(&start, NULL);
+	iterator = lista_criar_iterador(list);
+	while((stat = iterador_proximo_elemento(iterator))!=NULL){
+		checksum += stat->time;
+	}
+	iterador_destruir(&iterator);
+	gettimeofday(&end, NULL);
+	print_result("LISTA_GENERICA_T", "iterate", num_elements, start, end, checksum);
+	lista_destruir(&list);
+
+	list = lista_criar(NULL);
+	for(a=0; a<num_sorted; a++){
+		lista_inserir(list, &(stats[a]));
+	}
+	checksum = 0;
+	gettimeofday(&start, NULL);
+	iterator = lista_criar_iterador_ordenado(list, compare_stats_time);
+	while((stat = iterador_proximo_elemento(iterator))!=NULL){
+		checksum += stat->time*(++weight);
+	}
+	iterador_destruir(&iterator);
+	gettimeofday(&end, NULL);
+	print_result("LISTA_GENERICA_T", "sorted", num_sorted, start, end, checksum);
+	lista_destruir(&list);
+}
+
+/**
+ * @brief Benchmark the contiguous VECTOR_T
+ * @param stats records to store
+ * @param num_elements number of records
+ * @param num_sorted number of records of the sorted iteration
+ */
+static void benchmark_vector(ALGORITHM_STAT_T* stats, int num_elements, int num_sorted){
+	VECTOR_T* vector;
+	VECTOR_ITERADOR_T iterator;
+	ALGORITHM_STAT_T* stat;
+	struct timeval start, end;
+	double checksum = 0, weight = 0;
+	int a;
+
+	vector = vector_criar(0, NULL);
+	gettimeofday(&start, NULL);
+	for(a=0; a<num_elements; a++){
+		vector_inserir(vector, &(stats[a]));
+	}
+	gettimeofday(&end, NULL);
+	print_result("VECTOR_T", "insert", num_elements, start, end, vector_numero_elementos(vector));
+
+	gettimeofday(&start, NULL);
+	vector_iterador_iniciar(&iterator, vector);
+	while((stat = vector_iterador_proximo_elemento(&iterator))!=NULL){
+		checksum += stat->time;
+	}
+	gettimeofday(&end, NULL);
+	print_result("VECTOR_T", "iterate", num_elements, start, end, checksum);
+	vector_destruir(&vector);
+
+	vector = vector_criar(num_sorted, NULL);
+	for(a=0; a<num_sorted; a++){
+		vector_inserir(vector, &(stats[a]));
+	}
+	checksum = 0;
+	gettimeofday(&start, NULL);
+	vector_ordenar(vector, compare_stats_time);
+	vector_iterador_iniciar(&iterator, vector);
+	while((stat = vector_iterador_proximo_elemento(&iterator))!=NULL){
+		checksum += stat->time*(++weight);
+	}
+	gettimeofday(&end, NULL);
+	print_result("VECTOR_T", "sorted", num_sorted, start, end, checksum);
+	vector_destruir(&vector);
+}
+
+/**
+ * @brief Main function
+ * @param argc number of arguments
+ * @param argv arguments (number of elements and number of elements of the sorted iteration)
+ * @return integer with the exit code
+ */
+int main(int argc, char *argv[]){
+	int num_elements = (argc>1)?atoi(argv[1]):BENCHMARK_ELEMENTS;
+	int num_sorted = (argc>2)?atoi(argv[2]):BENCHMARK_SORTED_ELEMENTS;
+	ALGORITHM_STAT_T* stats = NULL;
+	int a;
+
+	if(num_elements<=0 || num_sorted<=0){
+		fprintf(stderr, "Usage: %s [number of elements] [number of elements of the sorted iteration]\n", argv[0]);
+		return M_INVALID_PARAMETERS;
+	}
+	if(num_sorted>num_elements){
+		num_sorted = num_elements;
+	}
+
+	if((stats = calloc(num_elements, sizeof(ALGORITHM_STAT_T)))==NULL){
+		fprintf(stderr, "Error in memory allocation\n");
+		return M_FAILED_MEMORY_ALLOCATION;
+	}
+
+	// Records with random times (and a fixed seed, so the runs can be compared)
+	srand(1);
+	for(a=0; a<num_elements; a++){
+		stats[a].nlines = a;
+		stats[a].time = rand()%100000;
+	}
+
+	printf("%-18s %-8s %10s %10s %10s %16s\n", "container", "pass", "elements", "ms", "Melem/s", "checksum");
+	benchmark_list(stats, num_elements, num_sorted);
+	benchmark_vector(stats, num_elements, num_sorted);
+
+	free(stats);
+
+	return 0;
+}
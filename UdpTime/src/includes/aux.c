@@ -426,3 +426,25 @@ int ends_with(const char* haystack, const char* needle){
     }
     return FALSE;
 }
+
+/**
+ * @brief Allocate a zeroed array with the given alignment
+ *
+ * Used for the arrays of structures aligned to the cache lines: calloc only aligns to 16 bytes, so the elements of
+ * neighbouring threads could still share a line
+ *
+ * @param count number of elements
+ * @param size of each element
+ * @param alignment of the array (a power of two, multiple of the size of a pointer)
+ * @return reference to the allocated memory (to be released with free), NULL on failure
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void* aligned_calloc(size_t count, size_t size, size_t alignment){
+	void* memory=NULL;
+	if(posix_memalign(&memory, alignment, count*size)!=0){
+		return NULL;
+	}
+	memset(memory, 0, count*size);
+	return memory;
+}
@@ -32,5 +32,6 @@ void md5sum(char*, char*);
 char* get_line_from_file(char*, int, char*, char*, char*);
 char* get_model_name(void);
 int ends_with(const char*, const char*);
+void* aligned_calloc(size_t, size_t, size_t);
 
 #endif /* AUX_H_ */
@@ -38,11 +38,102 @@
  */
 #define PORT_RANGE_MAX 65535
 
+/**
+ * Default number of requests received (recvmmsg) and answered (sendmmsg) with a single call
+ */
+#define UDP_BATCH_SIZE 32
+
+/**
+ * Maximum number of requests of each batch
+ */
+#define UDP_MAXIMUM_BATCH_SIZE 1024
+
+/**
+ * Number of bytes kept of each request (the text requests have no content, the rest is discarded)
+ */
+#define UDP_REQUEST_SIZE 64
+
+/**
+ * Maximum number of bytes of a response (text or binary)
+ */
+#define UDP_RESPONSE_SIZE 32
+
+/**
+ * Magic number of the binary time protocol ("UT"), on the first 2 bytes of the requests and of the responses
+ */
+#define UDP_TIME_MAGIC 0x5554
+
+/**
+ * Version of the binary time protocol (the requests with another version get the text response)
+ */
+#define UDP_TIME_VERSION 1
+
+/**
+ * Number of bytes of a binary request: magic (2), version (1), reserved (5) and nonce (8), in network byte order
+ */
+#define UDP_TIME_REQUEST_SIZE 16
+
+/**
+ * Number of bytes of a binary response: magic (2), version (1), clock (1), reserved (4), nonce of the request (8),
+ * receive time (8) and transmit time (8), in network byte order (times in nanoseconds since the epoch)
+ */
+#define UDP_TIME_RESPONSE_SIZE 32
+
+/**
+ * Clock of the times of a response: the realtime clock of the server (CLOCK_REALTIME, can be stepped)
+ */
+#define UDP_TIME_CLOCK_REALTIME 0
+
+/**
+ * Clock of the times of a response: the monotonic clock of the server (CLOCK_MONOTONIC, slewed but never stepped)
+ */
+#define UDP_TIME_CLOCK_MONOTONIC 1
+
+/**
+ * Clock of the times of a response: the raw monotonic clock of the server (CLOCK_MONOTONIC_RAW, the hardware rate)
+ */
+#define UDP_TIME_CLOCK_MONOTONIC_RAW 2
+
+/**
+ * Maximum number of threads of the server (each with its own socket on the port)
+ */
+#define UDP_MAXIMUM_THREADS 256
+
+/**
+ * Number of requests of the log ring of each server thread (a power of 2; the requests are dropped from the log while full)
+ */
+#define UDP_LOG_RING_SIZE 4096
+
+/**
+ * Default maximum number of requests logged each second (the others are only counted)
+ */
+#define UDP_LOG_RATE 1000
+
+/**
+ * Time (ms) the log thread sleeps while there are no requests to log
+ */
+#define UDP_LOG_INTERVAL 10
+
+/**
+ * Number of buckets of the latency histograms (8 for each power of 2 of nanoseconds)
+ */
+#define UDP_LATENCY_BUCKETS 512
+
 /**
  * The nickname for the results server
  */
 #define NICKNAME "antiThreads"
 
+/**
+ * Maximum number of bytes of a results datagram (the UDP payload of an Ethernet frame, so a batch is never fragmented)
+ */
+#define RESULTS_BATCH_SIZE 1472
+
+/**
+ * First line of a batch of results and of its response, followed by a space and the number of the batch ("#BATCH 42")
+ */
+#define RESULTS_BATCH_HEADER "#BATCH"
+
 /**
  * The global definition for the "-ERR Invalid format" server error message
  */
@@ -0,0 +1,156 @@
+/**
+* @file udploglib.c
+* @brief Source file for the asynchronous log of the requests and the latency histograms of the UdpTime
+*
+* The server threads only copy the data of a request to their ring (no formatting nor I/O before or after the
+* response); the log thread takes the entries of all the rings and writes the lines.
+*
+* @date 2010/02/12 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "udploglib.h"
+
+/**
+ * @brief Add a request to the ring (by the producer)
+ * @param ring UDP_LOG_RING_T to update
+ * @param entry UDP_LOG_ENTRY_T with the request
+ * @return integer TRUE if added, FALSE if the ring is full (the entry is counted as dropped)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int udp_log_push(UDP_LOG_RING_T* ring, UDP_LOG_ENTRY_T* entry){
+	unsigned long head = ring->head;
+
+	if(head-__atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE)>=UDP_LOG_RING_SIZE){
+		ring->dropped++;
+		return FALSE;
+	}
+	ring->entries[head%UDP_LOG_RING_SIZE] = *entry;
+	// The entry is visible to the consumer before the new head
+	__atomic_store_n(&(ring->head), head+1, __ATOMIC_RELEASE);
+	return TRUE;
+}
+
+/**
+ * @brief Take the oldest request from the ring (by the consumer)
+ * @param ring UDP_LOG_RING_T to update
+ * @param entry UDP_LOG_ENTRY_T to store the request
+ * @return integer TRUE if taken, FALSE if the ring is empty
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int udp_log_pop(UDP_LOG_RING_T* ring, UDP_LOG_ENTRY_T* entry){
+	unsigned long tail = ring->tail;
+
+	if(tail==__atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE)){
+		return FALSE;
+	}
+	*entry = ring->entries[tail%UDP_LOG_RING_SIZE];
+	// The entry is copied before the producer can reuse it
+	__atomic_store_n(&(ring->tail), tail+1, __ATOMIC_RELEASE);
+	return TRUE;
+}
+
+/**
+ * @brief Get the bucket of a latency
+ * @param value latency (ns)
+ * @return integer with the bucket
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int udp_latency_bucket(unsigned long long value){
+	int exponent;
+
+	if(value<8){
+		return value;
+	}
+	// The power of 2 and the 3 bits after the most significant one
+	exponent = 63-__builtin_clzll(value);
+	return (exponent-2)*8+((value>>(exponent-3))&7);
+}
+
+/**
+ * @brief Get the middle value of a bucket
+ * @param bucket of the histogram
+ * @return long long with the latency (ns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static unsigned long long udp_latency_value(int bucket){
+	int exponent;
+
+	if(bucket<8){
+		return bucket;
+	}
+	exponent = bucket/8+2;
+	return ((8ULL+bucket%8)<<(exponent-3))+((1ULL<<(exponent-3))>>1);
+}
+
+/**
+ * @brief Add a latency to a histogram (by a single thread)
+ * @param latency UDP_LATENCY_T to update
+ * @param value latency (ns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void udp_latency_add(UDP_LATENCY_T* latency, unsigned long long value){
+	latency->counts[udp_latency_bucket(value)]++;
+	latency->count++;
+	if(value>latency->maximum){
+		latency->maximum = value;
+	}
+}
+
+/**
+ * @brief Add the latencies of a histogram to another (the source can still be updated by its thread, so the result is approximate)
+ * @param destination UDP_LATENCY_T to update
+ * @param source UDP_LATENCY_T with the latencies to add
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void udp_latency_merge(UDP_LATENCY_T* destination, UDP_LATENCY_T* source){
+	unsigned long long count = 0;
+	int a;
+
+	for(a=0; a<UDP_LATENCY_BUCKETS; a++){
+		destination->counts[a] += source->counts[a];
+		count += source->counts[a];
+	}
+	// The count of the buckets copied, so the percentiles are consistent
+	destination->count += count;
+	if(source->maximum>destination->maximum){
+		destination->maximum = source->maximum;
+	}
+}
+
+/**
+ * @brief Get a percentile of the latencies of a histogram
+ * @param latency UDP_LATENCY_T with the latencies
+ * @param percentile to get (between 0 and 1)
+ * @return long long with the latency (ns), 0 if there are none
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+unsigned long long udp_latency_percentile(UDP_LATENCY_T* latency, double percentile){
+	unsigned long long rank, count = 0, value;
+	int a;
+
+	if(latency->count==0){
+		return 0;
+	}
+	rank = (unsigned long long)(percentile*(latency->count-1))+1;
+	for(a=0; a<UDP_LATENCY_BUCKETS; a++){
+		count += latency->counts[a];
+		if(count>=rank){
+			value = udp_latency_value(a);
+			return (value<latency->maximum)?value:latency->maximum;
+		}
+	}
+	return latency->maximum;
+}
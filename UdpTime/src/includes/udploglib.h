@@ -0,0 +1,49 @@
+/**
+* @file udploglib.h
+* @brief Header file for the asynchronous log of the requests and the latency histograms of the UdpTime
+* @date 2010/02/12 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef UDPLOGLIB_H_
+#define UDPLOGLIB_H_
+
+#include <netinet/in.h>
+
+/**
+ * @brief Type declaration to a structure to store a request to log (formatted only by the log thread)
+ */
+typedef struct udp_log_entry {
+	struct in_addr address;						/**< @brief address of the client */
+	unsigned short port;						/**< @brief port of the client (network byte order) */
+	unsigned int service_time;					/**< @brief time (ns) from the receipt of the datagram to the send of the response */
+	unsigned long long timestamp;				/**< @brief time sent to the client */
+} UDP_LOG_ENTRY_T;
+
+/**
+ * @brief Type declaration to a structure to store a ring of requests to log, with a single producer (a server thread) and
+ * a single consumer (the log thread), so neither of them takes a lock
+ */
+typedef struct udp_log_ring {
+	unsigned long head __attribute__((aligned(64)));	/**< @brief number of entries added (only changed by the producer) */
+	unsigned long dropped;								/**< @brief number of entries lost with the ring full (only changed by the producer) */
+	unsigned long tail __attribute__((aligned(64)));	/**< @brief number of entries taken (only changed by the consumer) */
+	UDP_LOG_ENTRY_T entries[UDP_LOG_RING_SIZE];			/**< @brief the entries (circular) */
+} UDP_LOG_RING_T;
+
+/**
+ * @brief Type declaration to a structure to store a histogram of latencies, with 8 buckets for each power of 2 (error under 12.5%)
+ */
+typedef struct udp_latency {
+	unsigned long long counts[UDP_LATENCY_BUCKETS];		/**< @brief number of latencies of each bucket */
+	unsigned long long count;							/**< @brief number of latencies */
+	unsigned long long maximum;							/**< @brief largest latency (ns) */
+} UDP_LATENCY_T;
+
+int udp_log_push(UDP_LOG_RING_T*, UDP_LOG_ENTRY_T*);
+int udp_log_pop(UDP_LOG_RING_T*, UDP_LOG_ENTRY_T*);
+void udp_latency_add(UDP_LATENCY_T*, unsigned long long);
+void udp_latency_merge(UDP_LATENCY_T*, UDP_LATENCY_T*);
+unsigned long long udp_latency_percentile(UDP_LATENCY_T*, double);
+
+#endif /* UDPLOGLIB_H_ */
@@ -0,0 +1,472 @@
+/**
+* @file udptimelib.c
+* @brief Source file for the requests of the UdpTime (batched, on one or more threads with their own sockets)
+*
+* The requests with the binary header (UDP_TIME_MAGIC and UDP_TIME_VERSION) get a binary response with their nonce and
+* the receive and transmit times in nanoseconds; any other request (e.g. empty) gets the text response, the time in
+* microseconds.
+*
+* Each batch waits for the first request and takes all the others already waiting (up to the size of the batch) with a
+* single recvmmsg, and answers all of them with a single sendmmsg, so many clients don't cost two system calls each.
+*
+* Each thread has its own socket bound to the port (SO_REUSEPORT), so the kernel spreads the clients by the threads
+* without any lock between them.
+*
+* Nothing is formatted nor written between the receipt of a request and the send of its response: the requests are
+* logged by a separate thread (see udploglib), and the time between the receipt of each datagram by the kernel and the
+* send of its response is kept on a histogram of each thread.
+*
+* @date 2010/02/10 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#define _GNU_SOURCE // for the recvmmsg, sendmmsg and pthread_setaffinity_np
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <limits.h>
+#include <time.h>
+#include <endian.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "../3rd/debug.h"
+#include "definitions.h"
+#include "aux.h"
+#include "udptimelib.h"
+
+/**
+ * @brief Get the time a request was received by the kernel
+ * @param message msghdr of the request, with the ancillary data
+ * @param now time (ns) to use if the kernel didn't set the receipt time
+ * @return long long with the time (ns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static unsigned long long udp_receipt_time(struct msghdr* message, unsigned long long now){
+	struct cmsghdr *control;
+	struct timespec receipt;
+
+	for(control=CMSG_FIRSTHDR(message); control!=NULL; control=CMSG_NXTHDR(message, control)){
+		if(control->cmsg_level==SOL_SOCKET && control->cmsg_type==SCM_TIMESTAMPNS){
+			memcpy(&receipt, CMSG_DATA(control), sizeof(receipt));
+			return receipt.tv_sec*1000000000ULL+receipt.tv_nsec;
+		}
+	}
+	return now;
+}
+
+/**
+ * @brief Get the current time of the realtime clock (the same of the receipt times of the kernel)
+ * @return long long with the time (ns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static unsigned long long udp_now(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return now.tv_sec*1000000000ULL+now.tv_nsec;
+}
+
+/**
+ * @brief Get the current time of the clock of the responses
+ * @param clock of the responses (UDP_TIME_CLOCK_REALTIME, UDP_TIME_CLOCK_MONOTONIC or UDP_TIME_CLOCK_MONOTONIC_RAW)
+ * @param realtime current time (ns) of the realtime clock, used for its clock
+ * @return long long with the time (ns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static unsigned long long udp_clock_time(int clock, unsigned long long realtime){
+	struct timespec now;
+
+	switch(clock){
+		case UDP_TIME_CLOCK_MONOTONIC:
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			break;
+		case UDP_TIME_CLOCK_MONOTONIC_RAW:
+			clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+			break;
+		default:
+			return realtime;
+	}
+	return now.tv_sec*1000000000ULL+now.tv_nsec;
+}
+
+/**
+ * @brief Build the response to a request (binary if the request is binary, text otherwise)
+ * @param request bytes of the request
+ * @param length number of bytes of the request
+ * @param receipt time (ns) the request was received, on the clock of the responses
+ * @param now time (ns) to send, on the clock of the responses
+ * @param clock of the responses (UDP_TIME_CLOCK_*)
+ * @param response buffer to store the response (UDP_RESPONSE_SIZE bytes)
+ * @return integer with the number of bytes of the response
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static int udp_time_response(char* request, int length, unsigned long long receipt, unsigned long long now, int clock, char* response){
+	uint16_t magic;
+	uint64_t value;
+
+	if(length>=UDP_TIME_REQUEST_SIZE){
+		memcpy(&magic, request, sizeof(magic));
+		if(ntohs(magic)==UDP_TIME_MAGIC && (unsigned char)request[2]==UDP_TIME_VERSION){
+			memset(response, 0, UDP_TIME_RESPONSE_SIZE);
+			memcpy(response, &magic, sizeof(magic));
+			response[2] = UDP_TIME_VERSION;
+			response[3] = clock;
+			// The nonce is echoed as received (opaque to the server)
+			memcpy(response+8, request+8, sizeof(value));
+			value = htobe64(receipt);
+			memcpy(response+16, &value, sizeof(value));
+			value = htobe64(now);
+			memcpy(response+24, &value, sizeof(value));
+			return UDP_TIME_RESPONSE_SIZE;
+		}
+	}
+	return snprintf(response, UDP_RESPONSE_SIZE, "%llu", now/1000);
+}
+
+/**
+ * @brief Record an answered request (on the latency histogram and, if sampled, on the log ring)
+ * @param worker UDP_WORKER_T of the thread
+ * @param address of the client
+ * @param service_time time (ns) from the receipt of the request to the send of the response
+ * @param timestamp time sent to the client
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void udp_record_request(UDP_WORKER_T* worker, struct sockaddr_in* address, long long service_time, unsigned long long timestamp){
+	UDP_LOG_ENTRY_T entry;
+
+	// The clock can step back between the receipt and the send
+	if(service_time<0){
+		service_time = 0;
+	}
+	udp_latency_add(&(worker->latency), service_time);
+	if(worker->log_sample>0 && ++(worker->log_counter)>=(unsigned long)worker->log_sample){
+		worker->log_counter = 0;
+		entry.address = address->sin_addr;
+		entry.port = address->sin_port;
+		entry.service_time = (service_time<UINT_MAX)?service_time:UINT_MAX;
+		entry.timestamp = timestamp;
+		udp_log_push(worker->log_ring, &entry);
+	}
+}
+
+/**
+ * @brief Wait for a client request and send back a time of day string
+ * @param worker UDP_WORKER_T of the thread, with the server socket reference
+ * @return integer with the number of requests answered (1)
+ *
+ * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int wait_for_request(UDP_WORKER_T* worker){
+	struct sockaddr_in cli_addr;		// To store the socket of the client
+	struct msghdr message;				// To store the request, with the receipt time
+	struct iovec request_iovec;			// To store the buffer of the request
+	char request[UDP_REQUEST_SIZE];		// To store the request of the client
+	char control[UDP_CONTROL_SIZE];		// To store the ancillary data of the request
+	char response[UDP_RESPONSE_SIZE];	// To store the response to send to the client
+	unsigned long long receipt, sent, now;
+	ssize_t length;
+
+	memset(&message, 0, sizeof(message));
+	request_iovec.iov_base = request;
+	request_iovec.iov_len = sizeof(request);
+	message.msg_name = &cli_addr;
+	message.msg_namelen = sizeof(cli_addr);
+	message.msg_iov = &request_iovec;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+	// Receive the request from the client
+	if ((length = recvmsg(worker->sock_fd, &message, 0)) == -1){
+		ERROR(M_RECVFROM_ERROR, "\nError occurred while receiving the request from the client.\n");
+	}
+	// Get the time of the day, sent in the response (the receipt time of the kernel is moved to the clock of the responses)
+	sent = udp_now();
+	receipt = udp_receipt_time(&message, sent);
+	now = udp_clock_time(worker->clock, sent);
+	length = udp_time_response(request, length, now-(sent-receipt), now, worker->clock, response);
+
+	if (sendto(worker->sock_fd, response, length, 0, (struct sockaddr *) &cli_addr, message.msg_namelen) < 0){
+		ERROR(M_SENDTO_ERROR, "\nError while sending the response to the client\n");
+	}
+	udp_record_request(worker, &cli_addr, sent-receipt, now/1000);
+	return 1;
+}
+
+/**
+ * @brief Create a UDP socket bound to the port on all the interfaces
+ * @param port number to listen
+ * @param reuse_port TRUE to share the port with the sockets of the other threads (SO_REUSEPORT)
+ * @return integer with the socket
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int create_udp_socket(long port, int reuse_port){
+	int sock_fd, yes=1;
+	struct sockaddr_in ser_addr;			// to store the sockaddr_in structure
+
+	/* Creates the socket */
+	if ((sock_fd = socket(AF_INET, SOCK_DGRAM, 0)) == -1){
+		ERROR(M_SOCKET_CREATION_ERROR, "\nError while creating the application socket.\n");
+	}
+	// The kernel gives the receipt time of each request (for the latency histograms)
+	if (setsockopt(sock_fd, SOL_SOCKET, SO_TIMESTAMPNS, &yes, sizeof(int)) == -1) {
+		ERROR(M_SETSOCKOPT_ERROR, "\nError while setting the socket options\n");
+	}
+	// Each thread has its own socket on the same port (the kernel chooses one for each client)
+	if (reuse_port==TRUE && setsockopt(sock_fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(int)) == -1) {
+		ERROR(M_SETSOCKOPT_ERROR, "\nError while setting the socket options\n");
+	}
+
+	/* Initializes the sockaddr_in structure with the socket information */
+	memset(&ser_addr, 0, sizeof(ser_addr));
+	ser_addr.sin_family = AF_INET;
+	ser_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	ser_addr.sin_port = htons(port);
+
+	/* Register the socket */
+	if (bind(sock_fd, (struct sockaddr *)&ser_addr, sizeof(ser_addr)) == -1){
+		ERROR(M_BIND_SOCKET_ERROR, "\nError binding the socket.\n");
+	}
+	return sock_fd;
+}
+
+/**
+ * @brief Thread of the server, answering the requests of its socket
+ * @param arg UDP_WORKER_T with the data of the thread
+ * @return NULL (never returns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void *udp_serve(void *arg){
+	UDP_WORKER_T *worker = (UDP_WORKER_T*) arg;
+	cpu_set_t cpus;
+	int count;
+
+	if(worker->cpu>=0){
+		CPU_ZERO(&cpus);
+		CPU_SET(worker->cpu, &cpus);
+		if(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)!=0){
+			MY_DEBUG("\nUnable to run the thread %d on the CPU %d\n", worker->index, worker->cpu);
+		}
+	}
+	if(worker->batch_size>1){
+		worker->batch = create_udp_batch(worker->batch_size);
+	}
+	while (1) {
+		if(worker->batch!=NULL){
+			/* Wait for the requests */
+			count = serve_udp_batch(worker);
+		}else{
+			/* Wait for an request */
+			count = wait_for_request(worker);
+		}
+		// Atomic, so the main thread reads the counters without a lock
+		__sync_fetch_and_add(&(worker->requests), count);
+		__sync_fetch_and_add(&(worker->batches), 1);
+		if(count>worker->largest_batch){
+			worker->largest_batch = count;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Print the counters and the latencies of each thread of the server
+ * @param workers UDP_WORKER_T with the data of the threads
+ * @param threads number of threads
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void print_udp_workers(UDP_WORKER_T* workers, int threads){
+	long long requests, batches, total=0;
+	unsigned long dropped, total_dropped=0;
+	UDP_LATENCY_T latency, total_latency;
+	int a;
+
+	memset(&total_latency, 0, sizeof(total_latency));
+	printf("\n%-8s %-6s %14s %10s %8s %8s %9s %9s %9s %9s %10s\n", "thread", "cpu", "requests", "batches", "average", "largest", "p50 us", "p99 us", "p99.9 us", "max us", "not logged");
+	for(a=0; a<threads; a++){
+		requests = __sync_fetch_and_add(&(workers[a].requests), 0);
+		batches = __sync_fetch_and_add(&(workers[a].batches), 0);
+		dropped = (workers[a].log_ring!=NULL)?__atomic_load_n(&(workers[a].log_ring->dropped), __ATOMIC_RELAXED):0;
+		total += requests;
+		total_dropped += dropped;
+		memset(&latency, 0, sizeof(latency));
+		udp_latency_merge(&latency, &(workers[a].latency));
+		udp_latency_merge(&total_latency, &(workers[a].latency));
+		printf("%-8d %-6d %14lld %10lld %8.1f %8d %9.1f %9.1f %9.1f %9.1f %10lu\n", workers[a].index, workers[a].cpu, requests, batches, (batches>0)?(double)requests/batches:0, workers[a].largest_batch, udp_latency_percentile(&latency, 0.5)/1000.0, udp_latency_percentile(&latency, 0.99)/1000.0, udp_latency_percentile(&latency, 0.999)/1000.0, latency.maximum/1000.0, dropped);
+	}
+	printf("%-8s %-6s %14lld %10s %8s %8s %9.1f %9.1f %9.1f %9.1f %10lu\n", "total", "", total, "", "", "", udp_latency_percentile(&total_latency, 0.5)/1000.0, udp_latency_percentile(&total_latency, 0.99)/1000.0, udp_latency_percentile(&total_latency, 0.999)/1000.0, total_latency.maximum/1000.0, total_dropped);
+	fflush(stdout);
+}
+
+/**
+ * @brief Allocate the buffers of a batch of requests
+ * @param size maximum number of requests of a batch
+ * @return UDP_BATCH_T pointer with the batch
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+UDP_BATCH_T* create_udp_batch(int size){
+	UDP_BATCH_T* batch = NULL;
+	int a;
+
+	if((batch=malloc(sizeof(UDP_BATCH_T)))==NULL || (batch->requests=calloc(size, sizeof(struct mmsghdr)))==NULL || (batch->responses=calloc(size, sizeof(struct mmsghdr)))==NULL || (batch->request_iovecs=calloc(size, sizeof(struct iovec)))==NULL || (batch->addresses=calloc(size, sizeof(struct sockaddr_in)))==NULL || (batch->request_data=malloc(size*UDP_REQUEST_SIZE))==NULL || (batch->control_data=malloc(size*UDP_CONTROL_SIZE))==NULL || (batch->response_iovecs=calloc(size, sizeof(struct iovec)))==NULL || (batch->response_data=malloc(size*UDP_RESPONSE_SIZE))==NULL || (batch->receipts=calloc(size, sizeof(unsigned long long)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the batch of %d requests\n", size);
+	}
+	batch->size = size;
+	for(a=0; a<size; a++){
+		batch->request_iovecs[a].iov_base = batch->request_data+a*UDP_REQUEST_SIZE;
+		batch->request_iovecs[a].iov_len = UDP_REQUEST_SIZE;
+		batch->requests[a].msg_hdr.msg_name = &(batch->addresses[a]);
+		batch->requests[a].msg_hdr.msg_iov = &(batch->request_iovecs[a]);
+		batch->requests[a].msg_hdr.msg_iovlen = 1;
+		batch->requests[a].msg_hdr.msg_control = batch->control_data+a*UDP_CONTROL_SIZE;
+		// Each response goes to the address of its request
+		batch->response_iovecs[a].iov_base = batch->response_data+a*UDP_RESPONSE_SIZE;
+		batch->responses[a].msg_hdr.msg_name = &(batch->addresses[a]);
+		batch->responses[a].msg_hdr.msg_iov = &(batch->response_iovecs[a]);
+		batch->responses[a].msg_hdr.msg_iovlen = 1;
+	}
+	return batch;
+}
+
+/**
+ * @brief Free the buffers of a batch of requests
+ * @param batch UDP_BATCH_T to free
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void free_udp_batch(UDP_BATCH_T* batch){
+	if(batch!=NULL){
+		free(batch->receipts);
+		free(batch->response_data);
+		free(batch->response_iovecs);
+		free(batch->control_data);
+		free(batch->request_data);
+		free(batch->addresses);
+		free(batch->request_iovecs);
+		free(batch->responses);
+		free(batch->requests);
+		free(batch);
+	}
+}
+
+/**
+ * @brief Wait for the client requests and send back to each one a time of day string
+ * @param worker UDP_WORKER_T of the thread, with the server socket reference and the buffers of the batch
+ * @return integer with the number of requests answered
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+int serve_udp_batch(UDP_WORKER_T* worker){
+	UDP_BATCH_T* batch = worker->batch;
+	unsigned long long sent, now;
+	int count, result, a;
+
+	for(a=0; a<batch->size; a++){
+		batch->requests[a].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+		batch->requests[a].msg_hdr.msg_controllen = UDP_CONTROL_SIZE;
+	}
+	// Wait for the first request, and take the others already waiting without blocking
+	if((count = recvmmsg(worker->sock_fd, batch->requests, batch->size, MSG_WAITFORONE, NULL))==-1){
+		ERROR(M_RECVFROM_ERROR, "\nError occurred while receiving the requests from the clients.\n");
+	}
+	// Get the time of the day (a single one for the batch, all the responses leave at the same time)
+	sent = udp_now();
+	now = udp_clock_time(worker->clock, sent);
+	for(a=0; a<count; a++){
+		batch->receipts[a] = udp_receipt_time(&(batch->requests[a].msg_hdr), sent);
+		batch->response_iovecs[a].iov_len = udp_time_response(batch->request_data+a*UDP_REQUEST_SIZE, batch->requests[a].msg_len, now-(sent-batch->receipts[a]), now, worker->clock, batch->response_data+a*UDP_RESPONSE_SIZE);
+		batch->responses[a].msg_hdr.msg_namelen = batch->requests[a].msg_hdr.msg_namelen;
+	}
+
+	// The kernel can send only a part of the batch on each call
+	for(a=0; a<count; a+=result){
+		if((result = sendmmsg(worker->sock_fd, batch->responses+a, count-a, 0))==-1){
+			ERROR(M_SENDTO_ERROR, "\nError while sending the responses to the clients\n");
+		}
+	}
+
+	// Only after the responses: the latencies and the log
+	for(a=0; a<count; a++){
+		udp_record_request(worker, &(batch->addresses[a]), sent-batch->receipts[a], now/1000);
+	}
+
+	return count;
+}
+
+/**
+ * @brief Start a new window (second) of the rate of the log, if the previous one ended
+ * @param logger UDP_LOGGER_T with the maximum rate
+ * @param second of the current window (updated)
+ * @param logged number of requests logged on the window (updated)
+ * @param suppressed number of requests not logged on the window (updated, written at the end of the window)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+static void udp_log_window(UDP_LOGGER_T* logger, time_t* second, long* logged, long* suppressed){
+	time_t now = time(NULL);
+
+	if(now!=*second){
+		if(*suppressed>0){
+			printf("%ld requests not logged (more than %d each second).\n", *suppressed, logger->rate);
+		}
+		*second = now;
+		*logged = *suppressed = 0;
+	}
+}
+
+/**
+ * @brief Thread of the log, writing the requests of the rings of the server threads
+ * @param arg UDP_LOGGER_T with the data of the thread
+ * @return NULL (never returns)
+ *
+ * @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+ */
+void *udp_log_serve(void *arg){
+	UDP_LOGGER_T *logger = (UDP_LOGGER_T*) arg;
+	UDP_LOG_ENTRY_T entry;
+	struct timespec interval = {0, UDP_LOG_INTERVAL*1000000L};
+	char ip[INET_ADDRSTRLEN];			// To store the IP address of the client
+	time_t second = time(NULL);
+	long logged = 0, suppressed = 0;
+	int a, taken;
+
+	while (1) {
+		taken = FALSE;
+		for(a=0; a<logger->threads; a++){
+			while(udp_log_pop(logger->workers[a].log_ring, &entry)==TRUE){
+				taken = TRUE;
+				// The requests over the rate of each second are only counted
+				udp_log_window(logger, &second, &logged, &suppressed);
+				if(logger->rate>0 && logged>=logger->rate){
+					suppressed++;
+					continue;
+				}
+				logged++;
+				// Convert the client address to a valid string
+				inet_ntop(AF_INET, &(entry.address), ip, sizeof(ip));
+				printf("Client %s@%d request. Sending: %llu (answered in %.1f us).\n", ip, ntohs(entry.port), entry.timestamp, entry.service_time/1000.0);
+			}
+		}
+		if(taken==FALSE){
+			udp_log_window(logger, &second, &logged, &suppressed);
+			fflush(stdout);
+			nanosleep(&interval, NULL);
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,80 @@
+/**
+* @file udptimelib.h
+* @brief Header file for the requests of the UdpTime (batched, on one or more threads with their own sockets)
+* @date 2010/02/10 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#ifndef UDPTIMELIB_H_
+#define UDPTIMELIB_H_
+
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "udploglib.h"
+
+/**
+ * @brief Number of bytes of the ancillary data of a request (with the receipt time)
+ */
+#define UDP_CONTROL_SIZE CMSG_SPACE(sizeof(struct timespec))
+
+/**
+ * @brief Type declaration to a structure to store the buffers of a batch of requests (allocated once, reused on each batch)
+ */
+typedef struct udp_batch {
+	int size;									/**< @brief maximum number of requests of a batch */
+	struct mmsghdr* requests;					/**< @brief headers of the received requests */
+	struct mmsghdr* responses;					/**< @brief headers of the responses */
+	struct iovec* request_iovecs;				/**< @brief buffer of each request */
+	struct sockaddr_in* addresses;				/**< @brief address of the client of each request */
+	char* request_data;							/**< @brief bytes of the requests (UDP_REQUEST_SIZE for each one) */
+	char* control_data;							/**< @brief ancillary data of the requests, with the receipt time (UDP_CONTROL_SIZE for each one) */
+	struct iovec* response_iovecs;				/**< @brief buffer of each response */
+	char* response_data;						/**< @brief bytes of the responses (UDP_RESPONSE_SIZE for each one) */
+	unsigned long long* receipts;				/**< @brief time (ns) each request was received */
+} UDP_BATCH_T;
+
+/**
+ * @brief Type declaration to a structure to store the data of a server thread (each one with its own socket on the port)
+ *
+ * Aligned to the cache lines, so the counters of a thread don't share a line with the ones of another
+ */
+typedef struct udp_worker {
+	int index;									/**< @brief number of the thread */
+	int sock_fd;								/**< @brief socket of the thread (SO_REUSEPORT with the others) */
+	int batch_size;								/**< @brief maximum number of requests answered at once (1 to answer each on its own) */
+	int cpu;									/**< @brief CPU to run the thread (-1 for any) */
+	int clock;									/**< @brief clock of the times sent (UDP_TIME_CLOCK_*) */
+	pthread_t thread;							/**< @brief the thread */
+	long long requests;							/**< @brief number of requests answered (only changed by the thread) */
+	long long batches;							/**< @brief number of batches (only changed by the thread) */
+	int largest_batch;							/**< @brief largest number of requests of a batch (only changed by the thread) */
+	UDP_BATCH_T *batch;							/**< @brief buffers of the batched requests (NULL to answer each on its own) */
+	int log_sample;								/**< @brief one of each log_sample requests is logged (0 for none) */
+	unsigned long log_counter;					/**< @brief number of requests since the last one logged */
+	UDP_LOG_RING_T *log_ring;					/**< @brief requests to log, taken by the log thread */
+	UDP_LATENCY_T latency;						/**< @brief time from the receipt of each request to the send of its response (only changed by the thread) */
+} __attribute__((aligned(64))) UDP_WORKER_T;
+
+/**
+ * @brief Type declaration to a structure to store the data of the log thread
+ */
+typedef struct udp_logger {
+	UDP_WORKER_T *workers;						/**< @brief the server threads, with the rings to log */
+	int threads;								/**< @brief number of server threads */
+	int rate;									/**< @brief maximum number of requests logged each second (0 for no limit) */
+	pthread_t thread;							/**< @brief the thread */
+} UDP_LOGGER_T;
+
+int wait_for_request(UDP_WORKER_T*);
+int create_udp_socket(long, int);
+void *udp_serve(void *);
+void print_udp_workers(UDP_WORKER_T*, int);
+UDP_BATCH_T* create_udp_batch(int);
+void free_udp_batch(UDP_BATCH_T*);
+int serve_udp_batch(UDP_WORKER_T*);
+void *udp_log_serve(void *);
+
+#endif /* UDPTIMELIB_H_ */
@@ -20,11 +20,15 @@
 #include <arpa/inet.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
 
 #include "3rd/debug.h"
 
 #include "includes/definitions.h"
 #include "includes/aux.h"
+#include "includes/udptimelib.h"
 #include "main.h"
 
 /**
@@ -33,96 +37,171 @@
  * @param argv *char[] with the command line options
  * @return integer 0 on a successfully exit, another integer value otherwise
  *
+ * Use: UdpTime [--threads <number of threads>] [--pin] [--log-sample <n>] [--log-rate <lines per second>] [--clock realtime|monotonic|monotonic-raw] <port to listen> [requests per batch]
+ *
  * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
  */
 int main(int argc, char *argv[]){
 	long port=1234;							// to store the port number to serve the requests
+	long batch_size=UDP_BATCH_SIZE;			// to store the maximum number of requests answered at once
+	long threads=1;							// to store the number of threads, each with its own socket
+	int pin=FALSE;							// to store if each thread runs only on its own CPU
+	long log_sample=1;						// to store the sample of the requests logged (one of each log_sample, 0 for none)
+	long log_rate=UDP_LOG_RATE;				// to store the maximum number of requests logged each second (0 for no limit)
+	int clock=UDP_TIME_CLOCK_REALTIME;		// to store the clock of the times sent to the clients
+	UDP_LOGGER_T logger;					// to store the data of the log thread
 	char *endptr;							// to store the invalid characters from the conversion of the parameter given
-	int sock_fd;							// to store the an application socket
-	struct sockaddr_in ser_addr;			// to store the sockaddr_in structure
+	UDP_WORKER_T *workers;					// to store the data of the threads
+	sigset_t signals;						// to store the signals handled by the main thread
+	char **arguments;						// to store the positional arguments
+	int number_of_arguments;				// to store the number of positional arguments
+	int signal_number, option, a;
+	struct option long_options[] = {
+		{"threads", required_argument, NULL, 't'},
+		{"pin", no_argument, NULL, 'p'},
+		{"log-sample", required_argument, NULL, 's'},
+		{"log-rate", required_argument, NULL, 'r'},
+		{"clock", required_argument, NULL, 'c'},
+		{0, 0, 0, 0}
+	};
 
 	system("clear");
-	if(argc!=2){
+	while((option = getopt_long(argc, argv, "t:ps:r:c:", long_options, NULL))!=-1){
+		switch(option){
+			case 't':
+				threads = strtol(optarg, &endptr, 0);
+				if(endptr==optarg || *endptr!='\0' || threads<1 || threads>UDP_MAXIMUM_THREADS){
+					MY_DEBUG("\nINVALID_PARAMETERS\n");
+					printf("The number of threads '%s' is not valid, it must be a number between 1 and %d\n", optarg, UDP_MAXIMUM_THREADS);
+					exit(M_INVALID_PARAMETERS);
+				}
+				break;
+			case 'p':
+				pin = TRUE;
+				break;
+			case 's':
+				log_sample = strtol(optarg, &endptr, 0);
+				if(endptr==optarg || *endptr!='\0' || log_sample<0 || log_sample>INT_MAX){
+					MY_DEBUG("\nINVALID_PARAMETERS\n");
+					printf("The log sample '%s' is not valid, it must be a positive number (one of each <n> requests is logged) or 0 to log none\n", optarg);
+					exit(M_INVALID_PARAMETERS);
+				}
+				break;
+			case 'r':
+				log_rate = strtol(optarg, &endptr, 0);
+				if(endptr==optarg || *endptr!='\0' || log_rate<0 || log_rate>INT_MAX){
+					MY_DEBUG("\nINVALID_PARAMETERS\n");
+					printf("The log rate '%s' is not valid, it must be a positive number of lines per second or 0 for no limit\n", optarg);
+					exit(M_INVALID_PARAMETERS);
+				}
+				break;
+			case 'c':
+				if(strcmp(optarg, "realtime")==0){
+					clock = UDP_TIME_CLOCK_REALTIME;
+				}else if(strcmp(optarg, "monotonic")==0){
+					clock = UDP_TIME_CLOCK_MONOTONIC;
+				}else if(strcmp(optarg, "monotonic-raw")==0){
+					clock = UDP_TIME_CLOCK_MONOTONIC_RAW;
+				}else{
+					MY_DEBUG("\nINVALID_PARAMETERS\n");
+					printf("The clock '%s' is not valid, it must be realtime, monotonic or monotonic-raw\n", optarg);
+					exit(M_INVALID_PARAMETERS);
+				}
+				break;
+			default:
+				MY_DEBUG("\nINVALID_PARAMETERS\n");
+				printf("Use: %s [--threads <number of threads>] [--pin] [--log-sample <n>] [--log-rate <lines per second>] [--clock realtime|monotonic|monotonic-raw] <port to listen> [requests per batch]\n", argv[0]);
+				exit(M_INVALID_PARAMETERS);
+		}
+	}
+	// The positional arguments (getopt moves them to the end)
+	arguments = argv+optind;
+	number_of_arguments = argc-optind;
+
+	if(number_of_arguments<1 || number_of_arguments>2){
 		MY_DEBUG("\nINVALID_PARAMETERS\n");
-		printf("The arguments specified are not valid.\nUse: %s <port to listen>\n",argv[0]);
+		printf("The arguments specified are not valid.\nUse: %s [--threads <number of threads>] [--pin] [--log-sample <n>] [--log-rate <lines per second>] [--clock realtime|monotonic|monotonic-raw] <port to listen> [requests per batch]\n",argv[0]);
 		exit(M_INVALID_PARAMETERS);
 	}
 
 	errno = 0;
 	// Convert the given parameter to a long value
-	port = strtol(argv[1], &endptr, 0);
+	port = strtol(arguments[0], &endptr, 0);
 	/* Verify for errors */
 	if ((errno == ERANGE && (port >= LONG_MAX || port <= LONG_MIN)) || (errno != 0 && port == 0)) {
 		MY_DEBUG("\nNUMBER_CONVERSION_ERROR\n");
-		printf("Unable to convert the parameter '%s' to a valid port number.\nUse: %s <port to listen>\n", argv[1], argv[0]);
+		printf("Unable to convert the parameter '%s' to a valid port number.\nUse: %s [--threads <number of threads>] [--pin] [--log-sample <n>] [--log-rate <lines per second>] [--clock realtime|monotonic|monotonic-raw] <port to listen> [requests per batch]\n", arguments[0], argv[0]);
 		exit(M_NUMBER_CONVERSION_ERROR);
 	}
-	if (endptr == argv[1]) {
+	if (endptr == arguments[0]) {
 		MY_DEBUG("\nNO_DIGITS_FOUND\n");
-		printf("No digits found in the parameter '%s'.\nUse: %s <port to listen>\n", argv[1], argv[0]);
+		printf("No digits found in the parameter '%s'.\nUse: %s [--threads <number of threads>] [--pin] [--log-sample <n>] [--log-rate <lines per second>] [--clock realtime|monotonic|monotonic-raw] <port to listen> [requests per batch]\n", arguments[0], argv[0]);
 		exit(M_NO_DIGITS_FOUND);
 	}
 	if(port<PORT_RANGE_MIN || port>PORT_RANGE_MAX){
 		MY_DEBUG("\nPORT_OUT_OF_RANGE\n");
-		printf("The port %ld is out of the allowed range port numbers. \nUse: %s <port to listen>, were <port to listen> is a number between %d and %d\n", port, argv[0], PORT_RANGE_MIN, PORT_RANGE_MAX);
+		printf("The port %ld is out of the allowed range port numbers. \nUse: %s [--threads <number of threads>] [--pin] [--log-sample <n>] [--log-rate <lines per second>] [--clock realtime|monotonic|monotonic-raw] <port to listen> [requests per batch], were <port to listen> is a number between %d and %d\n", port, argv[0], PORT_RANGE_MIN, PORT_RANGE_MAX);
 		exit(M_PORT_OUT_OF_RANGE);
 	}
-
-
-	/* Creates the socket */
-	if ((sock_fd = socket(AF_INET, SOCK_DGRAM, 0)) == -1){
-		ERROR(M_SOCKET_CREATION_ERROR, "\nError while creating the application socket.\n");
+	if(number_of_arguments==2){
+		batch_size = strtol(arguments[1], &endptr, 0);
+		if(endptr==arguments[1] || *endptr!='\0' || batch_size<1 || batch_size>UDP_MAXIMUM_BATCH_SIZE){
+			MY_DEBUG("\nINVALID_PARAMETERS\n");
+			printf("The number of requests per batch '%s' is not valid.\nUse: %s [--threads <number of threads>] [--pin] [--log-sample <n>] [--log-rate <lines per second>] [--clock realtime|monotonic|monotonic-raw] <port to listen> [requests per batch], were [requests per batch] is a number between 1 and %d (1 to answer each request on its own)\n", arguments[1], argv[0], UDP_MAXIMUM_BATCH_SIZE);
+			exit(M_INVALID_PARAMETERS);
+		}
 	}
 
-	/* Initializes the sockaddr_in structure with the socket information */
-	memset(&ser_addr, 0, sizeof(ser_addr));
-	ser_addr.sin_family = AF_INET;
-	ser_addr.sin_addr.s_addr = htonl(INADDR_ANY);
-	ser_addr.sin_port = htons(port);
+	// Block the signals on all the threads, the main one waits for them
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	sigaddset(&signals, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
 
-	/* Register the socket */
-	if (bind(sock_fd, (struct sockaddr *)&ser_addr, sizeof(ser_addr)) == -1){
-		ERROR(M_BIND_SOCKET_ERROR, "\nError binding the socket.\n");
+	if((workers = aligned_calloc(threads, sizeof(UDP_WORKER_T), __alignof__(UDP_WORKER_T)))==NULL){
+		ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the data of the threads\n");
 	}
-
-	printf("%s ready and listening at port %ld\n", argv[0], port);
-	while (1) {
-		/* Wait for an request */
-		wait_for_request(sock_fd);
+	// All the sockets are bound before the threads start, so the kernel spreads the clients by all of them
+	for(a=0; a<threads; a++){
+		workers[a].index = a;
+		workers[a].sock_fd = create_udp_socket(port, (threads>1)?TRUE:FALSE);
+		workers[a].batch_size = batch_size;
+		workers[a].cpu = (pin==TRUE)?a%sysconf(_SC_NPROCESSORS_ONLN):-1;
+		workers[a].clock = clock;
+		workers[a].log_sample = log_sample;
+		if(log_sample>0 && (workers[a].log_ring = calloc(1, sizeof(UDP_LOG_RING_T)))==NULL){
+			ERROR(M_FAILED_MEMORY_ALLOCATION, "\nMemory allocation failed for the log of the thread %d\n", a);
+		}
 	}
-	//close(sock_fd);
-		
-	return 0;
-}
-
-/**
- * @brief Wait for a client request and send back a time of day string
- * @param sock_fd integer with the server socket reference
- *
- * @author Cláudio Esperança <2070030@student.estg.ipleiria.pt>, Diogo Serra <2081008@student.estg.ipleiria.pt>
- */
-void wait_for_request(int sock_fd){
-	struct sockaddr_in cli_addr;		// To store the socket of the client
-	socklen_t cli_length;				// To store the size of the socket structure of the client
-	char ip[20];						// To store the IP address of the client
-	struct timeval timestamp;			// To store the time value
-	char response[255];					// To store the response to send to the client
 
+	printf("%s ready and listening at port %ld (%ld threads, up to %ld requests per batch)\n", argv[0], port, threads, batch_size);
+	// The log is written only by the log thread, flushed when it has nothing more to write
+	fflush(stdout);
+	setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+	if(log_sample>0){
+		logger.workers = workers;
+		logger.threads = threads;
+		logger.rate = log_rate;
+		if(pthread_create(&(logger.thread), NULL, udp_log_serve, &logger)!=0){
+			ERROR(M_PTHREAD_CREATE_FAILED, "\nError while creating the log thread\n");
+		}
+	}
+	for(a=0; a<threads; a++){
+		if(pthread_create(&(workers[a].thread), NULL, udp_serve, &(workers[a]))!=0){
+			ERROR(M_PTHREAD_CREATE_FAILED, "\nError while creating the thread %d\n", a);
+		}
+	}
 
-    cli_length=sizeof(cli_addr);
-    // Receive the request from the client
-    if (recvfrom(sock_fd, NULL, 0, 0, (struct sockaddr *) &cli_addr, &cli_length) == -1){
-    	ERROR(M_RECVFROM_ERROR, "\nError occurred while receiving the request from the client.\n");
-    }
-    // Get the time of the day
-    gettimeofday(&timestamp, NULL);
-    // Store the time of the day in the response
-	sprintf(response, "%llu", timestamp.tv_sec*1000000ULL+timestamp.tv_usec);
-	// Convert the client address to a valid string
-	inet_ntop (AF_INET, &cli_addr.sin_addr, ip, sizeof (ip));
-    printf("Client %s@%d request. Sending: %s.\n", ip , htons (cli_addr.sin_port), response);
+	// Print the counters of the threads on SIGUSR1 and on the exit (SIGINT or SIGTERM)
+	do{
+		if(sigwait(&signals, &signal_number)!=0){
+			continue;
+		}
+		print_udp_workers(workers, threads);
+	}while(signal_number==SIGUSR1);
 
-    if (sendto(sock_fd, response, strlen(response), 0, (struct sockaddr *) &cli_addr, cli_length) < 0){
-    	ERROR(M_SENDTO_ERROR, "\nError while sending the response to the client\n");
-    }
+	// The threads are blocked on the sockets, so they end with the process
+	return 0;
 }
+
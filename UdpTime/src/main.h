@@ -1,7 +1,4 @@
 #ifndef __MAIN_H
 #define __MAIN_H
 
-void wait_for_request(int);
-
 #endif
-
@@ -0,0 +1,531 @@
+/**
+* @file udp_load.c
+* @brief Load test tool for the UdpTime server and the results server
+*
+* Usage: udp_load <ip> <port> [clients] [seconds] [threads] [text|binary|results|batch] [requests per second]
+*
+* Simulates the given number of clients (each with its own socket and one request waiting for the response at a time,
+* like the Sorter), spread by the threads, during the given time, and reports the throughput, the loss and the latency
+* percentiles and histogram. A request without a response after UDP_LOAD_TIMEOUT ms is counted as lost and sent again.
+* With the binary protocol, a response with the nonce of an older request is counted as mismatched and ignored.
+*
+* The text and binary protocols are the ones of the UdpTime; results sends a result on its own on each request and
+* batch sends UDP_LOAD_BATCH_RESULTS results on each one (the Sorter's protocols with the results server), counting
+* the results refused by the server. A response to a batch with the number of an older one is counted as mismatched.
+*
+* Without a rate (or with 0), each client sends its next request as soon as the response arrives; with a rate, the
+* requests of all the clients are spread evenly on time, and a request sent over 1 ms after its time (its client was
+* still waiting for a response) is counted as delayed, a sign that more clients are needed for that rate.
+*
+* @date 2010/02/10 File creation
+* @author Cláudio Esperança <cesperanc@gmail.com>, Diogo Serra <2081008@student.estg.ipleiria.pt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <endian.h>
+
+#include "../src/includes/definitions.h"
+#include "../src/includes/udploglib.h"
+
+/**
+ * @brief Default number of clients
+ */
+#define UDP_LOAD_CLIENTS 64
+
+/**
+ * @brief Default duration of the test (s)
+ */
+#define UDP_LOAD_SECONDS 5
+
+/**
+ * @brief Default number of threads
+ */
+#define UDP_LOAD_THREADS 4
+
+/**
+ * @brief Time (ms) without a response after which a request is lost
+ */
+#define UDP_LOAD_TIMEOUT 200
+
+/**
+ * @brief Maximum number of events of each epoll_wait
+ */
+#define UDP_LOAD_EVENTS 256
+
+/**
+ * @brief Number of results of each request of the batch protocol
+ */
+#define UDP_LOAD_BATCH_RESULTS 16
+
+/**
+ * @brief Protocols of the load test
+ */
+enum load_protocol {
+	LOAD_TEXT,								/**< @brief time server, empty request and time as text */
+	LOAD_BINARY,							/**< @brief time server, binary request and response with a nonce */
+	LOAD_RESULTS,							/**< @brief results server, a result on its own */
+	LOAD_BATCH								/**< @brief results server, a batch of results */
+};
+
+/**
+ * @brief Names of the protocols, on the order of the load_protocol values
+ */
+static const char* protocols[] = {"text", "binary", "results", "batch"};
+
+/**
+ * @brief To store the state of a simulated client
+ */
+typedef struct load_client {
+	int fd;									/**< @brief socket of the client (connected to the server) */
+	int index;								/**< @brief number of the client (on all the threads) */
+	int waiting;							/**< @brief TRUE while a request waits for its response */
+	double sent;							/**< @brief time (us) the request waiting for the response was sent */
+	double next;							/**< @brief time (us) to send the next request (with a rate) */
+	uint64_t nonce;							/**< @brief number of the last request (nonce of the binary protocol, number of the batch) */
+} LOAD_CLIENT_T;
+
+/**
+ * @brief To store the data and the results of a thread of the load test
+ */
+typedef struct load_thread {
+	pthread_t thread;						/**< @brief the thread */
+	struct sockaddr_in* server;				/**< @brief address of the server */
+	int first;								/**< @brief number of the first client of the thread */
+	int clients;							/**< @brief number of clients of the thread */
+	int protocol;							/**< @brief load_protocol of the requests */
+	double start;							/**< @brief time (us) of the start */
+	double end;								/**< @brief time (us) to stop */
+	double interval;						/**< @brief time (us) between the requests of each client (0 without a rate) */
+	UDP_LATENCY_T latency;					/**< @brief latencies (ns) of the answered requests */
+	long sent;								/**< @brief number of requests sent (with the ones sent again) */
+	long completed;							/**< @brief number of answered requests */
+	long lost;								/**< @brief number of requests without a response */
+	long invalid;							/**< @brief number of responses not understood */
+	long mismatched;						/**< @brief number of responses to an older request */
+	long refused;							/**< @brief number of results refused by the results server */
+	long delayed;							/**< @brief number of requests sent over 1 ms after their time (with a rate) */
+	int failed;								/**< @brief TRUE if the thread couldn't start its clients */
+} LOAD_THREAD_T;
+
+/**
+ * @brief Get the current time of the monotonic clock
+ * @return double with the time in microseconds
+ */
+static double now_us(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec*1000000.0+now.tv_nsec/1000.0;
+}
+
+/**
+ * @brief Write a result of a client, like the ones of the Sorter (any md5 sum is accepted by a results server without
+ * the sorted files; with them, the results are refused by the file, but answered the same way)
+ * @param buffer to store the result
+ * @param size of the buffer
+ * @param client LOAD_CLIENT_T of the result
+ * @param number of the result of the request
+ * @return integer with the number of bytes written
+ */
+static int write_result(char* buffer, int size, LOAD_CLIENT_T* client, int number){
+	return snprintf(buffer, size, "load%d,udp_load,f%03d.txt,%016llx%016llx,quick,%d", client->index, (int)((client->nonce+number)%1000), (unsigned long long)client->index, (unsigned long long)client->nonce, number);
+}
+
+/**
+ * @brief Send the request of a client
+ * @param data LOAD_THREAD_T with the protocol and the counters
+ * @param client LOAD_CLIENT_T to send the request
+ */
+static void send_request(LOAD_THREAD_T* data, LOAD_CLIENT_T* client){
+	char request[RESULTS_BATCH_SIZE];
+	uint16_t magic = htons(UDP_TIME_MAGIC);
+	uint64_t nonce;
+	int length = 0, a;
+
+	client->nonce++;
+	switch(data->protocol){
+		case LOAD_BINARY:
+			memset(request, 0, UDP_TIME_REQUEST_SIZE);
+			memcpy(request, &magic, sizeof(magic));
+			request[2] = UDP_TIME_VERSION;
+			nonce = htobe64(client->nonce);
+			memcpy(request+8, &nonce, sizeof(nonce));
+			length = UDP_TIME_REQUEST_SIZE;
+			break;
+		case LOAD_RESULTS:
+			length = write_result(request, sizeof(request), client, 0);
+			break;
+		case LOAD_BATCH:
+			length = sprintf(request, "%s %llu\n", RESULTS_BATCH_HEADER, (unsigned long long)client->nonce);
+			for(a=0; a<UDP_LOAD_BATCH_RESULTS; a++){
+				length += write_result(request+length, sizeof(request)-length, client, a);
+				request[length++] = '\n';
+			}
+			break;
+	}
+	client->sent = now_us();
+	client->waiting = TRUE;
+	data->sent++;
+	// A failed send is handled like a lost request
+	send(client->fd, request, length, 0);
+}
+
+/**
+ * @brief Verify a response of the binary protocol
+ * @param client LOAD_CLIENT_T which received the response
+ * @param response bytes of the response
+ * @param length number of bytes of the response
+ * @return integer 1 if valid, 0 if invalid, -1 if the response is to another request
+ */
+static int check_binary_response(LOAD_CLIENT_T* client, char* response, ssize_t length){
+	uint16_t magic;
+	uint64_t nonce, transmit;
+
+	if(length!=UDP_TIME_RESPONSE_SIZE){
+		return 0;
+	}
+	memcpy(&magic, response, sizeof(magic));
+	memcpy(&nonce, response+8, sizeof(nonce));
+	memcpy(&transmit, response+24, sizeof(transmit));
+	if(ntohs(magic)!=UDP_TIME_MAGIC || (unsigned char)response[2]!=UDP_TIME_VERSION || transmit==0){
+		return 0;
+	}
+	return (be64toh(nonce)==client->nonce)?1:-1;
+}
+
+/**
+ * @brief Verify the code of a result
+ * @param data LOAD_THREAD_T with the counter of the refused results
+ * @param code of the result
+ * @return integer 1 if it is a code of the results server, 0 otherwise
+ */
+static int check_result_code(LOAD_THREAD_T* data, char* code){
+	if(strcmp(code, RESULTS_SERVER_OK)==0){
+		return 1;
+	}
+	if(strncmp(code, "-ERR", 4)==0){
+		data->refused++;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Verify a response of the batch protocol
+ * @param data LOAD_THREAD_T with the counter of the refused results
+ * @param client LOAD_CLIENT_T which received the response
+ * @param response of the results server (terminated)
+ * @return integer 1 if valid, 0 if invalid, -1 if the response is to another batch
+ */
+static int check_batch_response(LOAD_THREAD_T* data, LOAD_CLIENT_T* client, char* response){
+	char *line, *next, *endptr;
+	int header_length = strlen(RESULTS_BATCH_HEADER), a;
+
+	if(strncmp(response, RESULTS_BATCH_HEADER, header_length)!=0 || response[header_length]!=' '){
+		return 0;
+	}
+	if(strtoull(response+header_length+1, &endptr, 10)!=client->nonce){
+		return -1;
+	}
+	if(*endptr!='\n'){
+		return 0;
+	}
+	line = endptr+1;
+	for(a=0; a<UDP_LOAD_BATCH_RESULTS; a++){
+		if((next = strchr(line, '\n'))==NULL){
+			return 0;
+		}
+		*next = '\0';
+		if(check_result_code(data, line)==0){
+			return 0;
+		}
+		line = next+1;
+	}
+	return (a==UDP_LOAD_BATCH_RESULTS)?1:0;
+}
+
+/**
+ * @brief Verify a response
+ * @param data LOAD_THREAD_T with the protocol and the counters
+ * @param client LOAD_CLIENT_T which received the response
+ * @param response bytes of the response (with space for a terminator after them)
+ * @param length number of bytes of the response
+ * @return integer 1 if valid, 0 if invalid, -1 if the response is to another request
+ */
+static int check_response(LOAD_THREAD_T* data, LOAD_CLIENT_T* client, char* response, ssize_t length){
+	char* endptr;
+
+	if(data->protocol==LOAD_BINARY){
+		return check_binary_response(client, response, length);
+	}
+	response[length] = '\0';
+	switch(data->protocol){
+		case LOAD_RESULTS:
+			return check_result_code(data, response);
+		case LOAD_BATCH:
+			return check_batch_response(data, client, response);
+	}
+	return (length>0 && strtoull(response, &endptr, 10)!=0 && *endptr=='\0')?1:0;
+}
+
+/**
+ * @brief Send the next request of a client: at once without a rate, or at its time with one
+ * @param data LOAD_THREAD_T with the rate and the counters
+ * @param client LOAD_CLIENT_T to send the request
+ * @param now current time (us)
+ */
+static void next_request(LOAD_THREAD_T* data, LOAD_CLIENT_T* client, double now){
+	if(data->interval==0){
+		send_request(data, client);
+		return;
+	}
+	if(client->waiting==TRUE || now<client->next){
+		return;
+	}
+	if(now-client->next>1000){
+		data->delayed++;
+	}
+	send_request(data, client);
+	// The times of the requests don't move with the delays, so the rate is kept when the responses are faster again
+	client->next += data->interval;
+	if(client->next<now-data->interval*4){
+		client->next = now;
+	}
+}
+
+/**
+ * @brief Thread with the clients of the load test
+ * @param arg LOAD_THREAD_T with the data of the thread
+ * @return NULL
+ */
+static void* load_thread(void* arg){
+	LOAD_THREAD_T* data = (LOAD_THREAD_T*) arg;
+	LOAD_CLIENT_T *clients, *client;
+	struct epoll_event events[UDP_LOAD_EVENTS], event;
+	char response[MAXCHARS+1];
+	double now, last_check;
+	int epollfd, number_of_events, valid, a;
+	ssize_t received;
+
+	if((clients = calloc(data->clients, sizeof(LOAD_CLIENT_T)))==NULL || (epollfd = epoll_create1(0))==-1){
+		data->failed = TRUE;
+		return NULL;
+	}
+	for(a=0; a<data->clients; a++){
+		if((clients[a].fd = socket(AF_INET, SOCK_DGRAM, 0))==-1 || connect(clients[a].fd, (struct sockaddr*) data->server, sizeof(*(data->server)))==-1){
+			fprintf(stderr, "Failed to create the client %d (%s)\n", data->first+a, strerror(errno));
+			data->failed = TRUE;
+			return NULL;
+		}
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.ptr = &(clients[a]);
+		epoll_ctl(epollfd, EPOLL_CTL_ADD, clients[a].fd, &event);
+		clients[a].index = data->first+a;
+		// The numbers of the requests start on a value of this run and client, so the responses to an older run (or the
+		// batches of other clients behind the same address) aren't taken
+		clients[a].nonce = ((uint64_t)getpid()<<48)^((uint64_t)clients[a].index<<32)^((uint64_t)data->start&0xffffffffULL);
+	}
+	// The first requests of the clients are spread by the first interval, after all the sockets are created
+	now = now_us();
+	for(a=0; a<data->clients; a++){
+		clients[a].next = now+data->interval*a/data->clients;
+		next_request(data, &(clients[a]), now);
+	}
+
+	last_check = now_us();
+	while((now = now_us())<data->end){
+		if((number_of_events = epoll_wait(epollfd, events, UDP_LOAD_EVENTS, (data->interval>0)?1:10))==-1){
+			if(errno==EINTR){
+				continue;
+			}
+			break;
+		}
+		for(a=0; a<number_of_events; a++){
+			client = (LOAD_CLIENT_T*) events[a].data.ptr;
+			if((received = recv(client->fd, response, MAXCHARS, MSG_DONTWAIT))<0){
+				// An error from the server (e.g. not listening) makes the request lost, sent again after the timeout
+				continue;
+			}
+			now = now_us();
+			if(client->waiting==FALSE || (valid = check_response(data, client, response, received))<0){
+				// A late response, the client still waits for the one of its request (or for its time)
+				data->mismatched++;
+				continue;
+			}
+			if(valid==0){
+				data->invalid++;
+			}else{
+				data->completed++;
+				udp_latency_add(&(data->latency), (unsigned long long)((now-client->sent)*1000));
+			}
+			client->waiting = FALSE;
+			next_request(data, client, now);
+		}
+		// The requests without a response are sent again, and the ones of the clients on time are sent
+		if(data->interval>0 || now-last_check>=UDP_LOAD_TIMEOUT*1000.0/4){
+			last_check = now;
+			for(a=0; a<data->clients; a++){
+				if(clients[a].waiting==TRUE && now-clients[a].sent>=UDP_LOAD_TIMEOUT*1000.0){
+					data->lost++;
+					clients[a].waiting = FALSE;
+				}
+				if(clients[a].waiting==FALSE){
+					next_request(data, &(clients[a]), now);
+				}
+			}
+		}
+	}
+
+	for(a=0; a<data->clients; a++){
+		close(clients[a].fd);
+	}
+	close(epollfd);
+	free(clients);
+	return NULL;
+}
+
+/**
+ * @brief Print the histogram of the latencies, by power of 2 of nanoseconds (with the share and the cumulative share
+ * of each range)
+ * @param latency UDP_LATENCY_T with the latencies (ns)
+ */
+static void print_histogram(UDP_LATENCY_T* latency){
+	unsigned long long counts[64], count, cumulative = 0;
+	int exponent, first = 64, last = 0, a;
+
+	memset(counts, 0, sizeof(counts));
+	// 8 buckets for each power of 2 of nanoseconds (and one for each value below 8 ns)
+	for(a=0; a<UDP_LATENCY_BUCKETS; a++){
+		exponent = (a<2)?0:((a<8)?63-__builtin_clzll(a):a/8+2);
+		counts[exponent] += latency->counts[a];
+	}
+	for(a=0; a<64; a++){
+		if(counts[a]>0){
+			first = (a<first)?a:first;
+			last = a;
+		}
+	}
+	for(a=first; a<=last; a++){
+		count = counts[a];
+		cumulative += count;
+		printf("  %10.3f - %-10.3f us %12llu %6.2f%% %8.3f%% ", (a==0)?0:(1ULL<<a)/1000.0, (2ULL<<a)/1000.0, count, 100.0*count/latency->count, 100.0*cumulative/latency->count);
+		for(exponent=0; exponent<(int)(50.0*count/latency->count+0.5); exponent++){
+			putchar('#');
+		}
+		putchar('\n');
+	}
+}
+
+/**
+ * @brief Main function
+ * @param argc number of arguments
+ * @param argv arguments (ip and port of the server, number of clients, duration, number of threads, protocol and rate)
+ * @return integer with the exit code
+ */
+int main(int argc, char *argv[]){
+	struct sockaddr_in server;
+	struct rlimit limit;
+	LOAD_THREAD_T *threads;
+	UDP_LATENCY_T latency;
+	double start, elapsed, rate;
+	long sent = 0, completed = 0, lost = 0, invalid = 0, mismatched = 0, refused = 0, delayed = 0, position = 0;
+	int clients, seconds, number_of_threads, protocol = LOAD_TEXT, a, failed = FALSE;
+
+	if(argc>6){
+		for(protocol=0; protocol<=LOAD_BATCH && strcmp(argv[6], protocols[protocol])!=0; protocol++);
+	}
+	if(argc<3 || protocol>LOAD_BATCH){
+		fprintf(stderr, "Usage: %s <ip> <port> [clients] [seconds] [threads] [text|binary|results|batch] [requests per second]\n", argv[0]);
+		return M_INVALID_PARAMETERS;
+	}
+	clients = (argc>3)?atoi(argv[3]):UDP_LOAD_CLIENTS;
+	seconds = (argc>4)?atoi(argv[4]):UDP_LOAD_SECONDS;
+	number_of_threads = (argc>5)?atoi(argv[5]):UDP_LOAD_THREADS;
+	rate = (argc>7)?atof(argv[7]):0;
+	if(clients<=0 || seconds<=0 || number_of_threads<=0 || rate<0){
+		fprintf(stderr, "Usage: %s <ip> <port> [clients] [seconds] [threads] [text|binary|results|batch] [requests per second]\n", argv[0]);
+		return M_INVALID_PARAMETERS;
+	}
+	if(number_of_threads>clients){
+		number_of_threads = clients;
+	}
+
+	memset(&server, 0, sizeof(server));
+	server.sin_family = AF_INET;
+	server.sin_port = htons(atoi(argv[2]));
+	if(inet_pton(AF_INET, argv[1], &(server.sin_addr))!=1){
+		fprintf(stderr, "The IP address '%s' is not valid\n", argv[1]);
+		return M_INVALID_IP_ADDRESS;
+	}
+	// A socket for each client: the limit of open files is raised up to the one allowed
+	if(getrlimit(RLIMIT_NOFILE, &limit)==0 && limit.rlim_cur<(rlim_t)clients+64){
+		limit.rlim_cur = (limit.rlim_max==RLIM_INFINITY || limit.rlim_max>(rlim_t)clients+64)?(rlim_t)clients+64:limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	if((threads = calloc(number_of_threads, sizeof(LOAD_THREAD_T)))==NULL){
+		fprintf(stderr, "Error in memory allocation\n");
+		return M_FAILED_MEMORY_ALLOCATION;
+	}
+	start = now_us();
+	for(a=0; a<number_of_threads; a++){
+		threads[a].server = &server;
+		threads[a].protocol = protocol;
+		// The clients are spread by the threads
+		threads[a].first = position;
+		threads[a].clients = clients/number_of_threads+((a<clients%number_of_threads)?1:0);
+		position += threads[a].clients;
+		threads[a].start = start;
+		threads[a].end = start+seconds*1000000.0;
+		threads[a].interval = (rate>0)?clients*1000000.0/rate:0;
+		if(pthread_create(&(threads[a].thread), NULL, load_thread, &(threads[a]))!=0){
+			fprintf(stderr, "Failed to create the thread %d\n", a);
+			return M_PTHREAD_CREATE_FAILED;
+		}
+	}
+	memset(&latency, 0, sizeof(latency));
+	for(a=0; a<number_of_threads; a++){
+		pthread_join(threads[a].thread, NULL);
+		sent += threads[a].sent;
+		completed += threads[a].completed;
+		lost += threads[a].lost;
+		invalid += threads[a].invalid;
+		mismatched += threads[a].mismatched;
+		refused += threads[a].refused;
+		delayed += threads[a].delayed;
+		failed |= threads[a].failed;
+		udp_latency_merge(&latency, &(threads[a].latency));
+	}
+	elapsed = (now_us()-start)/1000000;
+
+	printf("requests:      %ld sent, %ld answered, %ld lost (%.3f%%), %ld invalid, %ld mismatched (%d clients on %d threads, %s protocol)\n", sent, completed, lost, (sent>0)?100.0*lost/sent:0, invalid, mismatched, clients, number_of_threads, protocols[protocol]);
+	if(protocol==LOAD_RESULTS || protocol==LOAD_BATCH){
+		printf("results:       %ld sent, %ld refused by the server\n", sent*((protocol==LOAD_BATCH)?UDP_LOAD_BATCH_RESULTS:1), refused);
+	}
+	printf("time:          %.3f s\n", elapsed);
+	if(rate>0){
+		printf("rate:          %.0f requests/s wanted, %.0f requests/s sent, %ld requests delayed\n", rate, (elapsed>0)?sent/elapsed:0, delayed);
+	}
+	printf("throughput:    %.0f requests/s\n", (elapsed>0)?completed/elapsed:0);
+	if(latency.count>0){
+		printf("latency (us):  p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n", udp_latency_percentile(&latency, 0.50)/1000.0, udp_latency_percentile(&latency, 0.90)/1000.0, udp_latency_percentile(&latency, 0.99)/1000.0, udp_latency_percentile(&latency, 0.999)/1000.0, latency.maximum/1000.0);
+		print_histogram(&latency);
+	}
+
+	free(threads);
+
+	return (failed || completed==0)?M_PROCESSING_FAILED:0;
+}